@@ -0,0 +1,439 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <optional>
+#include <string>
+#include <vector>
+#include <functional>
+#include <regex>
+#include <array>
+#include <cstdio>
+
+#include "mnxdom.h"
+#include "mnxvalidate.h"
+#include "schemavalidator.h"
+#include "semanticrules.h"
+#include "compression.h"
+#include "globpattern.h"
+#include "corpusgenerator.h"
+#include "utils/stringutils.h"
+#include "utils/filebuffer.h"
+#include "utils/memoryutils.h"
+
+using namespace mnxvalidate;
+using Clock = std::chrono::steady_clock;
+
+// Runs the callback the given number of times and returns the average time per call in microseconds.
+static double timePerCall(size_t iterations, const std::function<void()>& callback)
+{
+    const auto start = Clock::now();
+    for (size_t x = 0; x < iterations; x++) {
+        callback();
+    }
+    const std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+    return elapsed.count() / static_cast<double>(iterations);
+}
+
+static void printResult(const std::string& name, double microseconds, const char* unit = "us/file")
+{
+    std::cout << "  " << std::left << std::setw(44) << name << std::right << std::setw(12) << std::fixed << std::setprecision(1)
+              << microseconds << " " << unit << std::endl;
+}
+
+// Runs the callback until at least kMinBenchTime has passed (after one warm-up call), or exactly
+// the given number of times if it is not zero. Returns the iteration count and the time per call.
+static std::pair<size_t, double> measure(size_t iterations, const std::function<void()>& callback)
+{
+    if (iterations) {
+        return { iterations, timePerCall(iterations, callback) };
+    }
+    constexpr auto kMinBenchTime = std::chrono::milliseconds(250);
+    callback();
+    const auto start = Clock::now();
+    do {
+        callback();
+        iterations++;
+    } while (Clock::now() - start < kMinBenchTime);
+    const std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+    return { iterations, elapsed.count() / static_cast<double>(iterations) };
+}
+
+struct BenchResult
+{
+    std::string benchmark;
+    std::string input;
+    std::uintmax_t bytes{};
+    size_t iterations{};
+    double microseconds{};
+};
+
+static void addResult(std::vector<BenchResult>& results, const std::string& benchmark, const std::filesystem::path& input,
+    std::uintmax_t bytes, std::pair<size_t, double> measurement, const char* unit = "us/file")
+{
+    results.push_back({ benchmark, utils::pathToString(input.filename()), bytes, measurement.first, measurement.second });
+    printResult(benchmark, measurement.second, unit);
+}
+
+// Times each validation phase on its own for one input. Phases that throw on the input are skipped.
+// @p validator is the generic validator and @p generatedValidator the one generated from the embedded schema.
+static void benchPhases(const std::filesystem::path& inputPath, const SchemaValidator& validator, const SchemaValidator& generatedValidator,
+                        size_t iterations, std::vector<BenchResult>& results)
+{
+    const auto bytes = std::filesystem::file_size(inputPath);
+    std::cout << "phases: " << utils::pathToString(inputPath.filename()) << " (" << bytes << " bytes)" << std::endl;
+    try {
+        addResult(results, "create", inputPath, bytes, measure(iterations, [&]() {
+            [[maybe_unused]] auto doc = mnx::Document::create(inputPath);
+        }));
+        const auto doc = mnx::Document::create(inputPath);
+        addResult(results, "schemaValidate", inputPath, bytes, measure(iterations, [&]() {
+            [[maybe_unused]] auto result = mnx::validation::schemaValidate(doc);
+        }));
+        addResult(results, "schemaValidate (compiled once)", inputPath, bytes, measure(iterations, [&]() {
+            [[maybe_unused]] auto result = validator.validate(doc);
+        }));
+        if (generatedValidator.usesGeneratedCode()) {
+            addResult(results, "schemaValidate (generated)", inputPath, bytes, measure(iterations, [&]() {
+                [[maybe_unused]] auto result = generatedValidator.validate(doc);
+            }));
+        }
+        if (validator.canStream()) {
+            const std::string text = utils::fileToString(inputPath);
+            addResult(results, "parse + schemaValidate (streaming)", inputPath, bytes, measure(iterations, [&]() {
+                [[maybe_unused]] auto result = validator.validateText(text);
+            }));
+        }
+        addResult(results, "semanticValidate", inputPath, bytes, measure(iterations, [&]() {
+            [[maybe_unused]] auto result = mnx::validation::semanticValidate(doc);
+        }));
+        for (const auto rule : kSemanticRules) {
+            auto root = std::make_shared<mnx::json>(*doc.root());
+            removeSkippedRuleContent(*root, SemanticRuleSet{}.set(static_cast<size_t>(rule)));
+            const mnx::Document skippedDoc(root);
+            addResult(results, "semanticValidate (skip " + std::string(semanticRuleName(rule)) + ")", inputPath, bytes, measure(iterations, [&]() {
+                [[maybe_unused]] auto result = mnx::validation::semanticValidate(skippedDoc);
+            }));
+        }
+    } catch (const std::exception& e) {
+        std::cout << "  (skipped: " << e.what() << ")" << std::endl;
+    }
+}
+
+// Times complete runs of the program over a directory, serially and with the default number of jobs.
+static void benchEndToEnd(const std::filesystem::path& inputDir, size_t iterations, std::vector<BenchResult>& results)
+{
+    std::uintmax_t bytes = 0;
+    size_t fileCount = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(inputDir)) {
+        if (entry.is_regular_file()) {
+            bytes += entry.file_size();
+            fileCount++;
+        }
+    }
+    std::cout << "end to end: " << fileCount << " files (" << bytes << " bytes)" << std::endl;
+    for (const char* jobs : { "1", "0" }) {
+        std::vector<arg_string> args = { "mnxvalidate", utils::pathToString(inputDir), "--no-log" };
+        if (std::string_view(jobs) != "0") {
+            args.insert(args.end(), { "--jobs", jobs });
+        }
+        std::vector<arg_char*> argv;
+        for (auto& arg : args) {
+            argv.push_back(arg.data());
+        }
+        std::ostringstream discarded;
+        std::streambuf* originalCerr = std::cerr.rdbuf(discarded.rdbuf());
+        const auto measurement = measure(iterations, [&]() {
+            mnxValidateTestMain(static_cast<int>(argv.size()), argv.data());
+            discarded.str({});
+        });
+        std::cerr.rdbuf(originalCerr);
+        addResult(results, std::string("mnxValidateTestMain --jobs ") + (std::string_view(jobs) == "0" ? "default" : jobs),
+            inputDir, bytes, measurement, "us/run");
+    }
+}
+
+static void writeJsonResults(const std::filesystem::path& jsonPath, const std::vector<BenchResult>& results)
+{
+    mnx::json output;
+    output["version"] = MNXVALIDATE_VERSION;
+    output["results"] = mnx::json::array();
+    for (const auto& result : results) {
+        output["results"].push_back({ { "benchmark", result.benchmark }, { "input", result.input }, { "bytes", result.bytes },
+            { "iterations", result.iterations }, { "usPerCall", result.microseconds } });
+    }
+    std::ofstream file;
+    file.exceptions(std::ios::failbit | std::ios::badbit);
+    file.open(jsonPath, std::ios::trunc);
+    file << output.dump(2) << std::endl;
+    std::cout << "results written to " << utils::pathToString(jsonPath) << std::endl;
+}
+
+// Benchmarks every phase on the test inputs and on synthetic scores of increasing size, then
+// benchmarks complete runs over a directory holding all of them.
+static void benchAll(const std::optional<std::filesystem::path>& jsonPath, size_t iterations)
+{
+    const auto workDir = std::filesystem::temp_directory_path() / "mnxvalidate_bench";
+    std::filesystem::remove_all(workDir);
+    std::filesystem::create_directories(workDir);
+    for (const auto& entry : std::filesystem::directory_iterator(MNXVALIDATE_BENCH_DATA_DIR)) {
+        if (entry.is_regular_file()) {
+            std::filesystem::copy_file(entry.path(), workDir / entry.path().filename());
+        }
+    }
+    for (size_t measureCount : { 16, 256, 2048 }) {
+        CorpusOptions options;
+        options.parts = 4;
+        options.measures = measureCount;
+        std::ostringstream fileName;
+        fileName << "synthetic_" << std::setw(5) << std::setfill('0') << measureCount << "m.mnx"; // sorts by size
+        std::ofstream file(workDir / fileName.str(), std::ios::binary);
+        CorpusGenerator(options, 1).writeScore(file, 0);
+    }
+
+    std::vector<BenchResult> results;
+    const SchemaValidator generatedValidator;
+    const SchemaValidator validator(generatedValidator.schemaText()); // supplying the text selects the generic validator
+    std::vector<std::filesystem::path> inputs;
+    for (const auto& entry : std::filesystem::directory_iterator(workDir)) {
+        inputs.push_back(entry.path());
+    }
+    std::sort(inputs.begin(), inputs.end());
+    for (const auto& input : inputs) {
+        benchPhases(input, validator, generatedValidator, iterations, results);
+    }
+    benchEndToEnd(workDir, iterations, results);
+    if (jsonPath) {
+        writeJsonResults(jsonPath.value(), results);
+    }
+    std::filesystem::remove_all(workDir);
+}
+
+// Compares the schema validation cost per file of rebuilding the validator for every document
+// against compiling the schema once. A small input file makes schema setup the dominant cost.
+static void benchSchemaCompilation(const std::filesystem::path& inputPath, size_t iterations)
+{
+    std::cout << "schema validation: " << utils::pathToString(inputPath.filename()) << " x " << iterations << std::endl;
+    const auto doc = mnx::Document::create(inputPath);
+
+    const double perFileSchema = timePerCall(iterations, [&]() {
+        [[maybe_unused]] auto result = mnx::validation::schemaValidate(doc);
+    });
+    printResult("schema compiled per file", perFileSchema);
+
+    const SchemaValidator generatedValidator;
+    std::unique_ptr<SchemaValidator> validator;
+    const double compileTime = timePerCall(1, [&]() {
+        validator = std::make_unique<SchemaValidator>(generatedValidator.schemaText());
+    });
+    const double compiledOnce = timePerCall(iterations, [&]() {
+        [[maybe_unused]] auto result = validator->validate(doc);
+    });
+    printResult("schema compiled once", compiledOnce);
+    printResult("(one-time compile)", compileTime);
+    std::cout << "  speedup: " << std::setprecision(2) << perFileSchema / compiledOnce << "x" << std::endl;
+    if (generatedValidator.usesGeneratedCode()) {
+        const double generated = timePerCall(iterations, [&]() {
+            [[maybe_unused]] auto result = generatedValidator.validate(doc);
+        });
+        printResult("generated from the schema", generated);
+        std::cout << "  speedup: " << std::setprecision(2) << compiledOnce / generated << "x over compiled once" << std::endl;
+    }
+}
+
+// Times reading and parsing a file through a mapped or a buffered FileBuffer. Peak RSS is per process,
+// so compare the two modes by running each in its own process.
+static void benchInput(const std::filesystem::path& inputPath, bool mapped, size_t iterations)
+{
+    std::cout << "input (" << (mapped ? "mapped" : "buffered") << "): " << utils::pathToString(inputPath.filename()) << " ("
+              << std::filesystem::file_size(inputPath) << " bytes) x " << iterations << std::endl;
+    bool wasMapped = false;
+    const double perFile = timePerCall(iterations, [&]() {
+        utils::FileBuffer buffer(inputPath, mapped);
+        wasMapped = buffer.isMapped();
+        [[maybe_unused]] auto root = std::make_shared<mnx::json>(mnx::json::parse(buffer.view().begin(), buffer.view().end()));
+    });
+    printResult(wasMapped ? "read + parse (mapped)" : "read + parse (buffered)", perFile);
+    std::cout << "  peak RSS: " << std::setprecision(1) << double(utils::peakResidentBytes()) / (1024 * 1024) << " MB" << std::endl;
+    if (mapped && !wasMapped) {
+        std::cout << "  (smaller than " << utils::FileBuffer::kMinMappedSize << " bytes, so it was read rather than mapped)" << std::endl;
+    }
+}
+
+// Compares complete runs of the program on a synthetic score written uncompressed, gzip-compressed and
+// zstd-compressed, so that the cost of decompressing while parsing can be set against the smaller read.
+static void benchCompressed(size_t measureCount, size_t iterations)
+{
+    const auto workDir = std::filesystem::temp_directory_path() / "mnxvalidate_bench_compressed";
+    std::filesystem::remove_all(workDir);
+    std::filesystem::create_directories(workDir);
+    CorpusOptions options;
+    options.parts = 4;
+    options.measures = measureCount;
+    std::ostringstream score;
+    CorpusGenerator(options, 1).writeScore(score, 0);
+    std::cout << "compressed input: synthetic score with " << measureCount << " measures (" << score.view().size() << " bytes)" << std::endl;
+    std::optional<double> uncompressedTime;
+    for (Compression compression : { Compression::None, Compression::Gzip, Compression::Zstd }) {
+        const std::string name = compression == Compression::None ? "uncompressed" : std::string(compressionExtension(compression).substr(1));
+        if (compression != Compression::None && !isCompressionSupported(compression)) {
+            std::cout << "  (" << name << " skipped: not supported by this build)" << std::endl;
+            continue;
+        }
+        const auto inputPath = workDir / ("score.mnx" + std::string(compressionExtension(compression)));
+        {
+            std::ofstream file(inputPath, std::ios::binary | std::ios::trunc);
+            file << compress(score.view(), compression);
+        }
+        std::vector<arg_string> args = { "mnxvalidate", utils::pathToString(inputPath), "--no-log", "--jobs", "1" };
+        std::vector<arg_char*> argv;
+        for (auto& arg : args) {
+            argv.push_back(arg.data());
+        }
+        std::ostringstream discarded;
+        std::streambuf* originalCerr = std::cerr.rdbuf(discarded.rdbuf());
+        const auto measurement = measure(iterations, [&]() {
+            mnxValidateTestMain(static_cast<int>(argv.size()), argv.data());
+            discarded.str({});
+        });
+        std::cerr.rdbuf(originalCerr);
+        printResult("mnxValidateTestMain (" + name + ", " + std::to_string(std::filesystem::file_size(inputPath)) + " bytes)",
+            measurement.second, "us/run");
+        if (!uncompressedTime) {
+            uncompressedTime = measurement.second;
+        } else {
+            std::cout << "  relative to uncompressed: " << std::setprecision(2) << measurement.second / uncompressedTime.value() << "x" << std::endl;
+        }
+    }
+    std::filesystem::remove_all(workDir);
+}
+
+// Compares the compiled glob matcher with the std::regex conversion it replaced, on file names alone
+// because that is all the regex could match.
+static void benchGlob(size_t nameCount)
+{
+    std::vector<GlobPattern::String> names;
+    names.reserve(nameCount);
+    for (size_t x = 0; x < nameCount; x++) {
+        static constexpr std::array<const char*, 4> kFormats = { "score%06zu.mnx", "part%06zu.json", "notes%06zu.txt", "Score %06zu (draft).mnx" };
+        std::array<char, 64> name{};
+        std::snprintf(name.data(), name.size(), kFormats[x % kFormats.size()], x);
+        names.push_back(std::filesystem::path(name.data()).native());
+    }
+    std::cout << "glob matching: " << nameCount << " file names" << std::endl;
+    for (const char* pattern : { "*.mnx", "score*.mnx", "*[0-4]?.{mnx,json}" }) {
+        const auto wildcardPattern = std::filesystem::path(pattern).native();
+        size_t regexMatches = 0;
+        double regexTime = 0;
+        // the conversion that processInputPathArg used, which only understood * and ?
+        if (std::string_view(pattern).find_first_of("[{") == std::string_view::npos) {
+#ifdef _WIN32
+            auto regexPattern = std::regex_replace(wildcardPattern, std::wregex(LR"(\*)"), L".*");
+            regexPattern = std::regex_replace(regexPattern, std::wregex(LR"(\?)"), L".");
+            const std::wregex regex(regexPattern);
+#else
+            auto regexPattern = std::regex_replace(wildcardPattern, std::regex(R"(\*)"), R"(.*)");
+            regexPattern = std::regex_replace(regexPattern, std::regex(R"(\?)"), R"(.)");
+            const std::regex regex(regexPattern);
+#endif
+            regexTime = timePerCall(1, [&]() {
+                for (const auto& name : names) {
+                    regexMatches += std::regex_match(name, regex);
+                }
+            });
+        }
+        const GlobPattern glob(wildcardPattern);
+        size_t globMatches = 0;
+        const double globTime = timePerCall(1, [&]() {
+            for (const auto& name : names) {
+                globMatches += glob.matches(name);
+            }
+        });
+        std::cout << "  " << pattern << ": " << globMatches << " matches" << std::endl;
+        if (regexTime > 0) {
+            printResult("  std::regex", regexTime * 1000.0 / double(nameCount), "ns/name");
+        }
+        printResult("  GlobPattern", globTime * 1000.0 / double(nameCount), "ns/name");
+        if (regexTime > 0 && regexMatches != globMatches) {
+            std::cout << "    (std::regex found " << regexMatches << ")" << std::endl;
+        }
+    }
+}
+
+static int showUsage(const char* programPath)
+{
+    const std::string programName = std::filesystem::path(programPath).filename().string();
+    std::cerr << "Usage: " << programName << " [all] [--json <output-file>] [--iterations <count>]" << std::endl;
+    std::cerr << "       " << programName << " schema [input-file] [iterations]" << std::endl;
+    std::cerr << "       " << programName << " input <mapped|buffered> <input-file> [iterations]" << std::endl;
+    std::cerr << "       " << programName << " glob [name-count]" << std::endl;
+    std::cerr << "       " << programName << " compressed [measures] [iterations]" << std::endl;
+    return 1;
+}
+
+int main(int argc, char* argv[])
+{
+    const bool hasCommand = argc > 1 && std::string_view(argv[1]).rfind("--", 0) != 0;
+    const std::string command = hasCommand ? argv[1] : "all";
+    try {
+        if (command == "all") {
+            std::optional<std::filesystem::path> jsonPath;
+            size_t iterations = 0;
+            for (int x = hasCommand ? 2 : 1; x < argc; x++) {
+                const std::string_view option = argv[x];
+                if (option == "--json" && x + 1 < argc) {
+                    jsonPath = argv[++x];
+                } else if (option == "--iterations" && x + 1 < argc) {
+                    iterations = std::stoul(argv[++x]);
+                } else {
+                    return showUsage(argv[0]);
+                }
+            }
+            benchAll(jsonPath, iterations);
+        } else if (command == "schema" && argc <= 4) {
+            const std::filesystem::path inputPath = argc > 2 ? std::filesystem::path(argv[2]) : std::filesystem::path(MNXVALIDATE_BENCH_DATA_DIR) / "valid.mnx";
+            const size_t iterations = argc > 3 ? std::stoul(argv[3]) : 1000;
+            benchSchemaCompilation(inputPath, std::max<size_t>(iterations, 1));
+        } else if (command == "input" && argc >= 4 && argc <= 5 && (std::string_view(argv[2]) == "mapped" || std::string_view(argv[2]) == "buffered")) {
+            const size_t iterations = argc > 4 ? std::stoul(argv[4]) : 10;
+            benchInput(argv[3], std::string_view(argv[2]) == "mapped", std::max<size_t>(iterations, 1));
+        } else if (command == "glob" && argc <= 3) {
+            const size_t nameCount = argc > 2 ? std::stoul(argv[2]) : 1000000;
+            benchGlob(std::max<size_t>(nameCount, 1));
+        } else if (command == "compressed" && argc <= 4) {
+            const size_t measureCount = argc > 2 ? std::stoul(argv[2]) : 4096;
+            const size_t iterations = argc > 3 ? std::stoul(argv[3]) : 0;
+            benchCompressed(std::max<size_t>(measureCount, 1), iterations);
+        } else {
+            return showUsage(argv[0]);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
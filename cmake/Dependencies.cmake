@@ -6,3 +6,7 @@ set(MNXDOM_GIT_TAG_OR_BRANCH "1d9822f8fc5ee568c14f1c699d4f10565908dc6b" CACHE ST
 
 # For release (point to tag or commit hash):
 # set(MNXDOM_GIT_TAG_OR_BRANCH "7e1951c560d2914c49a4cab61f519fbff2f7a405" CACHE STRING "")
+
+# Used only when the system does not provide them:
+set(ZLIB_GIT_TAG "v1.3.1" CACHE STRING "")
+set(ZSTD_GIT_TAG "v1.5.6" CACHE STRING "")
@@ -0,0 +1,434 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <utility>
+
+#include "archivereader.h"
+#include "compression.h"
+#include "utils/filebuffer.h"
+#include "utils/stringutils.h"
+
+namespace mnxvalidate {
+
+namespace {
+
+constexpr char8_t ZIP_EXTENSION[]                = u8"zip";
+constexpr char8_t TAR_EXTENSION[]                = u8"tar";
+constexpr char8_t TGZ_EXTENSION[]                = u8"tgz";
+constexpr char8_t TZST_EXTENSION[]               = u8"tzst";
+
+constexpr std::uint32_t kZipLocalHeader          = 0x04034b50;
+constexpr std::uint32_t kZipCentralHeader        = 0x02014b50;
+constexpr std::uint32_t kZipEndOfDirectory       = 0x06054b50;
+constexpr std::uint32_t kZip64EndOfDirectory     = 0x06064b50;
+constexpr std::uint32_t kZip64Locator            = 0x07064b50;
+constexpr std::uint16_t kZip64ExtraField         = 0x0001;
+constexpr std::uint16_t kZipMethodStored         = 0;
+constexpr std::uint16_t kZipMethodDeflated       = 8;
+constexpr std::uint16_t kZipMethodZstd           = 93;
+constexpr size_t kTarBlockSize                   = 512;
+
+template <typename T>
+T readLittleEndian(std::string_view data, size_t offset)
+{
+    if (offset > data.size() || data.size() - offset < sizeof(T)) {
+        throw std::out_of_range("zip record extends past the end of the archive");
+    }
+    T result{};
+    for (size_t x = 0; x < sizeof(T); x++) {
+        result |= T(static_cast<unsigned char>(data[offset + x])) << (8 * x);
+    }
+    return result;
+}
+
+void appendLittleEndian(std::string& output, std::uint32_t value)
+{
+    for (size_t x = 0; x < 4; x++) {
+        output.push_back(static_cast<char>((value >> (8 * x)) & 0xff));
+    }
+}
+
+// zip tools and tar both write names like "./scores/a.mnx"; patterns are matched against "scores/a.mnx"
+std::string normalizeEntryName(std::string_view name)
+{
+    while (true) {
+        if (name.starts_with("./")) {
+            name.remove_prefix(2);
+        } else if (name.starts_with("/")) {
+            name.remove_prefix(1);
+        } else {
+            return std::string(name);
+        }
+    }
+}
+
+// A tar header field is nul-terminated unless it fills the field
+std::string_view tarString(std::string_view header, size_t offset, size_t length)
+{
+    const auto field = header.substr(offset, length);
+    return field.substr(0, std::min(field.find('\0'), field.size()));
+}
+
+// Numeric fields are octal, or base-256 with the high bit set for values that do not fit
+std::uint64_t tarNumber(std::string_view header, size_t offset, size_t length)
+{
+    const auto field = header.substr(offset, length);
+    std::uint64_t result = 0;
+    if (!field.empty() && (static_cast<unsigned char>(field[0]) & 0x80)) {
+        result = static_cast<unsigned char>(field[0]) & 0x7f;
+        for (char c : field.substr(1)) {
+            result = (result << 8) | static_cast<unsigned char>(c);
+        }
+        return result;
+    }
+    for (char c : field) {
+        if (c >= '0' && c <= '7') {
+            result = result * 8 + static_cast<std::uint64_t>(c - '0');
+        } else if (c != ' ' && c != '\0') {
+            throw std::invalid_argument("invalid tar header");
+        } else if (result) {
+            break;
+        }
+    }
+    return result;
+}
+
+bool isValidTarHeader(std::string_view header)
+{
+    std::uint64_t sum = 0;
+    for (size_t x = 0; x < header.size(); x++) {
+        sum += (x >= 148 && x < 156) ? ' ' : static_cast<unsigned char>(header[x]); // the checksum field counts as spaces
+    }
+    try {
+        return sum == tarNumber(header, 148, 8);
+    } catch (const std::invalid_argument&) {
+        return false;
+    }
+}
+
+// The value of the last "path" record in a pax extended header. Records are "<length> <key>=<value>\n".
+std::optional<std::string> paxPath(std::string_view records)
+{
+    std::optional<std::string> result;
+    while (!records.empty()) {
+        const size_t space = records.find(' ');
+        size_t length = 0;
+        for (char c : records.substr(0, space)) {
+            length = (c >= '0' && c <= '9') ? length * 10 + static_cast<size_t>(c - '0') : 0;
+        }
+        if (space == std::string_view::npos || length <= space + 1 || length > records.size()) {
+            break;
+        }
+        const auto record = records.substr(space + 1, length - space - 2); // without the newline
+        if (record.starts_with("path=")) {
+            result = std::string(record.substr(5));
+        }
+        records.remove_prefix(length);
+    }
+    return result;
+}
+
+} // namespace
+
+/// @brief The archive's bytes, read sequentially for tar and at random for zip
+class ArchiveReader::Source
+{
+public:
+    Source(const std::filesystem::path& path, bool allowMapping)
+        : m_file(path, allowMapping), m_unread(m_file.view()) {}
+
+    std::string_view data() const { return m_file.view(); }
+
+    void startDecompressing(Compression compression)
+    {
+        m_decompressor.emplace(m_file.view(), compression);
+        m_unread = {};
+    }
+
+    /// @brief Appends the next @p size bytes to @p output, or skips them if it is null. Returns false if the archive ended first.
+    bool read(std::uint64_t size, std::string* output)
+    {
+        while (size > 0) {
+            if (m_unread.empty()) {
+                if (!m_decompressor) {
+                    return false;
+                }
+                m_unread = m_decompressor->next();
+                if (m_unread.empty()) {
+                    return false;
+                }
+            }
+            const size_t count = static_cast<size_t>(std::min<std::uint64_t>(size, m_unread.size()));
+            if (output) {
+                output->append(m_unread.data(), count);
+            }
+            m_unread.remove_prefix(count);
+            size -= count;
+        }
+        return true;
+    }
+
+private:
+    utils::FileBuffer m_file;
+    std::optional<Decompressor> m_decompressor;
+    std::string_view m_unread;      ///< the rest of the file, or of the current decompressed chunk
+};
+
+ArchiveReader::ArchiveReader(const std::filesystem::path& archivePath, bool allowMapping)
+    : m_archiveName(utils::pathToString(archivePath)), m_source(std::make_unique<Source>(archivePath, allowMapping))
+{
+    const auto data = m_source->data();
+    const auto fail = [&](const std::string& reason) {
+        return std::runtime_error("Unable to read archive " + m_archiveName + ": " + reason);
+    };
+    if (data.starts_with("PK\x03\x04") || data.starts_with("PK\x05\x06")) {
+        m_isZip = true;
+        try {
+            // The end of central directory record is last, followed only by a comment of up to 64KiB.
+            constexpr size_t kEndRecordSize = 22;
+            if (data.size() < kEndRecordSize) {
+                throw fail("the zip archive is truncated");
+            }
+            size_t endOffset = data.size() - kEndRecordSize;
+            const size_t searchStart = endOffset > 0xffff ? endOffset - 0xffff : 0;
+            while (readLittleEndian<std::uint32_t>(data, endOffset) != kZipEndOfDirectory) {
+                if (endOffset == searchStart) {
+                    throw fail("the zip central directory was not found");
+                }
+                endOffset--;
+            }
+            m_zipEntriesLeft = readLittleEndian<std::uint16_t>(data, endOffset + 10);
+            std::uint64_t directoryOffset = readLittleEndian<std::uint32_t>(data, endOffset + 16);
+            if ((m_zipEntriesLeft == 0xffff || directoryOffset == 0xffffffff) && endOffset >= 20
+                && readLittleEndian<std::uint32_t>(data, endOffset - 20) == kZip64Locator) {
+                const auto zip64Offset = readLittleEndian<std::uint64_t>(data, endOffset - 20 + 8);
+                if (zip64Offset > data.size() || readLittleEndian<std::uint32_t>(data, static_cast<size_t>(zip64Offset)) != kZip64EndOfDirectory) {
+                    throw fail("the zip64 end of central directory record is corrupt");
+                }
+                m_zipEntriesLeft = readLittleEndian<std::uint64_t>(data, static_cast<size_t>(zip64Offset) + 32);
+                directoryOffset = readLittleEndian<std::uint64_t>(data, static_cast<size_t>(zip64Offset) + 48);
+            }
+            if (directoryOffset > data.size()) {
+                throw fail("the zip central directory is outside the archive");
+            }
+            m_zipDirectoryOffset = static_cast<size_t>(directoryOffset);
+        } catch (const std::out_of_range& e) {
+            throw fail(e.what());
+        }
+        return;
+    }
+    const Compression compression = detectCompression(data);
+    if (compression != Compression::None) {
+        m_source->startDecompressing(compression);
+    }
+    // the first header shows whether this is a tar archive at all
+    m_tarHeader.reserve(kTarBlockSize);
+    const bool isWholeBlock = m_source->read(kTarBlockSize, &m_tarHeader);
+    if (!m_tarHeader.empty() && (!isWholeBlock || (!isValidTarHeader(m_tarHeader) && m_tarHeader.find_first_not_of('\0') != std::string::npos))) {
+        throw fail("it is not a zip or tar archive");
+    }
+}
+
+ArchiveReader::~ArchiveReader() = default;
+
+void ArchiveReader::addError(std::string_view entry, const std::string& message)
+{
+    m_errors.push_back(utils::pathToString(entryPath(utils::utf8ToPath(m_archiveName), entry)) + ": " + message);
+}
+
+std::optional<ArchiveEntry> ArchiveReader::next(const Filter& filter)
+{
+    return m_isZip ? nextZipEntry(filter) : nextTarEntry(filter);
+}
+
+std::optional<ArchiveEntry> ArchiveReader::nextZipEntry(const Filter& filter)
+{
+    const auto data = m_source->data();
+    try {
+        for (; m_zipEntriesLeft > 0; m_zipEntriesLeft--) {
+            const size_t record = m_zipDirectoryOffset;
+            if (readLittleEndian<std::uint32_t>(data, record) != kZipCentralHeader) {
+                throw std::out_of_range("the zip central directory is corrupt");
+            }
+            const auto flags = readLittleEndian<std::uint16_t>(data, record + 8);
+            const auto method = readLittleEndian<std::uint16_t>(data, record + 10);
+            const auto crc = readLittleEndian<std::uint32_t>(data, record + 16);
+            std::uint64_t compressedSize = readLittleEndian<std::uint32_t>(data, record + 20);
+            std::uint64_t size = readLittleEndian<std::uint32_t>(data, record + 24);
+            const auto nameLength = readLittleEndian<std::uint16_t>(data, record + 28);
+            const auto extraLength = readLittleEndian<std::uint16_t>(data, record + 30);
+            const auto commentLength = readLittleEndian<std::uint16_t>(data, record + 32);
+            std::uint64_t localOffset = readLittleEndian<std::uint32_t>(data, record + 42);
+            if (data.size() - record < size_t(46) + nameLength + extraLength) {
+                throw std::out_of_range("the zip central directory is corrupt");
+            }
+            const std::string name = normalizeEntryName(data.substr(record + 46, nameLength));
+            auto extra = data.substr(record + 46 + nameLength, extraLength);
+            m_zipDirectoryOffset = record + 46 + nameLength + extraLength + commentLength;
+            m_entryCount++;
+            if (name.empty() || name.back() == '/' || !filter(name)) {
+                continue; // directories end with a slash
+            }
+            // zip64 sizes and offsets replace the 32-bit fields that are all ones, in this order
+            while (extra.size() >= 4) {
+                const auto id = readLittleEndian<std::uint16_t>(extra, 0);
+                const auto length = readLittleEndian<std::uint16_t>(extra, 2);
+                if (id == kZip64ExtraField) {
+                    size_t offset = 4;
+                    for (std::uint64_t* field : { &size, &compressedSize, &localOffset }) {
+                        if (*field == 0xffffffff && offset + 8 <= size_t(4) + length) {
+                            *field = readLittleEndian<std::uint64_t>(extra, offset);
+                            offset += 8;
+                        }
+                    }
+                }
+                extra.remove_prefix(std::min<size_t>(extra.size(), size_t(4) + length));
+            }
+            if (flags & 0x1) {
+                addError(name, "encrypted entries are not supported");
+                continue;
+            }
+            if (method != kZipMethodStored && method != kZipMethodDeflated && method != kZipMethodZstd) {
+                addError(name, "compression method " + std::to_string(method) + " is not supported");
+                continue;
+            }
+            if (localOffset > data.size() || readLittleEndian<std::uint32_t>(data, static_cast<size_t>(localOffset)) != kZipLocalHeader) {
+                addError(name, "the local header is missing");
+                continue;
+            }
+            const std::uint64_t dataOffset = localOffset + 30 + readLittleEndian<std::uint16_t>(data, static_cast<size_t>(localOffset) + 26)
+                                           + readLittleEndian<std::uint16_t>(data, static_cast<size_t>(localOffset) + 28);
+            if (dataOffset > data.size() || data.size() - dataOffset < compressedSize) {
+                addError(name, "the entry extends past the end of the archive");
+                continue;
+            }
+            const auto payload = data.substr(static_cast<size_t>(dataOffset), static_cast<size_t>(compressedSize));
+            ArchiveEntry entry{ name, {} };
+            if (method == kZipMethodDeflated) {
+                // A deflated entry is a gzip member without the gzip header and trailer, so adding them lets
+                // the validator inflate it as it parses, checking the crc as it goes.
+                static constexpr char kGzipHeader[] = { '\x1f', '\x8b', '\x08', 0, 0, 0, 0, 0, 0, '\xff' };
+                entry.contents.reserve(sizeof(kGzipHeader) + payload.size() + 8);
+                entry.contents.append(kGzipHeader, sizeof(kGzipHeader));
+                entry.contents.append(payload);
+                appendLittleEndian(entry.contents, crc);
+                appendLittleEndian(entry.contents, static_cast<std::uint32_t>(size));
+            } else {
+                entry.contents.assign(payload); // stored, or a zstd frame
+            }
+            m_zipEntriesLeft--;
+            return entry;
+        }
+    } catch (const std::out_of_range& e) {
+        m_zipEntriesLeft = 0;
+        throw std::runtime_error("Unable to read archive " + m_archiveName + ": " + e.what());
+    }
+    return std::nullopt;
+}
+
+std::optional<ArchiveEntry> ArchiveReader::nextTarEntry(const Filter& filter)
+{
+    std::optional<std::string> longName; // from a GNU long name entry or a pax header, for the entry that follows
+    while (m_tarHeader.size() == kTarBlockSize || m_source->read(kTarBlockSize, &m_tarHeader)) {
+        const std::string header = std::exchange(m_tarHeader, {});
+        if (header.size() < kTarBlockSize || header.find_first_not_of('\0') == std::string::npos) {
+            break; // the end-of-archive blocks, or an archive without them
+        }
+        if (!isValidTarHeader(header)) {
+            throw std::runtime_error("Unable to read archive " + m_archiveName + ": a tar header is corrupt");
+        }
+        const std::uint64_t size = tarNumber(header, 124, 12);
+        const std::uint64_t padding = (kTarBlockSize - size % kTarBlockSize) % kTarBlockSize;
+        const char type = header[156];
+        std::string name;
+        if (longName) {
+            name = std::move(longName.value());
+            longName.reset();
+        } else {
+            name = std::string(tarString(header, 0, 100));
+            const auto prefix = tarString(header, 345, 155);
+            if (tarString(header, 257, 6).starts_with("ustar") && !prefix.empty()) {
+                name = std::string(prefix) + "/" + name;
+            }
+        }
+        name = normalizeEntryName(name);
+        const bool isMetadata = type == 'L' || type == 'x';
+        const bool isFile = type == '0' || type == '\0' || type == '7';
+        std::string contents;
+        if (!isMetadata) {
+            m_entryCount++;
+        }
+        const bool wanted = isMetadata || (isFile && !name.empty() && filter(name));
+        if (!m_source->read(size, wanted ? &contents : nullptr) || !m_source->read(padding, nullptr)) {
+            throw std::runtime_error("Unable to read archive " + m_archiveName + ": the tar archive is truncated");
+        }
+        if (type == 'L') {
+            longName = std::string(tarString(contents, 0, contents.size()));
+        } else if (type == 'x') {
+            longName = paxPath(contents);
+        } else if (wanted) {
+            return ArchiveEntry{ std::move(name), std::move(contents) };
+        }
+    }
+    return std::nullopt;
+}
+
+bool ArchiveReader::isArchivePath(const std::filesystem::path& path)
+{
+    if (utils::hasExtension(path, ZIP_EXTENSION) || utils::hasExtension(path, TAR_EXTENSION)
+        || utils::hasExtension(path, TGZ_EXTENSION) || utils::hasExtension(path, TZST_EXTENSION)) {
+        return true;
+    }
+    return compressionForPath(path) != Compression::None && utils::hasExtension(path.stem(), TAR_EXTENSION);
+}
+
+std::optional<ArchiveEntryPath> ArchiveReader::splitEntryPath(const std::filesystem::path& path)
+{
+    const std::string text = utils::pathToString(path);
+    for (size_t bang = text.find('!'); bang != std::string::npos; bang = text.find('!', bang + 1)) {
+        const bool separatorFollows = bang + 1 < text.size() && (text[bang + 1] == '/'
+#ifdef _WIN32
+            || text[bang + 1] == '\\'
+#endif
+        );
+        if (separatorFollows) {
+            const auto archive = utils::utf8ToPath(std::string_view(text).substr(0, bang));
+            if (isArchivePath(archive)) {
+                std::string entry = text.substr(bang + 2);
+#ifdef _WIN32
+                std::replace(entry.begin(), entry.end(), '\\', '/');
+#endif
+                return ArchiveEntryPath{ archive, std::move(entry) };
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+std::filesystem::path ArchiveReader::entryPath(const std::filesystem::path& archive, std::string_view entry)
+{
+    return utils::utf8ToPath(utils::pathToString(archive) + "!/" + std::string(entry));
+}
+
+} // namespace mnxvalidate
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <optional>
+#include <functional>
+#include <filesystem>
+#include <cstdint>
+
+namespace mnxvalidate {
+
+/// @brief A file inside an archive, ready to validate
+struct ArchiveEntry
+{
+    std::string name;           ///< the utf-8 encoded path inside the archive, with `/` separators
+    std::string contents;       ///< the entry's bytes. Compressed entries stay compressed, in a form #Validator decompresses as it parses.
+};
+
+/// @brief An archive entry named as an input: `archive.zip!/path/in/archive.mnx`
+struct ArchiveEntryPath
+{
+    std::filesystem::path archive;
+    std::string entry;          ///< the path inside the archive, without a leading `/`. It may be a wildcard pattern.
+};
+
+/**
+ * @brief Reads the files in a zip or tar archive one at a time, without extracting them.
+ *
+ * Zip archives are read through their central directory. Stored entries are copied and deflated entries
+ * are rewrapped as gzip members, which costs no decompression here: each entry is inflated as it is parsed,
+ * on whichever thread validates it. zstd-compressed zip entries are passed on as they are.
+ *
+ * Tar archives may be uncompressed or compressed as a whole with gzip or zstd (`.tar.gz`, `.tgz`, `.tar.zst`).
+ * A compressed tar can only be read front to back, so it is decompressed here and each wanted entry is copied.
+ * ustar, GNU long names and pax `path` records are understood.
+ *
+ * Entries that cannot be read, such as encrypted zip entries, are recorded in #errors and skipped.
+ */
+class ArchiveReader
+{
+public:
+    /// @brief Decides from an entry's name whether it is wanted, before its contents are copied
+    using Filter = std::function<bool(std::string_view name)>;
+
+    /**
+     * @brief Opens the archive. Throws std::runtime_error if it cannot be read or is not a zip or tar archive.
+     * @param allowMapping false to copy the archive into memory even if it is large (see utils::FileBuffer)
+     */
+    explicit ArchiveReader(const std::filesystem::path& archivePath, bool allowMapping = true);
+    ~ArchiveReader();
+
+    ArchiveReader(const ArchiveReader&) = delete;
+    ArchiveReader& operator=(const ArchiveReader&) = delete;
+
+    /// @brief Returns the next regular file that @p filter wants, or std::nullopt after the last one
+    std::optional<ArchiveEntry> next(const Filter& filter);
+
+    size_t entryCount() const { return m_entryCount; }                 ///< entries examined so far
+    const std::vector<std::string>& errors() const { return m_errors; } ///< one message per entry that could not be read
+
+    /// @brief True if the extension names a zip or tar archive: `.zip`, `.tar`, `.tgz`, `.tzst`, `.tar.gz` or `.tar.zst`
+    static bool isArchivePath(const std::filesystem::path& path);
+
+    /// @brief Splits an `archive!/entry` input at the first `!/` that follows an archive name
+    static std::optional<ArchiveEntryPath> splitEntryPath(const std::filesystem::path& path);
+
+    /// @brief The name that inputs and diagnostics use for an entry: @p archive followed by `!/` and @p entry
+    static std::filesystem::path entryPath(const std::filesystem::path& archive, std::string_view entry);
+
+private:
+    class Source;
+
+    std::optional<ArchiveEntry> nextZipEntry(const Filter& filter);
+    std::optional<ArchiveEntry> nextTarEntry(const Filter& filter);
+    void addError(std::string_view entry, const std::string& message);
+
+    const std::string m_archiveName;
+    std::unique_ptr<Source> m_source;
+    std::string m_tarHeader;        ///< a tar header that has been read but not yet handled
+    bool m_isZip{};
+    std::uint64_t m_zipEntriesLeft{};
+    size_t m_zipDirectoryOffset{};  ///< the next central directory record
+    size_t m_entryCount{};
+    std::vector<std::string> m_errors;
+};
+
+} // namespace mnxvalidate
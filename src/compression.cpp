@@ -0,0 +1,313 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <limits>
+
+#include <zlib.h>
+#ifdef MNXVALIDATE_USE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "compression.h"
+#include "utils/stringutils.h"
+
+namespace mnxvalidate {
+
+namespace {
+
+constexpr std::array<unsigned char, 2> kGzipMagic = { 0x1f, 0x8b };
+constexpr std::array<unsigned char, 4> kZstdMagic = { 0x28, 0xb5, 0x2f, 0xfd };
+constexpr int kGzipWindowBits = 15 + 16; // the largest window, with a gzip header and trailer rather than a zlib one
+
+template <size_t N>
+bool startsWith(std::string_view data, const std::array<unsigned char, N>& magic)
+{
+    return data.size() >= N && std::equal(magic.begin(), magic.end(), data.begin(),
+        [](unsigned char a, char b) { return a == static_cast<unsigned char>(b); });
+}
+
+// zlib counts its buffers in uInt, which may be smaller than the input
+uInt zlibChunk(size_t size)
+{ return static_cast<uInt>(std::min<size_t>(size, std::numeric_limits<uInt>::max())); }
+
+} // namespace
+
+Compression detectCompression(std::string_view data)
+{
+    if (startsWith(data, kGzipMagic)) {
+        return Compression::Gzip;
+    }
+    if (startsWith(data, kZstdMagic)) {
+        return Compression::Zstd;
+    }
+    return Compression::None;
+}
+
+Compression compressionForPath(const std::filesystem::path& path)
+{
+    if (utils::hasExtension(path, GZIP_EXTENSION)) {
+        return Compression::Gzip;
+    }
+    if (utils::hasExtension(path, ZSTD_EXTENSION)) {
+        return Compression::Zstd;
+    }
+    return Compression::None;
+}
+
+std::string_view compressionExtension(Compression compression)
+{
+    switch (compression) {
+        case Compression::Gzip: return ".gz";
+        case Compression::Zstd: return ".zst";
+        default: return {};
+    }
+}
+
+bool isCompressionSupported(Compression compression)
+{
+#ifndef MNXVALIDATE_USE_ZSTD
+    if (compression == Compression::Zstd) {
+        return false;
+    }
+#endif
+    return compression != Compression::None;
+}
+
+namespace {
+
+constexpr size_t kMaxZstdFrameHeaderSize = 18;
+
+std::optional<std::uintmax_t> sizeHint(std::string_view header, std::string_view gzipTrailer)
+{
+    switch (detectCompression(header)) {
+        case Compression::Gzip: {
+            // ISIZE, the last four bytes, little-endian
+            if (gzipTrailer.size() != 4) {
+                return std::nullopt;
+            }
+            std::uintmax_t size = 0;
+            for (size_t x = 0; x < 4; x++) {
+                size |= std::uintmax_t(static_cast<unsigned char>(gzipTrailer[x])) << (8 * x);
+            }
+            return size;
+        }
+#ifdef MNXVALIDATE_USE_ZSTD
+        case Compression::Zstd: {
+            const auto size = ZSTD_getFrameContentSize(header.data(), header.size());
+            if (size == ZSTD_CONTENTSIZE_UNKNOWN || size == ZSTD_CONTENTSIZE_ERROR) {
+                return std::nullopt;
+            }
+            return static_cast<std::uintmax_t>(size);
+        }
+#endif
+        default:
+            return std::nullopt;
+    }
+}
+
+} // namespace
+
+std::optional<std::uintmax_t> decompressedSizeHint(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::array<char, kMaxZstdFrameHeaderSize> header{};
+    if (!file.read(header.data(), header.size()) && file.gcount() <= 0) {
+        return std::nullopt;
+    }
+    const std::string_view headerView(header.data(), static_cast<size_t>(file.gcount()));
+    std::array<char, 4> trailer{};
+    file.clear();
+    const bool hasTrailer = file.seekg(-4, std::ios::end) && file.read(trailer.data(), trailer.size());
+    return sizeHint(headerView, hasTrailer ? std::string_view(trailer.data(), trailer.size()) : std::string_view());
+}
+
+std::optional<std::uintmax_t> decompressedSizeHint(std::string_view data)
+{
+    return sizeHint(data.substr(0, kMaxZstdFrameHeaderSize), data.size() >= 4 ? data.substr(data.size() - 4) : std::string_view());
+}
+
+struct Decompressor::Stream
+{
+    Compression compression{};
+    std::string_view input;         ///< the compressed bytes not yet handed to the decompressor
+    std::unique_ptr<char[]> output{ new char[kChunkSize] };
+    bool finished{};
+    z_stream zlib{};
+#ifdef MNXVALIDATE_USE_ZSTD
+    ZSTD_DStream* zstd{};
+    ZSTD_inBuffer zstdInput{};
+#endif
+
+    ~Stream()
+    {
+        if (compression == Compression::Gzip) {
+            inflateEnd(&zlib);
+        }
+#ifdef MNXVALIDATE_USE_ZSTD
+        ZSTD_freeDStream(zstd);
+#endif
+    }
+
+    std::string_view nextGzip()
+    {
+        while (true) {
+            if (zlib.avail_in == 0 && !input.empty()) {
+                zlib.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+                zlib.avail_in = zlibChunk(input.size());
+                input.remove_prefix(zlib.avail_in);
+            }
+            zlib.next_out = reinterpret_cast<Bytef*>(output.get());
+            zlib.avail_out = zlibChunk(kChunkSize);
+            const int status = inflate(&zlib, Z_NO_FLUSH);
+            const size_t produced = kChunkSize - zlib.avail_out;
+            if (status == Z_STREAM_END) {
+                if (zlib.avail_in == 0 && input.empty()) {
+                    finished = true;
+                } else if (inflateReset(&zlib) != Z_OK) { // another member follows
+                    throw DecompressionError("Unable to decompress gzip input.");
+                }
+            } else if (status != Z_OK && status != Z_BUF_ERROR) {
+                throw DecompressionError(std::string("Invalid gzip input: ") + (zlib.msg ? zlib.msg : "corrupt data"));
+            } else if (produced == 0 && zlib.avail_in == 0 && input.empty()) {
+                throw DecompressionError("Truncated gzip input.");
+            }
+            if (produced > 0 || finished) {
+                return { output.get(), produced };
+            }
+        }
+    }
+
+#ifdef MNXVALIDATE_USE_ZSTD
+    std::string_view nextZstd()
+    {
+        while (true) {
+            ZSTD_outBuffer zstdOutput{ output.get(), kChunkSize, 0 };
+            const size_t status = ZSTD_decompressStream(zstd, &zstdOutput, &zstdInput);
+            if (ZSTD_isError(status)) {
+                throw DecompressionError(std::string("Invalid zstd input: ") + ZSTD_getErrorName(status));
+            }
+            const bool inputConsumed = zstdInput.pos == zstdInput.size;
+            if (status == 0 && inputConsumed) { // the last frame is complete and flushed
+                finished = true;
+            } else if (zstdOutput.pos == 0 && inputConsumed) {
+                throw DecompressionError("Truncated zstd input.");
+            }
+            if (zstdOutput.pos > 0 || finished) {
+                return { output.get(), zstdOutput.pos };
+            }
+        }
+    }
+#endif
+};
+
+Decompressor::Decompressor(std::string_view compressed, Compression compression)
+    : m_stream(std::make_unique<Stream>())
+{
+    if (!isCompressionSupported(compression)) {
+        throw DecompressionError(compression == Compression::Zstd ? "This build of mnxvalidate cannot read zstd-compressed input."
+                                                                   : "The input is not compressed.");
+    }
+    auto& stream = *m_stream;
+    stream.input = compressed;
+    if (compression == Compression::Gzip) {
+        if (inflateInit2(&stream.zlib, kGzipWindowBits) != Z_OK) {
+            throw DecompressionError("Unable to start gzip decompression.");
+        }
+    }
+#ifdef MNXVALIDATE_USE_ZSTD
+    if (compression == Compression::Zstd) {
+        stream.zstd = ZSTD_createDStream();
+        if (!stream.zstd) {
+            throw DecompressionError("Unable to start zstd decompression.");
+        }
+        stream.zstdInput = { compressed.data(), compressed.size(), 0 };
+    }
+#endif
+    stream.compression = compression; // only now is there a stream for the destructor to end
+}
+
+Decompressor::~Decompressor() = default;
+
+std::string_view Decompressor::next()
+{
+    auto& stream = *m_stream;
+    if (stream.finished) {
+        return {};
+    }
+    std::string_view chunk;
+#ifdef MNXVALIDATE_USE_ZSTD
+    chunk = stream.compression == Compression::Zstd ? stream.nextZstd() : stream.nextGzip();
+#else
+    chunk = stream.nextGzip();
+#endif
+    m_decompressedSize += chunk.size();
+    return chunk;
+}
+
+std::string compress(std::string_view data, Compression compression)
+{
+    if (compression == Compression::None) {
+        return std::string(data);
+    }
+    if (!isCompressionSupported(compression)) {
+        throw std::invalid_argument("This build of mnxvalidate cannot write zstd-compressed output.");
+    }
+    std::string result;
+#ifdef MNXVALIDATE_USE_ZSTD
+    if (compression == Compression::Zstd) {
+        result.resize(ZSTD_compressBound(data.size()));
+        const size_t size = ZSTD_compress(result.data(), result.size(), data.data(), data.size(), ZSTD_CLEVEL_DEFAULT);
+        if (ZSTD_isError(size)) {
+            throw std::runtime_error(std::string("zstd compression failed: ") + ZSTD_getErrorName(size));
+        }
+        result.resize(size);
+        return result;
+    }
+#endif
+    z_stream zlib{};
+    if (deflateInit2(&zlib, Z_DEFAULT_COMPRESSION, Z_DEFLATED, kGzipWindowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("Unable to start gzip compression.");
+    }
+    std::array<char, Decompressor::kChunkSize> chunk;
+    int status = Z_OK;
+    while (status != Z_STREAM_END) {
+        if (zlib.avail_in == 0 && !data.empty()) {
+            zlib.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+            zlib.avail_in = zlibChunk(data.size());
+            data.remove_prefix(zlib.avail_in);
+        }
+        zlib.next_out = reinterpret_cast<Bytef*>(chunk.data());
+        zlib.avail_out = zlibChunk(chunk.size());
+        status = deflate(&zlib, data.empty() ? Z_FINISH : Z_NO_FLUSH);
+        if (status == Z_STREAM_ERROR) {
+            deflateEnd(&zlib);
+            throw std::runtime_error("gzip compression failed.");
+        }
+        result.append(chunk.data(), chunk.size() - zlib.avail_out);
+    }
+    deflateEnd(&zlib);
+    return result;
+}
+
+} // namespace mnxvalidate
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <iterator>
+#include <cstddef>
+#include <cstdint>
+
+namespace mnxvalidate {
+
+constexpr char8_t GZIP_EXTENSION[]               = u8"gz";
+constexpr char8_t ZSTD_EXTENSION[]               = u8"zst";
+
+/// @brief How an input is compressed
+enum class Compression
+{
+    None,
+    Gzip,
+    Zstd
+};
+
+/// @brief The compression whose magic bytes start @p data
+Compression detectCompression(std::string_view data);
+
+/// @brief The compression that a `.gz` or `.zst` extension names
+Compression compressionForPath(const std::filesystem::path& path);
+
+/// @brief The file extension for the compression, including the dot, or an empty string for #Compression::None
+std::string_view compressionExtension(Compression compression);
+
+/// @brief False for zstd when this build was configured without it
+bool isCompressionSupported(Compression compression);
+
+/**
+ * @brief The decompressed size recorded in a compressed file's header or trailer, for estimating memory use.
+ *
+ * This reads only the few bytes that hold the size. It is a hint: gzip records the size modulo 2^32 and
+ * zstd frames may omit it, and only the first zstd frame and the last gzip member are consulted.
+ */
+std::optional<std::uintmax_t> decompressedSizeHint(const std::filesystem::path& path);
+
+/// @brief #decompressedSizeHint for compressed data in memory
+std::optional<std::uintmax_t> decompressedSizeHint(std::string_view data);
+
+/// @brief Thrown when compressed input is corrupt, truncated, or in a format this build cannot read
+class DecompressionError : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief Decompresses a gzip or zstd stream held in memory a chunk at a time.
+ *
+ * Iterating feeds the decompressed bytes straight to a parser, so only one chunk of the decompressed
+ * document is held at a time rather than all of it. Concatenated gzip members and zstd frames are read
+ * as one stream, as `gzip -d` and `zstd -d` do.
+ */
+class Decompressor
+{
+public:
+    static constexpr size_t kChunkSize = 64 * 1024;
+
+    /// @throws DecompressionError if the compression is #Compression::None or not supported by this build
+    Decompressor(std::string_view compressed, Compression compression);
+    ~Decompressor();
+
+    Decompressor(const Decompressor&) = delete;
+    Decompressor& operator=(const Decompressor&) = delete;
+
+    /// @brief The next chunk of decompressed bytes, or an empty view at the end. Invalidates the previous chunk.
+    /// @throws DecompressionError if the stream is corrupt or ends early
+    std::string_view next();
+
+    /// @brief The number of decompressed bytes returned so far
+    std::uintmax_t decompressedSize() const { return m_decompressedSize; }
+
+    /// @brief A single-pass iterator over the decompressed bytes, for parsers that read a character at a time
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = char;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const char*;
+        using reference = const char&;
+
+        iterator() = default;
+        explicit iterator(Decompressor* source) : m_source(source) { refill(); }
+
+        reference operator*() const { return *m_position; }
+        iterator& operator++()
+        {
+            if (++m_position == m_end) {
+                refill();
+            }
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        /// the end iterator is the only one without a position
+        bool operator==(const iterator& other) const { return m_position == other.m_position; }
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+
+    private:
+        void refill()
+        {
+            const auto chunk = m_source->next();
+            m_position = chunk.empty() ? nullptr : chunk.data();
+            m_end = chunk.empty() ? nullptr : chunk.data() + chunk.size();
+        }
+
+        Decompressor* m_source{};
+        const char* m_position{};
+        const char* m_end{};
+    };
+
+    /// @brief Starts decompressing. Call it once: the bytes are not kept for a second pass.
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(); }
+
+private:
+    struct Stream;
+
+    std::unique_ptr<Stream> m_stream;
+    std::uintmax_t m_decompressedSize{};
+};
+
+/// @brief Compresses @p data in memory, or copies it for #Compression::None. Used by mnxgen and the tests to write compressed inputs.
+/// @throws std::invalid_argument if the compression is not supported by this build
+std::string compress(std::string_view data, Compression compression);
+
+} // namespace mnxvalidate
@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <cctype>
+
+#include "diagnosticlist.h"
+
+namespace mnxvalidate {
+
+namespace {
+
+// Stands for a detail in a kind. A message that contains it keeps it as a detail of its own.
+constexpr char kPlaceholder = '\x1f';
+constexpr char kEllipsis[] = "...";
+
+bool isWordChar(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || (static_cast<unsigned char>(c) & 0x80);
+}
+
+bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// Splits a message into its kind and the details taken out of it: the contents of quoted strings, and numbers
+// that stand alone rather than being part of a word, such as indices and positions.
+void splitMessage(std::string_view message, std::string& kind, std::vector<std::string_view>& details)
+{
+    kind.clear();
+    details.clear();
+    for (size_t x = 0; x < message.size();) {
+        const char c = message[x];
+        const bool startsWord = x == 0 || !isWordChar(message[x - 1]);
+        if (c == '"' || (c == '\'' && startsWord)) {
+            // a single quote only opens a quotation at the start of a word, so apostrophes are left alone
+            size_t close = message.find(c, x + 1);
+            while (c == '\'' && close != std::string_view::npos && close + 1 < message.size() && isWordChar(message[close + 1])) {
+                close = message.find(c, close + 1);
+            }
+            if (close != std::string_view::npos) {
+                kind += c;
+                kind += kPlaceholder;
+                kind += c;
+                details.push_back(message.substr(x + 1, close - x - 1));
+                x = close + 1;
+                continue;
+            }
+        } else if (isDigit(c) && startsWord) {
+            size_t end = x + 1;
+            while (end < message.size() && (isDigit(message[end]) || (message[end] == '.' && end + 1 < message.size() && isDigit(message[end + 1])))) {
+                end++;
+            }
+            if (end == message.size() || !isWordChar(message[end])) {
+                kind += kPlaceholder;
+                details.push_back(message.substr(x, end - x));
+                x = end;
+                continue;
+            }
+        } else if (c == kPlaceholder) {
+            kind += kPlaceholder;
+            details.push_back(message.substr(x, 1));
+            x++;
+            continue;
+        }
+        kind += c;
+        x++;
+    }
+}
+
+template <typename T>
+T checkedSize(size_t value)
+{
+    if (value > std::numeric_limits<T>::max()) {
+        throw std::length_error("too many diagnostics for one input");
+    }
+    return static_cast<T>(value);
+}
+
+} // namespace
+
+std::string phaseName(ValidationPhase phase)
+{
+    switch (phase) {
+    case ValidationPhase::Read: return "read";
+    case ValidationPhase::Parse: return "parse";
+    case ValidationPhase::Schema: return "schema";
+    case ValidationPhase::Semantic: return "semantic";
+    }
+    return "unknown";
+}
+
+void DiagnosticList::add(ValidationPhase phase, std::string_view pointer, std::string_view message)
+{
+    std::string kind;
+    std::vector<std::string_view> details;
+    splitMessage(message, kind, details);
+    const auto [kindIt, inserted] = m_kindIds.emplace(std::move(kind), checkedSize<std::uint32_t>(m_kinds.size()));
+    if (inserted) {
+        m_kinds.push_back(kindIt->first);
+    }
+
+    size_t textSize = m_text.size() + pointer.size();
+    for (const auto detail : details) {
+        textSize += detail.size();
+    }
+    checkedSize<std::uint32_t>(textSize); // so that every offset fits in a record
+
+    Record record{};
+    record.kind = kindIt->second;
+    record.textOffset = static_cast<std::uint32_t>(m_text.size());
+    record.pointerLength = checkedSize<std::uint32_t>(pointer.size());
+    record.firstDetail = checkedSize<std::uint32_t>(m_detailLengths.size());
+    record.detailCount = checkedSize<std::uint16_t>(details.size());
+    record.phase = phase;
+    m_text += pointer;
+    for (const auto detail : details) {
+        m_text += detail;
+        m_detailLengths.push_back(static_cast<std::uint32_t>(detail.size()));
+    }
+    m_records.push_back(record);
+}
+
+std::string_view DiagnosticList::pointer(size_t index) const
+{
+    const Record& record = m_records[index];
+    return std::string_view(m_text).substr(record.textOffset, record.pointerLength);
+}
+
+std::string_view DiagnosticList::detail(const Record& record, size_t detailIndex) const
+{
+    size_t offset = size_t(record.textOffset) + record.pointerLength;
+    for (size_t x = 0; x < detailIndex; x++) {
+        offset += m_detailLengths[record.firstDetail + x];
+    }
+    return std::string_view(m_text).substr(offset, m_detailLengths[record.firstDetail + detailIndex]);
+}
+
+Diagnostic DiagnosticList::operator[](size_t index) const
+{
+    const Record& record = m_records[index];
+    Diagnostic result{ record.phase, std::string(pointer(index)), {} };
+    const std::string& kind = m_kinds[record.kind];
+    result.message.reserve(kind.size() + m_text.size() / std::max<size_t>(m_records.size(), 1));
+    size_t offset = size_t(record.textOffset) + record.pointerLength;
+    size_t nextDetail = record.firstDetail;
+    for (const char c : kind) {
+        if (c == kPlaceholder) {
+            const size_t length = m_detailLengths[nextDetail++];
+            result.message.append(m_text, offset, length);
+            offset += length;
+        } else {
+            result.message += c;
+        }
+    }
+    return result;
+}
+
+std::string DiagnosticList::kind(size_t index) const
+{
+    std::string result;
+    for (const char c : m_kinds[m_records[index].kind]) {
+        if (c == kPlaceholder) {
+            result += kEllipsis;
+        } else {
+            result += c;
+        }
+    }
+    return result;
+}
+
+std::string DiagnosticList::location(size_t index) const
+{
+    const Record& record = m_records[index];
+    if (record.pointerLength) {
+        return std::string(pointer(index));
+    }
+    std::string result;
+    for (size_t x = 0; x < record.detailCount; x++) {
+        if (x) {
+            result += ", ";
+        }
+        result += detail(record, x);
+    }
+    return result;
+}
+
+std::vector<DiagnosticList::Group> DiagnosticList::groups(size_t maxExamples) const
+{
+    std::vector<Group> result;
+    std::unordered_map<std::uint64_t, size_t> groupIndex;
+    for (size_t x = 0; x < m_records.size(); x++) {
+        const Record& record = m_records[x];
+        const std::uint64_t key = (std::uint64_t(record.kind) << 8) | std::uint64_t(record.phase);
+        const auto [it, inserted] = groupIndex.emplace(key, result.size());
+        if (inserted) {
+            result.emplace_back();
+        }
+        Group& group = result[it->second];
+        group.count++;
+        if (group.examples.size() < maxExamples) {
+            group.examples.push_back(x);
+        }
+    }
+    return result;
+}
+
+void DiagnosticSummary::add(const DiagnosticList& diagnostics)
+{
+    if (diagnostics.empty()) {
+        return;
+    }
+    m_inputCount++;
+    m_errorCount += diagnostics.size();
+    for (const auto& group : diagnostics.groups(1)) {
+        const size_t first = group.examples.front();
+        std::string kind = diagnostics.kind(first);
+        const auto [it, inserted] = m_entryIndex.emplace(phaseName(diagnostics.phase(first)) + ':' + kind, m_entries.size());
+        if (inserted) {
+            m_entries.push_back({ diagnostics.phase(first), std::move(kind), 0, 0 });
+        }
+        Entry& entry = m_entries[it->second];
+        entry.count += group.count;
+        entry.inputCount++;
+    }
+}
+
+std::vector<DiagnosticSummary::Entry> DiagnosticSummary::top(size_t count) const
+{
+    std::vector<Entry> result = m_entries;
+    // stable, so kinds that tie keep the order they were first seen in
+    std::stable_sort(result.begin(), result.end(), [](const Entry& a, const Entry& b) { return a.count > b.count; });
+    if (result.size() > count) {
+        result.resize(count);
+    }
+    return result;
+}
+
+} // namespace mnxvalidate
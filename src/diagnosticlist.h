@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <iterator>
+#include <cstdint>
+#include <cstddef>
+
+namespace mnxvalidate {
+
+/// @brief the stage of validation at which a file's result was decided
+enum class ValidationPhase
+{
+    Read,       ///< the input could not be read
+    Parse,      ///< the input is not valid json
+    Schema,     ///< validation against the json schema
+    Semantic    ///< the semantic checks that follow schema validation
+};
+
+/// @brief the name used for a phase in reports
+std::string phaseName(ValidationPhase phase);
+
+/// @brief An error found in an input, with its fields kept separate for machine-readable reports
+struct Diagnostic
+{
+    ValidationPhase phase{};    ///< the phase that found the error
+    std::string pointer;        ///< the json pointer to the offending value, if known
+    std::string message;        ///< the utf-8 encoded description of the error
+};
+
+/**
+ * @brief The errors found in one input, stored compactly and formatted only when they are read.
+ *
+ * Each message is split into its kind, the text with its quoted strings and numbers taken out, and the details
+ * that were taken out, which are usually the ids and indices the error refers to. A broken export tends to repeat
+ * a few kinds many times, so each kind is stored once per list, and each error is a small record plus its json
+ * pointer and details in a per-list text arena. Errors of the same kind can be reported together with #groups.
+ */
+class DiagnosticList
+{
+public:
+    void add(ValidationPhase phase, std::string_view pointer, std::string_view message);
+
+    size_t size() const { return m_records.size(); }
+    bool empty() const { return m_records.empty(); }
+
+    Diagnostic operator[](size_t index) const;     ///< Formats the error at @p index
+    Diagnostic front() const { return (*this)[0]; }
+
+    ValidationPhase phase(size_t index) const { return m_records[index].phase; }
+    std::string_view pointer(size_t index) const;
+
+    /// @brief The kind of the error at @p index: its message with each detail replaced by "..."
+    std::string kind(size_t index) const;
+
+    /// @brief Where the error at @p index is: its json pointer if it has one, otherwise its details
+    std::string location(size_t index) const;
+
+    /// @brief The errors of one kind, for reporting them together
+    struct Group
+    {
+        size_t count{};                 ///< the number of errors of this kind
+        std::vector<size_t> examples;   ///< the indices of the first few, the first of which is the first of the kind
+    };
+
+    /// @brief Groups the errors by phase and kind, in the order each kind first occurs
+    std::vector<Group> groups(size_t maxExamples) const;
+
+    /// @brief Iterates the formatted errors
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Diagnostic;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Diagnostic;
+
+        const_iterator(const DiagnosticList& list, size_t index) : m_list(&list), m_index(index) {}
+
+        Diagnostic operator*() const { return (*m_list)[m_index]; }
+        const_iterator& operator++() { ++m_index; return *this; }
+        const_iterator operator++(int) { auto result = *this; ++m_index; return result; }
+        bool operator==(const const_iterator& other) const { return m_index == other.m_index; }
+        bool operator!=(const const_iterator& other) const { return m_index != other.m_index; }
+
+    private:
+        const DiagnosticList* m_list;
+        size_t m_index;
+    };
+
+    const_iterator begin() const { return { *this, 0 }; }
+    const_iterator end() const { return { *this, size() }; }
+
+private:
+    struct Record
+    {
+        std::uint32_t kind;             ///< index into #m_kinds
+        std::uint32_t textOffset;       ///< where the pointer starts in #m_text. The details follow it.
+        std::uint32_t pointerLength;
+        std::uint32_t firstDetail;      ///< index into #m_detailLengths
+        std::uint16_t detailCount;
+        ValidationPhase phase;
+    };
+
+    std::string_view detail(const Record& record, size_t detailIndex) const;
+
+    std::vector<Record> m_records;
+    std::string m_text;                             ///< the arena holding each error's pointer and details
+    std::vector<std::uint32_t> m_detailLengths;
+    std::vector<std::string> m_kinds;               ///< each kind's message, with a placeholder for each detail
+    std::unordered_map<std::string, std::uint32_t> m_kindIds;
+};
+
+/**
+ * @brief Counts errors by kind across many inputs, for a summary of the most frequent ones.
+ *
+ * Not thread-safe: add each input's list from one thread.
+ */
+class DiagnosticSummary
+{
+public:
+    struct Entry
+    {
+        ValidationPhase phase{};
+        std::string kind;           ///< as returned by #DiagnosticList::kind
+        size_t count{};             ///< the number of errors of this kind
+        size_t inputCount{};        ///< the number of inputs with at least one
+    };
+
+    void add(const DiagnosticList& diagnostics);
+
+    /// @brief The @p count most frequent kinds, most frequent first
+    std::vector<Entry> top(size_t count) const;
+
+    size_t errorCount() const { return m_errorCount; }      ///< the number of errors added
+    size_t inputCount() const { return m_inputCount; }      ///< the number of inputs added that had errors
+
+private:
+    std::vector<Entry> m_entries;
+    std::unordered_map<std::string, size_t> m_entryIndex;   ///< by phase name and kind
+    size_t m_errorCount{};
+    size_t m_inputCount{};
+};
+
+} // namespace mnxvalidate
@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <algorithm>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+#include "directorywalker.h"
+#include "mnxvalidate.h"
+
+namespace mnxvalidate {
+
+// Enough to keep validation busy without holding a large part of a huge tree in memory
+constexpr size_t kMaxQueuedFiles = 4096;
+
+DirectoryWalker::DirectoryWalker(const std::filesystem::path& root, bool recursive, Filter filter, unsigned threadCount, Filter directoryFilter)
+    : m_recursive(recursive), m_filter(std::move(filter)), m_directoryFilter(std::move(directoryFilter)), m_startTime(std::chrono::steady_clock::now())
+{
+    // a single directory is read by a single thread, so more would only wait
+    const unsigned walkerCount = recursive ? std::max(1u, threadCount) : 1u;
+    for (unsigned x = 0; x < walkerCount; x++) {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+    if (recursive) {
+        firstVisit(root);
+    }
+    pushDirectory(0, root);
+    m_threads.reserve(walkerCount);
+    for (unsigned x = 0; x < walkerCount; x++) {
+        m_threads.emplace_back([this, x]() { run(x); });
+    }
+}
+
+DirectoryWalker::~DirectoryWalker()
+{
+    m_stopping = true;
+    {
+        std::lock_guard lock(m_idleMutex); // so that no thread can check m_stopping and then miss the notification
+    }
+    m_workChanged.notify_all();
+    {
+        std::lock_guard lock(m_outputMutex);
+    }
+    m_outputChanged.notify_all();
+    m_threads.clear();
+}
+
+std::optional<std::filesystem::path> DirectoryWalker::next()
+{
+    std::unique_lock lock(m_outputMutex);
+    m_outputChanged.wait(lock, [&]() { return !m_files.empty() || m_walkDone; });
+    if (m_files.empty()) {
+        return std::nullopt;
+    }
+    auto path = std::move(m_files.front());
+    m_files.pop_front();
+    lock.unlock();
+    m_outputChanged.notify_all();
+    return path;
+}
+
+void DirectoryWalker::run(size_t index)
+{
+    while (!m_stopping) {
+        std::filesystem::path directory;
+        if (takeDirectory(index, directory)) {
+            scanDirectory(index, directory);
+            if (--m_pendingCount == 0) {
+                {
+                    std::lock_guard lock(m_idleMutex);
+                }
+                m_workChanged.notify_all();
+                {
+                    std::lock_guard lock(m_outputMutex);
+                    m_walkDone = true;
+                    m_elapsed = std::chrono::steady_clock::now() - m_startTime;
+                }
+                m_outputChanged.notify_all();
+            }
+            continue;
+        }
+        std::unique_lock lock(m_idleMutex);
+        m_workChanged.wait(lock, [&]() { return m_stopping || m_pendingCount == 0 || m_queuedCount > 0; });
+        if (m_pendingCount == 0) {
+            return;
+        }
+    }
+}
+
+// A thread takes its newest directory, which keeps its own walk depth-first. It steals the oldest directory
+// from another thread, because that is the one most likely to have a large subtree below it.
+bool DirectoryWalker::takeDirectory(size_t index, std::filesystem::path& directory)
+{
+    for (size_t x = 0; x < m_queues.size(); x++) {
+        auto& queue = *m_queues[(index + x) % m_queues.size()];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.directories.empty()) {
+            if (x == 0) {
+                directory = std::move(queue.directories.back());
+                queue.directories.pop_back();
+            } else {
+                directory = std::move(queue.directories.front());
+                queue.directories.pop_front();
+            }
+            m_queuedCount--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void DirectoryWalker::pushDirectory(size_t index, std::filesystem::path directory)
+{
+    m_pendingCount++; // before it can be taken, so the count cannot reach zero while it is queued
+    {
+        auto& queue = *m_queues[index];
+        std::lock_guard lock(queue.mutex);
+        queue.directories.push_back(std::move(directory));
+    }
+    {
+        std::lock_guard lock(m_idleMutex);
+        m_queuedCount++;
+    }
+    m_workChanged.notify_one();
+}
+
+void DirectoryWalker::scanDirectory(size_t index, const std::filesystem::path& directory)
+{
+    std::error_code ec;
+    std::filesystem::directory_iterator it(directory, ec);
+    if (ec) {
+        addError(directory, ec);
+        return;
+    }
+    m_directoryCount++;
+    for (; it != std::filesystem::directory_iterator(); it.increment(ec)) {
+        if (ec || m_stopping) {
+            break;
+        }
+        m_entryCount++;
+        const auto& entry = *it;
+        // a broken link is neither a directory nor a regular file, which is all that matters here
+        std::error_code entryEc;
+        if (entry.is_directory(entryEc)) {
+            if (m_recursive && (!m_directoryFilter || m_directoryFilter(entry.path())) && firstVisit(entry.path())) {
+                pushDirectory(index, entry.path());
+            }
+        } else if (entry.is_regular_file(entryEc) && m_filter(entry.path())) {
+            addFile(entry.path());
+        }
+    }
+    if (ec) {
+        addError(directory, ec);
+    }
+}
+
+bool DirectoryWalker::firstVisit(const std::filesystem::path& directory)
+{
+#ifdef _WIN32
+    std::error_code ec;
+    auto canonicalPath = std::filesystem::canonical(directory, ec);
+    if (ec) {
+        return true; // scanning it will report the problem
+    }
+    std::lock_guard lock(m_visitedMutex);
+    return m_visitedPaths.insert(std::move(canonicalPath)).second;
+#else
+    struct stat status{};
+    if (::stat(directory.c_str(), &status) != 0) {
+        return true; // scanning it will report the problem
+    }
+    std::lock_guard lock(m_visitedMutex);
+    return m_visitedIds.emplace(static_cast<std::uintmax_t>(status.st_dev), static_cast<std::uintmax_t>(status.st_ino)).second;
+#endif
+}
+
+void DirectoryWalker::addFile(std::filesystem::path path)
+{
+    std::unique_lock lock(m_outputMutex);
+    m_outputChanged.wait(lock, [&]() { return m_stopping || m_files.size() < kMaxQueuedFiles; });
+    if (m_stopping) {
+        return;
+    }
+    m_files.push_back(std::move(path));
+    lock.unlock();
+    m_outputChanged.notify_all();
+}
+
+void DirectoryWalker::addError(const std::filesystem::path& path, const std::error_code& ec)
+{
+    std::lock_guard lock(m_outputMutex);
+    m_errors.push_back("Unable to read directory " + utils::pathToString(path) + ": " + ec.message());
+}
+
+} // namespace mnxvalidate
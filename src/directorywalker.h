@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <set>
+#include <memory>
+#include <optional>
+#include <functional>
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace mnxvalidate {
+
+/**
+ * @brief Searches a directory tree on several threads and hands out matching files as they are found.
+ *
+ * Each thread scans directories from its own queue and steals from the others when it runs out, so a deep
+ * subtree does not hold up the rest of the walk. Found files wait in a bounded queue until #next takes them,
+ * so validation can start with the first file while the walk continues.
+ *
+ * Symbolic links to directories are followed, but each directory is scanned once no matter how many links
+ * lead to it, so link loops end. A directory that cannot be read is recorded in #errors and skipped.
+ *
+ * With more than one thread, files are found in no particular order.
+ */
+class DirectoryWalker
+{
+public:
+    /// @brief Decides whether a regular file is wanted, or a directory searched. It is called on the walker threads, so it must be thread-safe.
+    using Filter = std::function<bool(const std::filesystem::path& path)>;
+
+    /**
+     * @brief Starts walking
+     * @param root the directory to search
+     * @param recursive if false, only @p root itself is searched
+     * @param filter decides which files #next returns
+     * @param threadCount the number of walker threads
+     * @param directoryFilter if set, decides which subdirectories are searched, so that subtrees with nothing wanted are skipped
+     */
+    DirectoryWalker(const std::filesystem::path& root, bool recursive, Filter filter, unsigned threadCount, Filter directoryFilter = {});
+    ~DirectoryWalker(); ///< Stops the walk, if it is still running
+
+    DirectoryWalker(const DirectoryWalker&) = delete;
+    DirectoryWalker& operator=(const DirectoryWalker&) = delete;
+
+    /// @brief Waits for the next matching file. Returns std::nullopt when the walk is complete.
+    std::optional<std::filesystem::path> next();
+
+    // Call these once #next has returned std::nullopt.
+    size_t directoryCount() const { return m_directoryCount; }  ///< directories scanned
+    size_t entryCount() const { return m_entryCount; }          ///< directory entries examined
+    std::chrono::steady_clock::duration elapsed() const { return m_elapsed; }
+    const std::vector<std::string>& errors() const { return m_errors; } ///< one message per directory or entry that could not be read
+
+private:
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<std::filesystem::path> directories;
+    };
+
+    void run(size_t index);
+    bool takeDirectory(size_t index, std::filesystem::path& directory);
+    void pushDirectory(size_t index, std::filesystem::path directory);
+    void scanDirectory(size_t index, const std::filesystem::path& directory);
+    bool firstVisit(const std::filesystem::path& directory); ///< true if no other path to this directory has been queued
+    void addFile(std::filesystem::path path);
+    void addError(const std::filesystem::path& path, const std::error_code& ec);
+
+    const bool m_recursive;
+    const Filter m_filter;
+    const Filter m_directoryFilter;
+    const std::chrono::steady_clock::time_point m_startTime;
+
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;   ///< one per thread
+    std::atomic<size_t> m_queuedCount{};                ///< directories waiting in the queues
+    std::atomic<size_t> m_pendingCount{};               ///< directories queued or being scanned
+    std::mutex m_idleMutex;
+    std::condition_variable m_workChanged;
+
+    std::mutex m_visitedMutex;
+#ifdef _WIN32
+    std::set<std::filesystem::path> m_visitedPaths;                    ///< the canonical path of each queued directory
+#else
+    std::set<std::pair<std::uintmax_t, std::uintmax_t>> m_visitedIds;  ///< the device and inode of each queued directory
+#endif
+    std::atomic<bool> m_stopping{};
+
+    std::mutex m_outputMutex;                           ///< guards everything below it except the threads
+    std::condition_variable m_outputChanged;
+    std::deque<std::filesystem::path> m_files;
+    bool m_walkDone{};
+    std::vector<std::string> m_errors;
+    std::atomic<size_t> m_directoryCount{};
+    std::atomic<size_t> m_entryCount{};
+    std::chrono::steady_clock::duration m_elapsed{};
+
+    std::vector<std::jthread> m_threads;                ///< declared last so the threads stop before anything they use is destroyed
+};
+
+} // namespace mnxvalidate
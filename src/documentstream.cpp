@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+
+#include "documentstream.h"
+
+namespace {
+
+bool isBlank(const std::string& line)
+{
+    return line.find_first_not_of(" \t\r") == std::string::npos;
+}
+
+} // namespace
+
+namespace mnxvalidate {
+
+std::optional<ValidationInput> DocumentStreamReader::next()
+{
+    std::string line;
+    while (std::getline(m_input, line)) {
+        if (!isBlank(line)) {
+            break;
+        }
+    }
+    if (isBlank(line)) {
+        return std::nullopt;
+    }
+    m_sequence++;
+    if (m_format == StreamFormat::Ndjson) {
+        return ValidationInput{ utils::utf8ToPath(sequenceName()), std::move(line) };
+    }
+
+    if (line.back() == '\r') {
+        line.pop_back();
+    }
+    const auto start = line.find_first_not_of(" \t");
+    size_t length{};
+    const auto [ptr, ec] = std::from_chars(line.data() + start, line.data() + line.size(), length);
+    if (ec != std::errc() || (ptr != line.data() + line.size() && *ptr != ' ' && *ptr != '\t')) {
+        throw std::runtime_error("Invalid header for document " + sequenceName() + ": " + line);
+    }
+    if (length > kMaxDocumentSize) {
+        throw std::runtime_error("Invalid header for document " + sequenceName() + ": " + std::to_string(length)
+            + " bytes is more than the limit of " + std::to_string(kMaxDocumentSize));
+    }
+    std::string id = line.substr(static_cast<size_t>(ptr - line.data()));
+    id.erase(0, id.find_first_not_of(" \t"));
+    // an id with a separator would be taken for a path, or for an archive entry if it contains "!/"
+    if (id.find_first_of("/\\") != std::string::npos) {
+        throw std::runtime_error("Invalid id for document " + sequenceName() + ": " + id + " (ids cannot contain / or \\)");
+    }
+    const std::string name = id.empty() ? sequenceName() : id;
+    // read in chunks, so that a header that overstates the length does not allocate memory for bytes that never come
+    constexpr size_t kChunkSize = 1024 * 1024;
+    std::string contents;
+    while (contents.size() < length) {
+        const size_t chunk = std::min(kChunkSize, length - contents.size());
+        const size_t offset = contents.size();
+        contents.resize(offset + chunk);
+        if (!m_input.read(contents.data() + offset, static_cast<std::streamsize>(chunk))) {
+            throw std::runtime_error("Document " + name + " is truncated: expected " + std::to_string(length) + " bytes");
+        }
+    }
+    return ValidationInput{ utils::utf8ToPath(name), std::move(contents) };
+}
+
+} // namespace mnxvalidate
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <istream>
+#include <optional>
+#include <string>
+
+#include "mnxvalidate.h"
+
+namespace mnxvalidate {
+
+/**
+ * @brief Reads documents one at a time from a stream, such as stdin.
+ *
+ * In #StreamFormat::Ndjson each non-blank line is a document. In #StreamFormat::Framed each document is
+ * preceded by a header line `<byte-count> [<id>]` and may contain newlines. Documents are reported as
+ * `<id>` if the header supplies one, otherwise as `<stream-name>#<sequence-number>`. An id is reported like a file
+ * name, so it cannot contain a path separator.
+ */
+class DocumentStreamReader
+{
+public:
+    static constexpr size_t kMaxDocumentSize = size_t(1) << 30; ///< framed headers with larger byte counts are rejected
+
+    DocumentStreamReader(std::istream& input, StreamFormat format, std::string streamName)
+        : m_input(input), m_format(format), m_streamName(std::move(streamName)) {}
+
+    /// @brief Reads the next document, or returns std::nullopt at the end of the stream. Throws if the stream is malformed.
+    std::optional<ValidationInput> next();
+
+private:
+    std::string sequenceName() const { return m_streamName + "#" + std::to_string(m_sequence); }
+
+    std::istream& m_input;
+    StreamFormat m_format;
+    std::string m_streamName;
+    size_t m_sequence{};
+};
+
+} // namespace mnxvalidate
@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <algorithm>
+#include <stdexcept>
+#include <csignal>
+#include <cstring>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#include "mnxvalidate.h"
+#include "filewatcher.h"
+#include "compression.h"
+#include "archivereader.h"
+
+namespace mnxvalidate {
+
+namespace {
+
+volatile std::sig_atomic_t watchStopRequested = 0;
+
+extern "C" void handleWatchStopSignal(int)
+{
+    watchStopRequested = 1;
+}
+
+bool isSeparator(std::filesystem::path::value_type c)
+{
+    return c == std::filesystem::path::value_type('/') || c == std::filesystem::path::preferred_separator;
+}
+
+// Returns the part of @p path below @p directory, or std::nullopt if it is not below it.
+std::optional<GlobPattern::StringView> relativeTo(const std::filesystem::path& directory, const std::filesystem::path& path)
+{
+    const GlobPattern::StringView directoryView(directory.native());
+    const GlobPattern::StringView pathView(path.native());
+    if (pathView.size() <= directoryView.size() || !pathView.starts_with(directoryView)) {
+        return std::nullopt;
+    }
+    const auto rest = pathView.substr(directoryView.size());
+    if (!directoryView.empty() && !isSeparator(directoryView.back()) && !isSeparator(rest.front())) {
+        return std::nullopt; // a sibling whose name starts with the directory's name
+    }
+    return rest;
+}
+
+} // namespace
+
+bool InputTarget::wantsFile(const std::filesystem::path& path) const
+{
+    if (!pattern) {
+        return path == file;
+    }
+    const auto relativePath = relativeTo(directory, path);
+    return relativePath && wantsRelativePath(std::filesystem::path(relativePath.value()));
+}
+
+bool InputTarget::wantsRelativePath(const std::filesystem::path& relativePath) const
+{
+    // a compressed input is named like the file it decompresses to, so patterns for that file pick it up too
+    const bool isCompressed = compressionForPath(relativePath) != Compression::None;
+    const auto uncompressedPath = isCompressed ? relativePath.parent_path() / relativePath.stem() : relativePath;
+    if (!utils::hasExtension(uncompressedPath, MNX_EXTENSION) && !utils::hasExtension(uncompressedPath, JSON_EXTENSION)) {
+        return false;
+    }
+    return pattern && (pattern->matches(relativePath.native()) || (isCompressed && pattern->matches(uncompressedPath.native())));
+}
+
+bool InputTarget::wantsDirectory(const std::filesystem::path& path) const
+{
+    const auto relativePath = relativeTo(directory, path);
+    return pattern && relativePath && pattern->mayMatchBelow(relativePath.value());
+}
+
+bool FileWatcher::wantsFile(const std::filesystem::path& path) const
+{
+    return std::any_of(m_targets.begin(), m_targets.end(), [&](const InputTarget& target) { return target.wantsFile(path); });
+}
+
+bool FileWatcher::wantsDirectory(const std::filesystem::path& path) const
+{
+    return std::any_of(m_targets.begin(), m_targets.end(), [&](const InputTarget& target) {
+        return target.spansDirectories() && target.wantsDirectory(path);
+    });
+}
+
+std::vector<std::string> FileWatcher::takeErrors()
+{
+    return std::exchange(m_errors, {});
+}
+
+#ifdef __linux__
+
+FileWatcher::FileWatcher(std::vector<InputTarget> targets)
+    : m_targets(std::move(targets))
+{
+    m_fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0) {
+        throw std::runtime_error(std::string("Unable to watch for changes: ") + std::strerror(errno));
+    }
+    std::unordered_set<int> visited;
+    for (const auto& target : m_targets) {
+        watchDirectory(target.directory, false, visited);
+    }
+}
+
+FileWatcher::~FileWatcher()
+{
+    if (m_fd >= 0) {
+        ::close(m_fd); // removes every watch
+    }
+}
+
+void FileWatcher::watchDirectory(const std::filesystem::path& directory, bool collectFiles, std::unordered_set<int>& visited)
+{
+    // IN_CREATE is only needed for directories: a new file is reported again when it is closed after writing
+    const int wd = ::inotify_add_watch(m_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR);
+    if (wd < 0) {
+        m_errors.push_back("Unable to watch " + utils::pathToString(directory) + ": " + std::strerror(errno));
+        return;
+    }
+    if (!visited.insert(wd).second) {
+        return; // a link back to a directory that is already being watched
+    }
+    m_directories[wd] = directory; // a directory that was moved is watched under its new path
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+        const auto& path = it->path();
+        std::error_code entryEc;
+        if (it->is_directory(entryEc)) {
+            if (wantsDirectory(path)) {
+                watchDirectory(path, collectFiles, visited);
+            }
+        } else if (collectFiles && it->is_regular_file(entryEc) && wantsFile(path)) {
+            m_changed.insert(path);
+        }
+    }
+}
+
+void FileWatcher::rescan()
+{
+    std::unordered_set<int> visited;
+    for (const auto& target : m_targets) {
+        watchDirectory(target.directory, true, visited);
+    }
+}
+
+std::optional<std::vector<std::filesystem::path>> FileWatcher::waitForChanges(std::chrono::milliseconds debounce, const std::function<bool()>& shouldStop)
+{
+    constexpr std::chrono::milliseconds kPollInterval(250);
+    auto lastEvent = std::chrono::steady_clock::now();
+    while (!shouldStop()) {
+        auto timeout = kPollInterval;
+        if (!m_changed.empty()) {
+            const auto quiet = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - lastEvent);
+            if (quiet >= debounce) {
+                std::vector<std::filesystem::path> changed;
+                for (const auto& path : m_changed) {
+                    std::error_code ec;
+                    if (std::filesystem::is_regular_file(path, ec)) { // not a temporary file that was renamed or deleted since
+                        changed.push_back(path);
+                    }
+                }
+                m_changed.clear();
+                if (!changed.empty()) {
+                    return changed;
+                }
+                continue;
+            }
+            timeout = std::min(timeout, debounce - quiet);
+        }
+        pollfd pending{ m_fd, POLLIN, 0 };
+        if (::poll(&pending, 1, static_cast<int>(timeout.count())) > 0 && readEvents()) {
+            lastEvent = std::chrono::steady_clock::now();
+        }
+    }
+    return std::nullopt;
+}
+
+bool FileWatcher::readEvents()
+{
+    alignas(inotify_event) char buffer[64 * 1024];
+    bool anyEvents = false;
+    while (true) {
+        const ssize_t length = ::read(m_fd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break; // EAGAIN once the queue is drained
+        }
+        for (const char* next = buffer; next < buffer + length; ) {
+            const auto* event = reinterpret_cast<const inotify_event*>(next);
+            next += sizeof(inotify_event) + event->len;
+            handleEvent(event->wd, event->mask, event->len ? std::string_view(event->name) : std::string_view());
+            anyEvents = true;
+        }
+    }
+    return anyEvents;
+}
+
+void FileWatcher::handleEvent(int wd, std::uint32_t mask, std::string_view name)
+{
+    if (mask & IN_Q_OVERFLOW) {
+        rescan();
+        return;
+    }
+    if (mask & IN_IGNORED) {
+        m_directories.erase(wd); // the directory was deleted
+        return;
+    }
+    const auto directory = m_directories.find(wd);
+    if (directory == m_directories.end() || name.empty()) {
+        return;
+    }
+    const auto path = directory->second / name;
+    if (mask & IN_ISDIR) {
+        if (wantsDirectory(path)) {
+            std::unordered_set<int> visited;
+            watchDirectory(path, true, visited); // files may have been written to it before the watch was added
+        }
+    } else if (wantsFile(path)) {
+        m_changed.insert(path);
+    }
+}
+
+#else
+
+FileWatcher::FileWatcher(std::vector<InputTarget> targets)
+    : m_targets(std::move(targets))
+{
+    throw std::runtime_error("--watch is not supported on this platform");
+}
+
+FileWatcher::~FileWatcher() = default;
+
+std::optional<std::vector<std::filesystem::path>> FileWatcher::waitForChanges(std::chrono::milliseconds, const std::function<bool()>&)
+{
+    return std::nullopt;
+}
+
+#endif
+
+void watchInputPatterns(const std::vector<std::filesystem::path>& inputPatterns, MnxValidateContext& context, int argc, arg_char* argv[])
+{
+    if (std::find(inputPatterns.begin(), inputPatterns.end(), std::filesystem::path("-")) != inputPatterns.end()) {
+        throw std::invalid_argument("stdin streams cannot be watched");
+    }
+    if (std::any_of(inputPatterns.begin(), inputPatterns.end(), [](const std::filesystem::path& pattern) {
+            return ArchiveReader::isArchivePath(pattern) || ArchiveReader::splitEntryPath(pattern);
+        })) {
+        throw std::invalid_argument("archives cannot be watched");
+    }
+    watchStopRequested = 0;
+    std::signal(SIGINT, handleWatchStopSignal);
+    std::signal(SIGTERM, handleWatchStopSignal);
+
+    std::vector<InputTarget> targets;
+    processInputPatterns(inputPatterns, context, argc, argv, &targets);
+    FileWatcher watcher(std::move(targets));
+    auto logErrors = [&]() {
+        for (const auto& error : watcher.takeErrors()) {
+            context.logMessage(LogMsg() << error, LogSeverity::Error);
+        }
+    };
+    logErrors();
+    context.logMessage(LogMsg() << "Watching for changes. Press Ctrl+C to stop.");
+    context.flushLog();
+    while (auto changed = watcher.waitForChanges(context.watchDebounce, []() { return watchStopRequested != 0; })) {
+        logErrors();
+        context.logMessage(LogMsg() << "Revalidating " << changed->size() << " changed file" << (changed->size() == 1 ? "" : "s") << ".");
+        context.stopRequested = false; // --fail-fast ends a pass, not the watch
+        context.processFiles(changed.value());
+        context.flushLog();
+    }
+
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+}
+
+} // namespace mnxvalidate
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <string>
+#include <string_view>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+
+#include "globpattern.h"
+
+namespace mnxvalidate {
+
+/// @brief The files that one input pattern resolved to, kept so that --watch can tell which changed files are inputs
+struct InputTarget
+{
+    std::filesystem::path directory;        ///< the directory that is searched, absolute and lexically normal
+    std::optional<GlobPattern> pattern;     ///< the files below #directory that are inputs, unless the input is one file
+    std::filesystem::path file;             ///< the input, if it is one file
+
+    /// @brief True if the file at @p path is one of the inputs
+    bool wantsFile(const std::filesystem::path& path) const;
+
+    /// @brief True if a file at @p relativePath below #directory, or in an archive, is an input that the pattern matches
+    bool wantsRelativePath(const std::filesystem::path& relativePath) const;
+
+    /// @brief False if nothing inside the directory at @p path, however deep, can be an input
+    bool wantsDirectory(const std::filesystem::path& path) const;
+
+    /// @brief True if inputs can be in subdirectories of #directory
+    bool spansDirectories() const { return pattern && pattern->spansDirectories(); }
+};
+
+/**
+ * @brief Reports input files that are created or modified, using inotify.
+ *
+ * Every directory that may hold an input is watched, and directories created later are watched as they appear.
+ * Changes are collected until no event has arrived for the debounce interval, so an editor that saves by writing
+ * a temporary file and renaming it over the original causes one revalidation rather than several.
+ *
+ * Only Linux is supported. Elsewhere the constructor throws.
+ */
+class FileWatcher
+{
+public:
+    /// @throws std::runtime_error if changes cannot be watched
+    explicit FileWatcher(std::vector<InputTarget> targets);
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * @brief Waits until inputs have changed and the tree has been quiet for @p debounce.
+     * @param shouldStop polled while waiting, at least four times a second
+     * @return the changed inputs that still exist, in sorted order, or std::nullopt if @p shouldStop returned true
+     */
+    std::optional<std::vector<std::filesystem::path>> waitForChanges(std::chrono::milliseconds debounce, const std::function<bool()>& shouldStop);
+
+    /// @brief Returns and clears the directories that could not be watched, one message each
+    std::vector<std::string> takeErrors();
+
+private:
+    bool wantsFile(const std::filesystem::path& path) const;
+    bool wantsDirectory(const std::filesystem::path& path) const;
+
+    /// @brief Watches @p directory and every subdirectory that may hold inputs. Files already in them are changes if @p collectFiles.
+    void watchDirectory(const std::filesystem::path& directory, bool collectFiles, std::unordered_set<int>& visited);
+    void rescan(); ///< Rewatches every target and treats all of their inputs as changed, because events were lost
+    bool readEvents(); ///< Handles every event that is waiting and returns true if there were any
+    void handleEvent(int wd, std::uint32_t mask, std::string_view name);
+
+    const std::vector<InputTarget> m_targets;
+    int m_fd{ -1 };
+    std::unordered_map<int, std::filesystem::path> m_directories;   ///< by watch descriptor
+    std::set<std::filesystem::path> m_changed;
+    std::vector<std::string> m_errors;
+};
+
+} // namespace mnxvalidate
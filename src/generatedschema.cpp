@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <algorithm>
+#include <cmath>
+
+#include "generatedschema.h"
+
+namespace mnxvalidate::generated {
+
+namespace {
+
+// Thrown to abandon validation at the error limit. It is not a std::exception, so nothing mistakes it for another error.
+struct ErrorLimitReached {};
+
+} // namespace
+
+bool Context::error(std::string message)
+{
+    errors.push_back({ pointer(), std::move(message) });
+    if (m_maxErrors && errors.size() >= m_maxErrors) {
+        throw ErrorLimitReached();
+    }
+    return false;
+}
+
+std::string Context::pointer() const
+{
+    std::string result;
+    for (const auto& token : m_path) {
+        result += '/';
+        if (!token.isKey) {
+            result += std::to_string(token.index);
+            continue;
+        }
+        for (const char c : token.key) {
+            if (c == '~') {
+                result += "~0";
+            } else if (c == '/') {
+                result += "~1";
+            } else {
+                result += c;
+            }
+        }
+    }
+    return result;
+}
+
+SchemaFunction findProperty(std::span<const Property> properties, std::string_view name)
+{
+    const auto it = std::lower_bound(properties.begin(), properties.end(), name,
+        [](const Property& property, std::string_view value) { return property.name < value; });
+    return it != properties.end() && it->name == name ? it->validate : nullptr;
+}
+
+bool containsString(std::span<const std::string_view> values, std::string_view value)
+{
+    return std::binary_search(values.begin(), values.end(), value);
+}
+
+bool isIntegral(const nlohmann::json& number)
+{
+    if (!number.is_number_float()) {
+        return number.is_number();
+    }
+    const double value = number.get<double>();
+    return std::isfinite(value) && value == std::floor(value);
+}
+
+bool isMultipleOf(double number, double divisor)
+{
+    const double remainder = std::remainder(number, divisor);
+    const double epsilon = std::nextafter(number, 0) - number;
+    return std::fabs(remainder) <= std::fabs(epsilon);
+}
+
+SchemaValidationResult validate(const nlohmann::json& document, size_t maxErrors)
+{
+    Context context(maxErrors);
+    bool truncated = false;
+    try {
+        validateDocument(document, context);
+    } catch (const ErrorLimitReached&) {
+        truncated = true;
+    }
+    return { std::move(context.errors), truncated };
+}
+
+} // namespace mnxvalidate::generated
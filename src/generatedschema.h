@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <cstdint>
+
+#include "nlohmann/json.hpp"
+#include "schemavalidator.h"
+#include "utils/schemautils.h"
+
+/**
+ * @brief The validator that `mnxschemagen` generates from the embedded MNX schema when the project is built.
+ *
+ * Each subschema becomes a function that switches on the type of the instance and checks its keywords directly.
+ * Property names are looked up in sorted constexpr tables, and `$ref`s are resolved by the generator, so nothing
+ * is interpreted at run time. It reports the same documents invalid as the generic validator. #SchemaValidator uses it
+ * for the embedded schema, and the generic validator for any other.
+ */
+namespace mnxvalidate::generated {
+
+/// @brief False if the generator could not handle the embedded schema, in which case #unavailableReason says why
+bool isAvailable();
+
+/// @brief Why #isAvailable is false, for logging
+std::string_view unavailableReason();
+
+/**
+ * @brief Validates a document against the embedded schema. Requires #isAvailable. Safe to call from multiple threads at once.
+ * @param document the document to validate
+ * @param maxErrors stop validating once this many errors have been found (0 means no limit)
+ */
+SchemaValidationResult validate(const nlohmann::json& document, size_t maxErrors = 0);
+
+// The rest is used by the generated code.
+
+/// @brief The errors of one validation and the json pointer of the instance being checked
+class Context
+{
+public:
+    explicit Context(size_t maxErrors) : m_maxErrors(maxErrors) {}
+
+    std::vector<SchemaError> errors;
+
+    void push(std::string_view key) { m_path.push_back({ key, 0, true }); }
+    void push(size_t index) { m_path.push_back({ {}, index, false }); }
+    void pop() { m_path.pop_back(); }
+
+    /// @brief Records an error at the current instance and returns false. Throws to stop at the error limit.
+    bool error(std::string message);
+
+    /// @brief Checks a subschema whose errors are not reported, for combinators
+    template <typename Function>
+    bool matches(Function function, const nlohmann::json& instance)
+    {
+        // a function that does not report returns at its first failure, without popping what it pushed
+        const size_t depth = m_path.size();
+        const bool result = function(instance, *this, false);
+        m_path.resize(depth);
+        return result;
+    }
+
+private:
+    struct Token
+    {
+        std::string_view key;
+        size_t index{};
+        bool isKey{};           ///< a property name rather than an item index
+    };
+
+    std::string pointer() const;
+
+    std::vector<Token> m_path;
+    const size_t m_maxErrors;
+};
+
+/// @brief A generated subschema function
+using SchemaFunction = bool (*)(const nlohmann::json& instance, Context& context, bool reports);
+
+struct Property
+{
+    std::string_view name;
+    SchemaFunction validate;
+};
+
+/// @brief Finds a property's subschema in a table sorted by name, or returns nullptr
+SchemaFunction findProperty(std::span<const Property> properties, std::string_view name);
+
+/// @brief True if a string is one of the entries of a sorted table
+bool containsString(std::span<const std::string_view> values, std::string_view value);
+
+/// @brief The number of code points in utf-8 text, for minLength and maxLength
+using utils::utf8Length;
+
+/// @brief True if a number has no fractional part, so that it can be an `integer`
+bool isIntegral(const nlohmann::json& number);
+
+/// @brief Checks the instance against the multipleOf keyword, with the tolerance of the generic validator
+bool isMultipleOf(double number, double divisor);
+
+/// @brief Validates the document against the root schema. Generated.
+bool validateDocument(const nlohmann::json& document, Context& context);
+
+} // namespace mnxvalidate::generated
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+// Compiled in place of the generated validator when cross-compiling without a host-built mnxschemagen (see
+// MNXSCHEMAGEN_EXECUTABLE in CMakeLists.txt), so that the generic validator checks the embedded schema instead.
+
+#include <string_view>
+#include <stdexcept>
+
+#include "generatedschema.h"
+
+namespace mnxvalidate::generated {
+
+bool isAvailable() { return false; }
+
+std::string_view unavailableReason()
+{
+    return "this build was cross-compiled without a host-built mnxschemagen";
+}
+
+bool validateDocument(const nlohmann::json&, Context&)
+{
+    throw std::logic_error("No validator was generated for the embedded schema.");
+}
+
+} // namespace mnxvalidate::generated
@@ -0,0 +1,376 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <algorithm>
+#include <stdexcept>
+
+#include "globpattern.h"
+
+namespace mnxvalidate {
+
+namespace {
+
+using Char = std::filesystem::path::value_type;
+using StringView = GlobPattern::StringView;
+using String = GlobPattern::String;
+
+// Enough for any pattern typed by hand, while a runaway set of nested braces fails quickly
+constexpr size_t kMaxAlternatives = 1024;
+
+#ifdef _WIN32
+bool isSeparator(Char c) { return c == L'/' || c == L'\\'; }
+bool isEscape(Char) { return false; }
+#else
+bool isSeparator(Char c) { return c == '/'; }
+bool isEscape(Char c) { return c == '\\'; }
+#endif
+
+StringView skipSeparators(StringView text)
+{
+    size_t pos = 0;
+    while (pos < text.size() && isSeparator(text[pos])) {
+        pos++;
+    }
+    return text.substr(pos);
+}
+
+size_t findSeparator(StringView text)
+{
+    for (size_t pos = 0; pos < text.size(); pos++) {
+        if (isSeparator(text[pos])) {
+            return pos;
+        }
+    }
+    return StringView::npos;
+}
+
+// Returns the position of the `]` that closes the set opening at @p open, or npos if there is none.
+size_t classEnd(StringView text, size_t open)
+{
+    size_t pos = open + 1;
+    if (pos < text.size() && (text[pos] == Char('!') || text[pos] == Char('^'))) {
+        pos++;
+    }
+    if (pos < text.size() && text[pos] == Char(']')) {
+        pos++; // a leading `]` is a member of the set
+    }
+    for (; pos < text.size(); pos++) {
+        if (isSeparator(text[pos])) {
+            return StringView::npos;
+        }
+        if (isEscape(text[pos])) {
+            pos++;
+        } else if (text[pos] == Char(']')) {
+            return pos;
+        }
+    }
+    return StringView::npos;
+}
+
+// Expands the first brace group that has a comma, then expands each result the same way.
+void expandBraces(StringView text, std::vector<String>& result)
+{
+    for (size_t pos = 0; pos < text.size(); pos++) {
+        if (isEscape(text[pos])) {
+            pos++;
+            continue;
+        }
+        if (text[pos] == Char('[')) {
+            if (const size_t end = classEnd(text, pos); end != StringView::npos) {
+                pos = end;
+            }
+            continue;
+        }
+        if (text[pos] != Char('{')) {
+            continue;
+        }
+        std::vector<size_t> boundaries;
+        size_t depth = 0;
+        size_t close = StringView::npos;
+        for (size_t inner = pos + 1; inner < text.size() && close == StringView::npos; inner++) {
+            const Char c = text[inner];
+            if (isEscape(c)) {
+                inner++;
+            } else if (c == Char('[')) {
+                if (const size_t end = classEnd(text, inner); end != StringView::npos) {
+                    inner = end;
+                }
+            } else if (c == Char('{')) {
+                depth++;
+            } else if (c == Char('}')) {
+                if (depth == 0) {
+                    close = inner;
+                } else {
+                    depth--;
+                }
+            } else if (c == Char(',') && depth == 0) {
+                boundaries.push_back(inner);
+            }
+        }
+        if (close == StringView::npos || boundaries.empty()) {
+            continue; // literal, but braces inside it may still expand
+        }
+        boundaries.push_back(close);
+        const StringView prefix = text.substr(0, pos);
+        const StringView suffix = text.substr(close + 1);
+        size_t start = pos + 1;
+        for (const size_t boundary : boundaries) {
+            String expanded(prefix);
+            expanded += text.substr(start, boundary - start);
+            expanded += suffix;
+            expandBraces(expanded, result);
+            start = boundary + 1;
+        }
+        return;
+    }
+    if (result.size() >= kMaxAlternatives) {
+        throw std::invalid_argument("Wildcard pattern expands to more than " + std::to_string(kMaxAlternatives) + " alternatives.");
+    }
+    result.emplace_back(text);
+}
+
+} // namespace
+
+GlobPattern::GlobPattern(StringView pattern, bool anyDepth)
+{
+    compile(pattern, anyDepth);
+}
+
+bool GlobPattern::hasWildcards(StringView text)
+{
+    return std::any_of(text.begin(), text.end(), [](Char c) {
+        return c == Char('*') || c == Char('?') || c == Char('[') || c == Char('{');
+    });
+}
+
+std::pair<std::filesystem::path, GlobPattern::String> GlobPattern::splitBase(const std::filesystem::path& path)
+{
+    std::filesystem::path base;
+    std::filesystem::path pattern;
+    for (const auto& component : path) {
+        if (pattern.empty() && !hasWildcards(component.native())) {
+            base /= component;
+        } else {
+            pattern /= component;
+        }
+    }
+    return { base, pattern.native() };
+}
+
+void GlobPattern::compile(StringView pattern, bool anyDepth)
+{
+    std::vector<String> expanded;
+    expandBraces(pattern, expanded);
+    for (const StringView text : expanded) {
+        Alternative alternative;
+        size_t start = 0;
+        for (size_t pos = 0; ; pos++) {
+            if (pos + 1 < text.size() && isEscape(text[pos])) {
+                pos++;
+                continue;
+            }
+            if (pos == text.size() || isSeparator(text[pos])) {
+                if (pos > start) {
+                    alternative.push_back(compileSegment(text.substr(start, pos - start)));
+                }
+                if (pos == text.size()) {
+                    break;
+                }
+                start = pos + 1;
+            }
+        }
+        if (anyDepth && !alternative.empty() && !alternative.back().globstar
+            && (alternative.size() < 2 || !alternative[alternative.size() - 2].globstar)) {
+            alternative.insert(alternative.end() - 1, Segment{ true, {}, {} });
+        }
+        if (alternative.size() > 1 || (alternative.size() == 1 && alternative.front().globstar)) {
+            m_spansDirectories = true;
+        }
+        m_alternatives.push_back(std::move(alternative));
+    }
+}
+
+GlobPattern::Segment GlobPattern::compileSegment(StringView text)
+{
+    Segment segment;
+    if (text.size() == 2 && text[0] == Char('*') && text[1] == Char('*')) {
+        segment.globstar = true;
+        return segment;
+    }
+    for (size_t pos = 0; pos < text.size(); pos++) {
+        const Char c = text[pos];
+        if (isEscape(c) && pos + 1 < text.size()) {
+            segment.tokens.push_back({ Token::Kind::Literal, text[++pos] });
+        } else if (c == Char('*')) {
+            if (segment.tokens.empty() || segment.tokens.back().kind != Token::Kind::AnyString) {
+                segment.tokens.push_back({ Token::Kind::AnyString });
+            }
+        } else if (c == Char('?')) {
+            segment.tokens.push_back({ Token::Kind::AnyChar });
+        } else if (const size_t end = c == Char('[') ? classEnd(text, pos) : StringView::npos; end != StringView::npos) {
+            CharClass charClass;
+            size_t member = pos + 1;
+            if (text[member] == Char('!') || text[member] == Char('^')) {
+                charClass.negated = true;
+                member++;
+            }
+            while (member < end) {
+                if (isEscape(text[member]) && member + 1 < end) {
+                    member++;
+                }
+                const Char low = text[member++];
+                Char high = low;
+                if (member + 1 < end && text[member] == Char('-')) { // a `-` just before `]` is a member
+                    member++;
+                    if (isEscape(text[member]) && member + 1 < end) {
+                        member++;
+                    }
+                    high = text[member++];
+                }
+                charClass.ranges.emplace_back(low, high);
+            }
+            segment.tokens.push_back({ Token::Kind::Class, {}, m_classes.size() });
+            m_classes.push_back(std::move(charClass));
+            pos = end;
+        } else {
+            segment.tokens.push_back({ Token::Kind::Literal, c });
+        }
+    }
+    for (auto it = segment.tokens.rbegin(); it != segment.tokens.rend() && it->kind == Token::Kind::Literal; ++it) {
+        segment.literalSuffix.insert(segment.literalSuffix.begin(), it->ch);
+    }
+    return segment;
+}
+
+// The literal suffix has to be at the very end of the name, so only the tokens before it are matched, with the
+// usual two-position wildcard match: on a mismatch, the most recent `*` takes one more character and the match
+// resumes after it. Earlier stars never need to take more, so this is linear for most patterns.
+bool GlobPattern::matchSegment(const Segment& segment, StringView name) const
+{
+    if (!name.ends_with(segment.literalSuffix)) {
+        return false;
+    }
+    name.remove_suffix(segment.literalSuffix.size());
+    const auto& tokens = segment.tokens;
+    const size_t tokenCount = tokens.size() - segment.literalSuffix.size();
+    auto matchesOne = [&](const Token& token, Char c) {
+        switch (token.kind) {
+            case Token::Kind::Literal:
+                return c == token.ch;
+            case Token::Kind::AnyChar:
+                return true;
+            case Token::Kind::Class: {
+                const auto& charClass = m_classes[token.classIndex];
+                const bool inRange = std::any_of(charClass.ranges.begin(), charClass.ranges.end(),
+                    [c](const auto& range) { return c >= range.first && c <= range.second; });
+                return inRange != charClass.negated;
+            }
+            default:
+                return false;
+        }
+    };
+    size_t tokenIndex = 0;
+    size_t nameIndex = 0;
+    size_t starToken = tokenCount;
+    size_t starName = 0;
+    while (nameIndex < name.size()) {
+        if (tokenIndex < tokenCount && tokens[tokenIndex].kind == Token::Kind::AnyString) {
+            starToken = tokenIndex++;
+            starName = nameIndex;
+        } else if (tokenIndex < tokenCount && matchesOne(tokens[tokenIndex], name[nameIndex])) {
+            tokenIndex++;
+            nameIndex++;
+        } else if (starToken < tokenCount) {
+            tokenIndex = starToken + 1;
+            nameIndex = ++starName;
+        } else {
+            return false;
+        }
+    }
+    while (tokenIndex < tokenCount && tokens[tokenIndex].kind == Token::Kind::AnyString) {
+        tokenIndex++;
+    }
+    return tokenIndex == tokenCount;
+}
+
+bool GlobPattern::matchFrom(const Alternative& alternative, size_t index, StringView rest) const
+{
+    rest = skipSeparators(rest);
+    if (index == alternative.size()) {
+        return rest.empty();
+    }
+    if (alternative[index].globstar) {
+        if (index + 1 == alternative.size()) {
+            return !rest.empty(); // a trailing `**` matches everything below, files included
+        }
+        while (true) {
+            if (matchFrom(alternative, index + 1, rest)) {
+                return true;
+            }
+            const size_t separator = findSeparator(rest);
+            if (separator == StringView::npos) {
+                return false;
+            }
+            rest = skipSeparators(rest.substr(separator));
+        }
+    }
+    if (rest.empty()) {
+        return false;
+    }
+    const size_t separator = findSeparator(rest);
+    if (!matchSegment(alternative[index], rest.substr(0, separator))) {
+        return false;
+    }
+    return matchFrom(alternative, index + 1, separator == StringView::npos ? StringView() : rest.substr(separator));
+}
+
+bool GlobPattern::mayMatchFrom(const Alternative& alternative, size_t index, StringView rest) const
+{
+    rest = skipSeparators(rest);
+    if (rest.empty()) {
+        return index < alternative.size(); // something inside the directory is still needed
+    }
+    if (index == alternative.size()) {
+        return false;
+    }
+    if (alternative[index].globstar) {
+        return true; // it can take the whole directory path
+    }
+    const size_t separator = findSeparator(rest);
+    if (!matchSegment(alternative[index], rest.substr(0, separator))) {
+        return false;
+    }
+    return mayMatchFrom(alternative, index + 1, separator == StringView::npos ? StringView() : rest.substr(separator));
+}
+
+bool GlobPattern::matches(StringView relativePath) const
+{
+    return std::any_of(m_alternatives.begin(), m_alternatives.end(),
+        [&](const Alternative& alternative) { return matchFrom(alternative, 0, relativePath); });
+}
+
+bool GlobPattern::mayMatchBelow(StringView relativePath) const
+{
+    return std::any_of(m_alternatives.begin(), m_alternatives.end(),
+        [&](const Alternative& alternative) { return mayMatchFrom(alternative, 0, relativePath); });
+}
+
+} // namespace mnxvalidate
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <filesystem>
+
+namespace mnxvalidate {
+
+/**
+ * @brief A wildcard pattern compiled once and matched against paths relative to the directory it is searched from.
+ *
+ * - `*` matches any run of characters within one path component, and `?` matches one character.
+ * - `[abc]`, `[a-z]` and `[!a-z]` (or `[^a-z]`) match one character from (or not from) a set.
+ * - `{a,b}` matches either alternative. Alternatives may hold wildcards, separators and further braces.
+ * - A component that is exactly `**` matches zero or more whole directories. At the end of a pattern it matches everything below.
+ *
+ * Matching is case-sensitive and works on native path characters, so on POSIX `?` matches one byte of a
+ * UTF-8 name. On POSIX a backslash makes the next character literal. On Windows it is a separator.
+ * A `[` or `{` without its closing bracket is literal.
+ */
+class GlobPattern
+{
+public:
+    using String = std::filesystem::path::string_type;
+    using StringView = std::basic_string_view<std::filesystem::path::value_type>;
+
+    /**
+     * @brief Compiles a pattern
+     * @param pattern the pattern, relative to the directory that will be searched
+     * @param anyDepth if true, the last component may also match in any subdirectory (as with --recursive)
+     * @throws std::invalid_argument if the braces expand to too many alternatives
+     */
+    explicit GlobPattern(StringView pattern, bool anyDepth = false);
+
+    /// @brief True if the text has any character with a special meaning in a pattern
+    static bool hasWildcards(StringView text);
+
+    /**
+     * @brief Splits a path into its leading components that have no wildcards and the pattern that follows them.
+     * @return the directory to search and the pattern relative to it. The pattern is empty if @p path has no wildcards.
+     */
+    static std::pair<std::filesystem::path, String> splitBase(const std::filesystem::path& path);
+
+    /// @brief True if a file at @p relativePath matches
+    bool matches(StringView relativePath) const;
+
+    /// @brief False if nothing inside the directory at @p relativePath, however deep, can match
+    bool mayMatchBelow(StringView relativePath) const;
+
+    /// @brief True if matches can be in subdirectories of the searched directory
+    bool spansDirectories() const { return m_spansDirectories; }
+
+private:
+    struct CharClass
+    {
+        bool negated{};
+        std::vector<std::pair<std::filesystem::path::value_type, std::filesystem::path::value_type>> ranges;
+    };
+
+    struct Token
+    {
+        enum class Kind { Literal, AnyChar, AnyString, Class };
+        Kind kind;
+        std::filesystem::path::value_type ch{};    ///< the character, for Kind::Literal
+        size_t classIndex{};                        ///< into #m_classes, for Kind::Class
+    };
+
+    struct Segment
+    {
+        bool globstar{};            ///< `**`, which matches whole directories and has no tokens
+        std::vector<Token> tokens;
+        String literalSuffix;       ///< the literal characters after the last `*`, which rule out most names cheaply
+    };
+
+    using Alternative = std::vector<Segment>;
+
+    void compile(StringView pattern, bool anyDepth);
+    Segment compileSegment(StringView text);
+    bool matchSegment(const Segment& segment, StringView name) const;
+    bool matchFrom(const Alternative& alternative, size_t index, StringView rest) const;
+    bool mayMatchFrom(const Alternative& alternative, size_t index, StringView rest) const;
+
+    std::vector<Alternative> m_alternatives;   ///< one per brace expansion
+    std::vector<CharClass> m_classes;
+    bool m_spansDirectories{};
+};
+
+} // namespace mnxvalidate
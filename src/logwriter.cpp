@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <exception>
+
+#include "logwriter.h"
+#include "mnxvalidate.h"
+
+namespace mnxvalidate {
+
+namespace {
+constexpr size_t MAX_BATCH_BYTES = 64 * 1024; ///< write a batch out early once it reaches this size
+} // namespace
+
+LogWriter::LogWriter(ConsoleWriter consoleWriter)
+    : m_consoleWriter(std::move(consoleWriter)),
+      m_queue(std::make_unique<utils::SpscQueue<Record, 4096>>()),
+      m_thread([this]() { run(); })
+{
+}
+
+LogWriter::~LogWriter()
+{
+    m_queue->push(Record{ .kind = Record::Kind::Stop });
+    m_thread.join();
+}
+
+void LogWriter::setLogFile(std::shared_ptr<std::ostream> logFile)
+{
+    m_queue->push(Record{ .kind = Record::Kind::SetLogFile, .logFile = std::move(logFile) });
+}
+
+void LogWriter::writeToLogFile(std::string line)
+{
+    m_queue->push(Record{ .kind = Record::Kind::LogFileLine, .text = std::move(line) });
+}
+
+void LogWriter::writeToConsole(std::string line)
+{
+    m_queue->push(Record{ .kind = Record::Kind::ConsoleLine, .text = std::move(line) });
+}
+
+void LogWriter::flush()
+{
+    m_queue->push(Record{ .kind = Record::Kind::Flush });
+}
+
+void LogWriter::sync()
+{
+    const std::uint64_t syncId = ++m_lastSyncId;
+    m_queue->push(Record{ .kind = Record::Kind::Flush, .syncId = syncId });
+    std::uint64_t completed = m_completedSyncId.load(std::memory_order_acquire);
+    while (completed < syncId) {
+        m_completedSyncId.wait(completed, std::memory_order_acquire);
+        completed = m_completedSyncId.load(std::memory_order_acquire);
+    }
+}
+
+const std::string& LogWriter::timeStamp()
+{
+    const std::time_t now = std::time(nullptr);
+    if (now != m_timeStampSecond) {
+        m_timeStamp = getTimeStamp("%Y-%m-%d %H:%M:%S");
+        m_timeStampSecond = now;
+    }
+    return m_timeStamp;
+}
+
+void LogWriter::run()
+{
+    Record record;
+    while (true) {
+        if (!m_queue->tryPop(record)) {
+            // nothing else is waiting, so hand what we have to the streams before sleeping
+            writeBatches();
+            m_queue->waitWhileEmpty();
+            continue;
+        }
+        switch (record.kind) {
+        case Record::Kind::LogFileLine:
+            m_logFileBatch += record.text;
+            break;
+        case Record::Kind::ConsoleLine:
+            m_consoleBatch += record.text;
+            break;
+        case Record::Kind::SetLogFile:
+            writeBatches();
+            flushStreams();
+            m_logFile = std::move(record.logFile);
+            break;
+        case Record::Kind::Flush:
+            writeBatches();
+            flushStreams();
+            if (record.syncId) {
+                m_completedSyncId.store(record.syncId, std::memory_order_release);
+                m_completedSyncId.notify_all();
+            }
+            break;
+        case Record::Kind::Stop:
+            writeBatches();
+            flushStreams();
+            m_logFile.reset();
+            return;
+        }
+        if (m_logFileBatch.size() >= MAX_BATCH_BYTES || m_consoleBatch.size() >= MAX_BATCH_BYTES) {
+            writeBatches();
+        }
+    }
+}
+
+void LogWriter::writeBatches()
+{
+    if (!m_logFileBatch.empty()) {
+        if (m_logFile) {
+            try {
+                m_logFile->write(m_logFileBatch.data(), static_cast<std::streamsize>(m_logFileBatch.size()));
+            } catch (const std::exception& e) {
+                // there is nobody to throw to on this thread, so report it where it can be seen and stop logging to the file
+                m_consoleBatch += std::string("Unable to write to the log file: ") + e.what() + '\n';
+                m_logFile.reset();
+            }
+        }
+        m_logFileBatch.clear();
+    }
+    if (!m_consoleBatch.empty()) {
+        m_consoleWriter(m_consoleBatch);
+        m_consoleBatch.clear();
+    }
+}
+
+void LogWriter::flushStreams()
+{
+    if (m_logFile) {
+        try {
+            m_logFile->flush();
+        } catch (const std::exception& e) {
+            m_consoleWriter(std::string("Unable to write to the log file: ") + e.what() + '\n');
+            m_logFile.reset();
+        }
+    }
+}
+
+} // namespace mnxvalidate
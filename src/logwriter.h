@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <string>
+#include <memory>
+#include <ostream>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <ctime>
+#include <cstdint>
+
+#include "utils/spscqueue.h"
+
+namespace mnxvalidate {
+
+/**
+ * @brief Writes log lines on a dedicated thread so that validation never waits on the console or the log file.
+ *
+ * Lines are handed over through a lock-free queue, and the writer thread coalesces everything that is waiting
+ * into one write per destination. Streams are only flushed when #flush or #sync asks for it, so the caller
+ * decides where the flush points are (file boundaries and errors).
+ *
+ * All members except the destructor must be called from one thread at a time, which is the thread that
+ * writes the log.
+ */
+class LogWriter
+{
+public:
+    /// @brief Writes a batch of one or more complete lines to the console
+    using ConsoleWriter = std::function<void(const std::string& lines)>;
+
+    explicit LogWriter(ConsoleWriter consoleWriter);
+    ~LogWriter(); ///< Writes and flushes everything still queued
+
+    LogWriter(const LogWriter&) = delete;
+    LogWriter& operator=(const LogWriter&) = delete;
+
+    /// @brief Sends subsequent log file lines to @p logFile, or discards them if it is null
+    void setLogFile(std::shared_ptr<std::ostream> logFile);
+
+    void writeToLogFile(std::string line);    ///< Queues a line for the log file. The line must end with '\n'.
+    void writeToConsole(std::string line);    ///< Queues a line for the console. The line must end with '\n'.
+
+    void flush();   ///< Flushes the streams once everything queued so far is written, without waiting for it
+    void sync();    ///< Waits until everything queued so far is written and flushed
+
+    /// @brief The current local time formatted for a log line. The text is only reformatted when the second changes.
+    const std::string& timeStamp();
+
+private:
+    struct Record
+    {
+        enum class Kind { LogFileLine, ConsoleLine, SetLogFile, Flush, Stop };
+
+        Kind kind{};
+        std::string text{};
+        std::shared_ptr<std::ostream> logFile{};
+        std::uint64_t syncId{};
+    };
+
+    void run();
+    void writeBatches();
+    void flushStreams();
+
+    ConsoleWriter m_consoleWriter;
+    std::shared_ptr<std::ostream> m_logFile;    ///< only used by the writer thread
+    std::string m_logFileBatch;
+    std::string m_consoleBatch;
+
+    std::unique_ptr<utils::SpscQueue<Record, 4096>> m_queue;
+    std::uint64_t m_lastSyncId{};               ///< only used by the producer
+    std::atomic<std::uint64_t> m_completedSyncId{};
+
+    std::time_t m_timeStampSecond{ -1 };
+    std::string m_timeStamp;
+
+    std::thread m_thread;
+};
+
+} // namespace mnxvalidate
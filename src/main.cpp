@@ -23,10 +23,24 @@
 #include <optional>
 #include <memory>
 #include <chrono>
-#include <regex>
+#include <tuple>
 #include <unordered_set>
+#include <iomanip>
+#include <array>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
 
 #include "mnxvalidate.h"
+#include "documentstream.h"
+#include "timingstats.h"
+#include "directorywalker.h"
+#include "globpattern.h"
+#include "filewatcher.h"
+#include "archivereader.h"
 #include "utils/stringutils.h"
 
 namespace {
@@ -58,14 +72,44 @@ static int showHelpPage(const std::string_view& programName)
     // General options
     std::cout << "General options:" << std::endl;
     std::cout << "  --about                         Show acknowledgements and exit" << std::endl;
+    std::cout << "  --cache-dir <dir-path>          Reuse validation results for unchanged files from this cache directory" << std::endl;
+    std::cout << "  --cache-max-size <megabytes>    Trim the cache directory to this size at the end of the run (default: 512)" << std::endl;
+    std::cout << "  --error-summary                 Show the most frequent kinds of error across all files at the end of the run" << std::endl;
+    std::cout << "  --error-summary-top <count>     The number of error kinds listed by --error-summary (default: 10)" << std::endl;
+    std::cout << "  --fail-fast                     Stop at the first file that fails validation" << std::endl;
     std::cout << "  --help                          Show this help message and exit" << std::endl;
+    std::cout << "  --jobs <count>                  Validate up to this many files at once (default: number of usable CPUs)" << std::endl;
+    std::cout << "  --list-rules                    List the semantic rule groups and exit. With input files, also time each group on them." << std::endl;
+    std::cout << "  --max-errors <count>            Stop reporting errors for a file once this many have been found" << std::endl;
+    std::cout << "  --max-memory <megabytes>        Only start files while their estimated memory use fits; larger files run alone" << std::endl;
     std::cout << "  --recursive                     Recursively search subdirectories of the input directory" << std::endl;
+    std::cout << "  --report <file-path>            Also write a machine-readable report of every validated file" << std::endl;
+    std::cout << "  --report-format <format>        The report format: jsonl (default), sarif or junit" << std::endl;
+    std::cout << "  --rules <group,...>             Only check these semantic rule groups (see --list-rules)" << std::endl;
+    std::cout << "  --rules-file <file-path>        Read rule groups from this file: \"group\" as for --rules, \"-group\" as for --skip-rules" << std::endl;
     std::cout << "  --schema [file-path]            Validate against this json schema file rather than the embedded one." << std::endl;
     std::cout << "  --schema-only                   Only validate against the schema. Perform no other validation checks." << std::endl;
+    std::cout << "  --semantic-jobs <count>         Check the semantics of one large file on this many threads, 0 for one per CPU (default: 1)" << std::endl;
+    std::cout << "  --semantic-threshold <count>    Only split files with at least this many measures summed over their parts (default: "
+              << mnxvalidate::ValidatorOptions::kDefaultSemanticSplitThreshold << ")" << std::endl;
+    std::cout << "  --skip-rules <group,...>        Do not check these semantic rule groups" << std::endl;
+    std::cout << "  --stdin-stream                  Validate a stream of documents read from stdin (same as an input pattern of -)" << std::endl;
+    std::cout << "  --stdin-format <ndjson|framed>  ndjson: one document per line (default)" << std::endl;
+    std::cout << "                                  framed: each document follows a \"<byte-count> [<id>]\" line" << std::endl;
+    std::cout << "  --timings                       Show throughput and per-phase latency percentiles at the end of the run" << std::endl;
+    std::cout << "  --timings-slowest <count>       The number of slowest files listed by --timings (default: 10)" << std::endl;
     std::cout << "  --version                       Show program version and exit" << std::endl;
+    std::cout << "  --watch                         After validating the inputs, keep running and revalidate input files as they change" << std::endl;
+    std::cout << "  --watch-debounce <milliseconds> With --watch, wait until files have been quiet this long before revalidating (default: 200)" << std::endl;
     std::cout << std::endl;
 
     std::cout << std::endl;
+    std::cout << "Server options:" << std::endl;
+    std::cout << "  --serve <socket-path>           Keep running and validate requests sent to this Unix domain socket" << std::endl;
+    std::cout << "  --client <socket-path>          Have the server on this socket validate the inputs instead of this process" << std::endl;
+    std::cout << "  --stop                          With --client, stop the server" << std::endl;
+    std::cout << std::endl;
+
     std::cout << "By default, messages are sent to std::cerr." << std::endl;
     std::cout << std::endl;
     std::cout << "Logging options:" << std::endl;
@@ -74,6 +118,11 @@ static int showHelpPage(const std::string_view& programName)
     std::cout << "  --quiet                         Only display errors and warning messages (overrides --verbose)" << std::endl;
     std::cout << "  --verbose                       Verbose output" << std::endl;
     std::cout << std::endl;
+    std::cout << "Exits with 0 if every input is valid, " << EXIT_CODE_ERRORS << " if any input is not, and " << EXIT_CODE_TRUNCATED
+              << " if any input is not and --fail-fast or --max-errors cut the run short." << std::endl;
+    std::cout << "Inputs may be compressed with gzip (.mnx.gz) or zstd (.mnx.zst); they are decompressed as they are read." << std::endl;
+    std::cout << "A zip or tar archive (.zip, .tar, .tar.gz, .tgz, .tar.zst) is searched like a directory without extracting it." << std::endl;
+    std::cout << "Use <archive>!/<pattern> to select entries, such as scores.zip!/parts/*.mnx." << std::endl;
     std::cout << "Relative input patterns are resolved from the current working directory." << std::endl;
     std::cout << "Relative log paths for --log are resolved from the first input pattern's parent directory." << std::endl;
 
@@ -82,85 +131,231 @@ static int showHelpPage(const std::string_view& programName)
 
 using namespace mnxvalidate;
 
+// Lists the semantic rule groups. Each input file is validated once with every group and once without each group,
+// keeping the fastest of three runs, and the difference in semantic validation time is shown as the group's cost.
+static int showRulesPage(MnxValidateContext& mnxValidateContext, const std::vector<const arg_char*>& args)
+{
+    using Duration = std::chrono::duration<double, std::milli>;
+    constexpr int kRuns = 3;
+    std::cout << "Semantic rule groups (for --rules, --skip-rules and --rules-file):" << std::endl;
+    for (const auto rule : kSemanticRules) {
+        std::cout << "  " << std::left << std::setw(10) << semanticRuleName(rule) << semanticRuleDescription(rule) << std::endl;
+    }
+    std::cout << "Ids, durations, tuplets, events, clefs, staves, voices, kits and sounds are always checked." << std::endl;
+    if (args.empty()) {
+        return 0;
+    }
+
+    mnxValidateContext.loadSchema();
+    auto semanticTime = [&](const std::string& contents, const SemanticRuleSet& skipped) -> std::optional<Duration> {
+        const Validator validator(mnxValidateContext.schemaValidator, ValidatorOptions{ false, 0, 1, 1, 0, skipped });
+        std::optional<Duration> fastest;
+        for (int run = 0; run < kRuns; run++) {
+            const auto result = validator.validate(contents);
+            const auto& phase = result.timings.phases[static_cast<size_t>(ValidationPhase::Semantic)];
+            if (!phase || result.phase != ValidationPhase::Semantic) {
+                return std::nullopt;
+            }
+            fastest = std::min(fastest.value_or(Duration(*phase)), Duration(*phase));
+        }
+        return fastest;
+    };
+    Duration total{};
+    std::array<Duration, kSemanticRuleCount> costs{};
+    size_t fileCount = 0;
+    for (const arg_char* arg : args) {
+        const std::filesystem::path path(arg);
+        const std::string contents = utils::fileToString(path);
+        const auto all = semanticTime(contents, {});
+        if (!all) {
+            std::cerr << utils::pathToString(path) << ": skipped, because it does not reach semantic validation" << std::endl;
+            continue;
+        }
+        total += all.value();
+        for (const auto rule : kSemanticRules) {
+            const auto without = semanticTime(contents, SemanticRuleSet{}.set(static_cast<size_t>(rule)));
+            costs[static_cast<size_t>(rule)] += std::max(Duration{}, all.value() - without.value_or(all.value()));
+        }
+        fileCount++;
+    }
+    if (!fileCount) {
+        return 1;
+    }
+    std::cout << std::endl;
+    std::cout << "Semantic validation of " << fileCount << " file" << (fileCount == 1 ? "" : "s") << " took " << std::fixed << std::setprecision(1)
+              << total.count() << " ms with every group (fastest of " << kRuns << " runs). Time saved by skipping each group:" << std::endl;
+    for (const auto rule : kSemanticRules) {
+        const auto cost = costs[static_cast<size_t>(rule)];
+        std::cout << "  " << std::left << std::setw(10) << semanticRuleName(rule) << std::right << std::setw(10) << cost.count() << " ms"
+                  << std::setw(7) << (total.count() > 0 ? 100.0 * cost.count() / total.count() : 0.0) << "%" << std::endl;
+    }
+    return 0;
+}
+
+// Validates the entries of a zip or tar archive that the entry pattern matches, as they are read from the archive.
+// Without a pattern, the archive is searched like a directory.
+void processArchiveArg(const ArchiveEntryPath& input, MnxValidateContext& mnxValidateContext, int argc, arg_char* argv[],
+                       std::unordered_set<std::filesystem::path, PathHash>& seenPaths)
+{
+    std::filesystem::path archiveDir = input.archive.parent_path();
+    if (archiveDir.is_relative()) {
+        archiveDir = std::filesystem::current_path() / archiveDir;
+    }
+    mnxValidateContext.startLogging(archiveDir, argc, argv);
+    mnxValidateContext.loadSchema();
+    mnxValidateContext.openCache();
+
+    const auto entryPattern = utils::utf8ToPath(input.entry.empty() ? "*.*" : input.entry);
+    const bool isSpecificEntry = !input.entry.empty() && !GlobPattern::hasWildcards(entryPattern.native());
+    const InputTarget target{ {}, GlobPattern(entryPattern.native(), mnxValidateContext.recursiveSearch), {} };
+    ArchiveReader reader(input.archive, !mnxValidateContext.watch); // see MnxValidateContext::validateFile
+    bool foundEntry = false;
+    mnxValidateContext.processInputs([&]() -> std::optional<ValidationInput> {
+        while (auto entry = reader.next([&](std::string_view name) {
+                   return isSpecificEntry ? name == input.entry : target.wantsRelativePath(utils::utf8ToPath(name));
+               })) {
+            foundEntry = true;
+            auto path = ArchiveReader::entryPath(input.archive, entry->name);
+            if (seenPaths.emplace(normalizePathForDedupe(path)).second) {
+                return ValidationInput{ std::move(path), std::move(entry->contents) };
+            }
+        }
+        return std::nullopt;
+    });
+    if (mnxValidateContext.stopRequested) {
+        return;
+    }
+    for (const auto& error : reader.errors()) {
+        mnxValidateContext.logMessage(LogMsg() << error, LogSeverity::Error);
+    }
+    if (isSpecificEntry && !foundEntry) {
+        throw std::runtime_error("Input path " + utils::pathToString(ArchiveReader::entryPath(input.archive, input.entry)) + " does not exist in the archive.");
+    }
+    mnxValidateContext.logMessage(LogMsg() << "Searched " << reader.entryCount() << " entries in " << utils::pathToString(input.archive) << ".", LogSeverity::Verbose);
+}
+
 void processInputPathArg(const std::filesystem::path& rawInputPattern, MnxValidateContext& mnxValidateContext, int argc, arg_char* argv[],
-                         std::unordered_set<std::filesystem::path, PathHash>& seenPaths)
+                         std::unordered_set<std::filesystem::path, PathHash>& seenPaths, std::vector<InputTarget>* inputTargets)
 {
+    if (auto archiveEntry = ArchiveReader::splitEntryPath(rawInputPattern)) {
+        processArchiveArg(archiveEntry.value(), mnxValidateContext, argc, argv, seenPaths);
+        return;
+    }
+    if (ArchiveReader::isArchivePath(rawInputPattern) && std::filesystem::is_regular_file(rawInputPattern)) {
+        processArchiveArg({ rawInputPattern, {} }, mnxValidateContext, argc, argv, seenPaths);
+        return;
+    }
+
     std::filesystem::path inputFilePattern = rawInputPattern;
 
     // collect inputs
-    const auto inputPatternU8 = inputFilePattern.u8string();
-    const bool isSpecificFileOrDirectory = inputPatternU8.find(u8'*') == std::u8string::npos && inputPatternU8.find(u8'?') == std::u8string::npos;
+    const bool isSpecificFileOrDirectory = !GlobPattern::hasWildcards(inputFilePattern.native());
     bool isSpecificFile = isSpecificFileOrDirectory && inputFilePattern.has_filename();
+    std::filesystem::path inputDir;
+    GlobPattern::String wildcardPattern;
     if (std::filesystem::is_directory(inputFilePattern)) {
         isSpecificFile = false;
+        inputDir = inputFilePattern; // its name is not a pattern, even if it has wildcard characters
         inputFilePattern /= "*.*";
+        wildcardPattern = inputFilePattern.filename().native();
+    } else if (isSpecificFileOrDirectory) {
+        inputDir = inputFilePattern.parent_path();
+    } else {
+        std::tie(inputDir, wildcardPattern) = GlobPattern::splitBase(inputFilePattern);
     }
-    std::filesystem::path inputDir = inputFilePattern.parent_path();
     if (inputDir.is_relative()) {
         inputDir = std::filesystem::current_path() / inputDir;
     }
     bool inputIsOneFile = std::filesystem::is_regular_file(inputFilePattern);
     mnxValidateContext.startLogging(inputDir, argc, argv);
 
-    if (mnxValidateContext.mnxSchemaPath.has_value() && !mnxValidateContext.mnxSchema.has_value()) {
-        mnxValidateContext.mnxSchema = utils::fileToString(mnxValidateContext.mnxSchemaPath.value());
-    }
+    mnxValidateContext.loadSchema();
+    mnxValidateContext.openCache();
 
     if (isSpecificFileOrDirectory && !std::filesystem::exists(rawInputPattern) && !mnxValidateContext.forTestOutput()) {
         throw std::runtime_error("Input path " + utils::pathToString(inputFilePattern) + " does not exist or is not a file or directory.");
     }
 
-    // convert wildcard pattern to regex
-    auto wildcardPattern = inputFilePattern.filename().native(); // native format avoids encoding issues
+    auto isNewPath = [&](const std::filesystem::path& inputFilePath) {
+        return seenPaths.emplace(normalizePathForDedupe(inputFilePath)).second;
+    };
+    if (inputIsOneFile || (mnxValidateContext.forTestOutput() && isSpecificFile)) {
+        if (inputTargets) {
+            const auto filePath = normalizePathForDedupe(inputFilePattern);
+            inputTargets->push_back({ filePath.parent_path(), std::nullopt, filePath });
+        }
+        if (isNewPath(inputFilePattern)) {
+            mnxValidateContext.processFiles({ inputFilePattern });
+        }
+        return;
+    }
+
+    // Files are validated as the walker finds them. Validation writes nothing into the tree, so the walk cannot find its own output.
+    // The walker builds each path by appending names to the target directory, so the part after it is the path the pattern matches.
+    InputTarget target{ inputDir.lexically_normal(), GlobPattern(wildcardPattern, mnxValidateContext.recursiveSearch), {} };
+    if (inputTargets) {
+        inputTargets->push_back(target);
+    }
+    if (mnxValidateContext.stopRequested) {
+        return; // --fail-fast stopped an earlier input, but --watch still needs this one's target
+    }
+    const unsigned walkerThreads = mnxValidateContext.jobs ? mnxValidateContext.jobs : defaultJobCount();
+    DirectoryWalker walker(target.directory, target.spansDirectories(), [&target](const std::filesystem::path& path) {
+        return target.wantsFile(path);
+    }, walkerThreads, [&target](const std::filesystem::path& path) {
+        return target.wantsDirectory(path);
+    });
+    mnxValidateContext.processInputs([&]() -> std::optional<ValidationInput> {
+        while (auto path = walker.next()) {
+            if (isNewPath(path.value())) {
+                return ValidationInput{ std::move(path.value()), std::nullopt };
+            }
+        }
+        return std::nullopt;
+    });
+    if (mnxValidateContext.stopRequested) {
+        return; // the walk was abandoned, so its totals are incomplete
+    }
+    // the rest of the tree was still searched, but files in these directories were not validated
+    for (const auto& error : walker.errors()) {
+        mnxValidateContext.logMessage(LogMsg() << error, LogSeverity::Error);
+    }
+    mnxValidateContext.logMessage(LogMsg() << "Searched " << walker.directoryCount() << " directories and "
+        << walker.entryCount() << " entries in " << utils::pathToString(inputDir) << ".", LogSeverity::Verbose);
+    if (mnxValidateContext.timingStats) {
+        mnxValidateContext.timingStats->addScan(walker.elapsed());
+    }
+}
+
+void processDocumentStream(MnxValidateContext& mnxValidateContext, int argc, arg_char* argv[])
+{
 #ifdef _WIN32
-    auto regexPattern = std::regex_replace(wildcardPattern, std::wregex(LR"(\*)"), L".*");
-    regexPattern = std::regex_replace(regexPattern, std::wregex(LR"(\?)"), L".");
-    std::wregex regex(regexPattern);
-#else
-    auto regexPattern = std::regex_replace(wildcardPattern, std::regex(R"(\*)"), R"(.*)");
-    regexPattern = std::regex_replace(regexPattern, std::regex(R"(\?)"), R"(.)");
-    std::regex regex(regexPattern);
+    _setmode(_fileno(stdin), _O_BINARY); // framed lengths count bytes
 #endif
+    mnxValidateContext.startLogging(std::filesystem::current_path(), argc, argv);
+    mnxValidateContext.loadSchema();
+    mnxValidateContext.openCache();
+    DocumentStreamReader reader(std::cin, mnxValidateContext.stdinFormat, "stdin");
+    mnxValidateContext.processInputs([&]() { return reader.next(); });
+}
 
-    // collect files to process first
-    // this avoids potential infinite recursion if input and output are the same format
-    std::vector<std::filesystem::path> pathsToProcess;
-    auto appendUniquePath = [&](const std::filesystem::path& inputFilePath) {
-        const auto normalizedPath = normalizePathForDedupe(inputFilePath);
-        if (seenPaths.emplace(normalizedPath).second) {
-            pathsToProcess.emplace_back(inputFilePath);
+void mnxvalidate::processInputPatterns(const std::vector<std::filesystem::path>& inputPatterns, MnxValidateContext& context, int argc, arg_char* argv[],
+                                       std::vector<InputTarget>* inputTargets)
+{
+    std::unordered_set<std::filesystem::path, PathHash> seenPaths;
+    bool stdinProcessed = false;
+    for (const auto& inputPattern : inputPatterns) {
+        if (context.stopRequested && !inputTargets) {
+            break;
         }
-    };
-    auto iterate = [&](auto& iterator) {
-        for (auto it = iterator; it != std::filesystem::end(iterator); ++it) {
-            const auto& entry = *it;
-            if constexpr (std::is_same_v<std::remove_reference_t<decltype(iterator)>, std::filesystem::recursive_directory_iterator>) {
-                if (entry.is_directory()) {
-                }
-            }
-            if (!entry.is_directory()) {
-                mnxValidateContext.logMessage(LogMsg() << "considered file " << utils::pathToString(entry.path()), LogSeverity::Verbose);
-            }
-            if (entry.is_regular_file() && std::regex_match(entry.path().filename().native(), regex)) {
-                auto inputFilePath = entry.path();
-                if (utils::hasExtension(inputFilePath, MNX_EXTENSION) || utils::hasExtension(inputFilePath, JSON_EXTENSION)) {
-                    appendUniquePath(inputFilePath);
-                }
+        if (inputPattern == "-") {
+            if (!stdinProcessed) {
+                processDocumentStream(context, argc, argv);
+                stdinProcessed = true;
             }
+            continue;
         }
-    };
-    if (inputIsOneFile || (mnxValidateContext.forTestOutput() && isSpecificFile)) {
-        appendUniquePath(inputFilePattern);
-    } else if (mnxValidateContext.recursiveSearch) {
-        std::filesystem::recursive_directory_iterator it(inputDir);
-        iterate(it);
-    } else {
-        std::filesystem::directory_iterator it(inputDir);
-        iterate(it);
-    }
-    for (const auto& path : pathsToProcess) {
-        mnxValidateContext.inputFilePath = "";
-        mnxValidateContext.processFile(path);
+        processInputPathArg(inputPattern, context, argc, argv, seenPaths, inputTargets);
     }
 }
 
@@ -193,21 +388,57 @@ int _MAIN(int argc, arg_char* argv[])
         showAboutPage();
         return 0;
     }
+    if (mnxValidateContext.listRules) {
+        try {
+            return showRulesPage(mnxValidateContext, args);
+        } catch (const std::exception& e) {
+            mnxValidateContext.logMessage(LogMsg() << e.what(), LogSeverity::Error);
+            return 1;
+        }
+    }
+
+    try {
+        if (mnxValidateContext.serveSocketPath.has_value()) {
+            return runServer(mnxValidateContext, argc, argv);
+        }
+        if (mnxValidateContext.clientSocketPath.has_value() && (mnxValidateContext.stopServer || !args.empty())) {
+            return runClient(mnxValidateContext, argc, argv);
+        }
+    } catch (const std::exception& e) {
+        mnxValidateContext.logMessage(LogMsg() << e.what(), LogSeverity::Error);
+        return 1;
+    }
 
     if (args.empty()) {
         return showHelpPage(mnxValidateContext.programName);
     }
 
     try {
-        std::unordered_set<std::filesystem::path, PathHash> seenPaths;
-        for (const auto* arg : args) {
-            processInputPathArg(arg, mnxValidateContext, argc, argv, seenPaths);
+        mnxValidateContext.openReport();
+        mnxValidateContext.startTimings();
+        mnxValidateContext.startErrorSummary();
+        const std::vector<std::filesystem::path> inputPatterns(args.begin(), args.end());
+        if (mnxValidateContext.watch) {
+            watchInputPatterns(inputPatterns, mnxValidateContext, argc, argv);
+        } else {
+            processInputPatterns(inputPatterns, mnxValidateContext, argc, argv);
         }
     } catch (const std::exception& e) {
         mnxValidateContext.logMessage(LogMsg() << e.what(), LogSeverity::Error);
     }
 
+    try {
+        mnxValidateContext.closeReport();
+        mnxValidateContext.closeCache();
+        mnxValidateContext.logTimings();
+        mnxValidateContext.logErrorSummary();
+        mnxValidateContext.logMemoryUse();
+    } catch (const std::exception& e) {
+        mnxValidateContext.logMessage(LogMsg() << e.what(), LogSeverity::Error);
+    }
+    mnxValidateContext.logTruncation();
+
     mnxValidateContext.endLogging();
 
-    return mnxValidateContext.errorOccurred;
+    return mnxValidateContext.exitCode();
 }
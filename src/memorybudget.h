@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace mnxvalidate {
+
+/**
+ * @brief Tracks the estimated memory of the files being validated against the --max-memory budget.
+ *
+ * The caller admits files in input order, so a large file waiting for room is not passed over by smaller ones
+ * behind it. A file whose estimate is larger than the whole budget is admitted once nothing else is admitted,
+ * so it runs alone. The class does no locking: the caller guards it along with its work queue.
+ */
+class MemoryBudget
+{
+public:
+    /// @param budgetBytes the budget, or 0 for no limit
+    explicit MemoryBudget(std::uintmax_t budgetBytes) : m_budget(budgetBytes) {}
+
+    /// @brief Estimates the peak memory needed to validate an input of @p inputBytes
+    static std::uintmax_t estimateFor(std::uintmax_t inputBytes)
+    {
+        // A parsed nlohmann::json tree takes several times the size of its text, and the mnx::Document and the
+        // input itself add to it. The multiple is deliberately generous, since the cost of guessing low is swapping.
+        constexpr std::uintmax_t kBytesPerInputByte = 16;
+        if (inputBytes > std::numeric_limits<std::uintmax_t>::max() / kBytesPerInputByte) {
+            return std::numeric_limits<std::uintmax_t>::max();
+        }
+        return inputBytes * kBytesPerInputByte;
+    }
+
+    /// @brief True if a file with this estimate can start now
+    bool admits(std::uintmax_t cost) const
+    {
+        return m_budget == 0 || m_inUse == 0 || (cost <= m_budget && m_inUse <= m_budget - cost);
+    }
+
+    void acquire(std::uintmax_t cost) { m_inUse += cost; }     ///< Records that a file was admitted
+    void release(std::uintmax_t cost) { m_inUse -= cost; }     ///< Records that an admitted file has finished
+
+    std::uintmax_t inUse() const { return m_inUse; }            ///< The total estimate of the admitted files
+
+private:
+    const std::uintmax_t m_budget;
+    std::uintmax_t m_inUse{};
+};
+
+} // namespace mnxvalidate
@@ -22,12 +22,67 @@
 #include <iostream>
 #include <memory>
 #include <stdexcept>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <charconv>
+#include <iomanip>
 
 #include "mnxvalidate.h"
+#include "validationcache.h"
+#include "reportwriter.h"
+#include "timingstats.h"
+#include "memorybudget.h"
+#include "compression.h"
+#include "archivereader.h"
+#include "generatedschema.h"
+#include "utils/filebuffer.h"
+#include "utils/memoryutils.h"
 #include "mnxdom.h"
 
 namespace mnxvalidate {
 
+template <typename T>
+static T parseNumberArg(const std::string& option, arg_view arg, bool allowZero = false)
+{
+    const std::string value(_ARG_CONV(arg));
+    T result{};
+    const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+    if (ec != std::errc() || ptr != value.data() + value.size() || (result == 0 && !allowZero)) {
+        throw std::invalid_argument("Invalid value for " + option + ": " + value);
+    }
+    return result;
+}
+
+// Adds the rule groups in a comma or space separated list to @p rules. In a rules file, a group preceded by - is added to @p skipped instead.
+static void parseRuleList(const std::string& option, std::string_view list, SemanticRuleSet& rules, SemanticRuleSet* skipped = nullptr)
+{
+    size_t start = 0;
+    while (start < list.size()) {
+        size_t end = list.find_first_of(", \t\r\n", start);
+        if (end == std::string_view::npos) {
+            end = list.size();
+        }
+        std::string_view name = list.substr(start, end - start);
+        start = end + 1;
+        if (name.empty()) {
+            continue;
+        }
+        const bool skip = skipped && name.front() == '-';
+        if (skip) {
+            name.remove_prefix(1);
+        }
+        const auto rule = semanticRuleFromName(name);
+        if (!rule) {
+            throw std::invalid_argument("Unknown rule group for " + option + ": " + std::string(name) + " (see --list-rules)");
+        }
+        (skip ? *skipped : rules).set(static_cast<size_t>(rule.value()));
+    }
+}
+
 std::vector<const arg_char*> MnxValidateContext::parseOptions(int argc, arg_char* argv[])
 {
     std::vector<const arg_char*> args;
@@ -66,6 +121,99 @@ std::vector<const arg_char*> MnxValidateContext::parseOptions(int argc, arg_char
             }
         } else if (next == _ARG("--schema-only")) {
             schemaOnly = true;
+        } else if (next == _ARG("--stdin-stream")) {
+            args.push_back(_ARG("-"));
+        } else if (next == _ARG("--stdin-format")) {
+            const arg_view format = getNextArg();
+            if (format == _ARG("ndjson")) {
+                stdinFormat = StreamFormat::Ndjson;
+            } else if (format == _ARG("framed")) {
+                stdinFormat = StreamFormat::Framed;
+            } else {
+                throw std::invalid_argument("Invalid value for --stdin-format: " + std::string(_ARG_CONV(format)));
+            }
+        } else if (next == _ARG("--jobs")) {
+            jobs = parseNumberArg<unsigned>("--jobs", getNextArg());
+        } else if (next == _ARG("--rules")) {
+            parseRuleList("--rules", std::string(_ARG_CONV(getNextArg())), selectedRules.emplace(selectedRules.value_or(SemanticRuleSet{})));
+        } else if (next == _ARG("--skip-rules")) {
+            parseRuleList("--skip-rules", std::string(_ARG_CONV(getNextArg())), skippedRules);
+        } else if (next == _ARG("--rules-file")) {
+            std::filesystem::path rulesPath = getNextArg();
+            if (rulesPath.empty()) {
+                throw std::invalid_argument("--rules-file requires a file path");
+            }
+            std::istringstream rulesFile(utils::fileToString(rulesPath));
+            SemanticRuleSet fileRules;
+            for (std::string line; std::getline(rulesFile, line);) {
+                parseRuleList(utils::pathToString(rulesPath), std::string_view(line).substr(0, line.find('#')), fileRules, &skippedRules);
+            }
+            if (fileRules.any()) {
+                selectedRules = selectedRules.value_or(SemanticRuleSet{}) | fileRules;
+            }
+        } else if (next == _ARG("--list-rules")) {
+            listRules = true;
+        } else if (next == _ARG("--semantic-jobs")) {
+            semanticJobs = parseNumberArg<unsigned>("--semantic-jobs", getNextArg(), true);
+        } else if (next == _ARG("--semantic-threshold")) {
+            semanticSplitThreshold = parseNumberArg<size_t>("--semantic-threshold", getNextArg());
+        } else if (next == _ARG("--cache-dir")) {
+            std::filesystem::path cachePath = getNextArg();
+            if (cachePath.empty()) {
+                throw std::invalid_argument("--cache-dir requires a directory path");
+            }
+            cacheDir = cachePath;
+        } else if (next == _ARG("--cache-max-size")) {
+            cacheMaxMegabytes = parseNumberArg<std::uintmax_t>("--cache-max-size", getNextArg());
+        } else if (next == _ARG("--report")) {
+            std::filesystem::path path = getNextArg();
+            if (path.empty()) {
+                throw std::invalid_argument("--report requires a file path");
+            }
+            reportPath = path;
+        } else if (next == _ARG("--report-format")) {
+            const arg_view format = getNextArg();
+            if (format == _ARG("jsonl")) {
+                reportFormat = ReportFormat::Jsonl;
+            } else if (format == _ARG("sarif")) {
+                reportFormat = ReportFormat::Sarif;
+            } else if (format == _ARG("junit")) {
+                reportFormat = ReportFormat::Junit;
+            } else {
+                throw std::invalid_argument("Invalid value for --report-format: " + std::string(_ARG_CONV(format)));
+            }
+        } else if (next == _ARG("--max-errors")) {
+            maxErrors = parseNumberArg<size_t>("--max-errors", getNextArg());
+        } else if (next == _ARG("--fail-fast")) {
+            failFast = true;
+        } else if (next == _ARG("--max-memory")) {
+            maxMemoryMegabytes = parseNumberArg<std::uintmax_t>("--max-memory", getNextArg());
+        } else if (next == _ARG("--timings")) {
+            showTimings = true;
+        } else if (next == _ARG("--timings-slowest")) {
+            slowestFileCount = parseNumberArg<size_t>("--timings-slowest", getNextArg());
+        } else if (next == _ARG("--error-summary")) {
+            showErrorSummary = true;
+        } else if (next == _ARG("--error-summary-top")) {
+            errorSummaryCount = parseNumberArg<size_t>("--error-summary-top", getNextArg());
+        } else if (next == _ARG("--serve")) {
+            std::filesystem::path socketPath = getNextArg();
+            if (socketPath.empty()) {
+                throw std::invalid_argument("--serve requires a socket path");
+            }
+            serveSocketPath = socketPath;
+        } else if (next == _ARG("--client")) {
+            std::filesystem::path socketPath = getNextArg();
+            if (socketPath.empty()) {
+                throw std::invalid_argument("--client requires a socket path");
+            }
+            clientSocketPath = socketPath;
+        } else if (next == _ARG("--stop")) {
+            stopServer = true;
+        } else if (next == _ARG("--watch")) {
+            watch = true;
+        } else if (next == _ARG("--watch-debounce")) {
+            watchDebounce = std::chrono::milliseconds(parseNumberArg<unsigned>("--watch-debounce", getNextArg()));
 #ifdef MNXVALIDATE_TEST // this is defined on the command line by the test program
         } else if (next == _ARG("--testing")) {
             testOutput = true;
@@ -99,7 +247,29 @@ std::string getTimeStamp(const std::string& fmt)
     return timestamp.str();
 }
 
+// Messages are prefixed with the input's file name, or for an archive entry with the archive's file name and the entry's path
+static std::string messagePrefix(const std::filesystem::path& inputFilePath)
+{
+    if (const auto archiveEntry = ArchiveReader::splitEntryPath(inputFilePath)) {
+        return utils::pathToString(ArchiveReader::entryPath(archiveEntry->archive.filename(), archiveEntry->entry));
+    }
+    return utils::pathToString(inputFilePath.filename());
+}
+
+void FileContext::logMessage(LogMsg&& msg, bool alwaysShow, LogSeverity severity)
+{
+    // filtering happens when the messages are written, so that cached results are valid for any options
+    msg.flush();
+    messages.push_back({ messagePrefix(inputFilePath), msg.str(), severity, alwaysShow });
+}
+
 void MnxValidateContext::logMessage(LogMsg&& msg, bool alwaysShow, LogSeverity severity) const
+{
+    msg.flush();
+    writeLogMessage({}, msg.str(), alwaysShow, severity);
+}
+
+void MnxValidateContext::writeLogMessage(const std::string& inputFileName, const std::string& msg, bool alwaysShow, LogSeverity severity) const
 {
     auto getSeverityStr = [severity]() -> std::string {
             switch (severity) {
@@ -109,49 +279,58 @@ void MnxValidateContext::logMessage(LogMsg&& msg, bool alwaysShow, LogSeverity s
             case LogSeverity::Error: return "[***ERROR***] ";
             }
         };
-    if (!alwaysShow) {
-        if (severity == LogSeverity::Verbose && (!verbose || quiet)) {
-            return;
-        }
-        if (severity == LogSeverity::Info && quiet) {
-            return;
-        }
+    if (!shouldLog(alwaysShow, severity)) {
+        return;
     }
     if (severity == LogSeverity::Error) {
         errorOccurred = true;
     }
-    msg.flush();
-    std::string inputFile = utils::pathToString(inputFilePath.filename());
+    std::string inputFile = inputFileName;
     if (!inputFile.empty()) {
         inputFile += ' ';
     }
+    if (messageOutput) {
+        *messageOutput << inputFile << getSeverityStr() << msg << '\n';
+        return;
+    }
+    LogWriter& writer = getLogWriter();
+    std::string line = inputFile + getSeverityStr() + msg + '\n';
     if (logFile && logFile->is_open()) {
-        LogMsg prefix = LogMsg() << "[" << getTimeStamp("%Y-%m-%d %H:%M:%S") << "] " << inputFile;
-        prefix.flush();
-        *logFile << prefix.str() << getSeverityStr() << msg.str() << std::endl;
+        writer.writeToLogFile("[" + writer.timeStamp() + "] " + line);
         if (severity != LogSeverity::Error) {
             return;
         }
     }
+    writer.writeToConsole(std::move(line));
+    if (severity == LogSeverity::Error) {
+        writer.flush();
+    }
+}
 
+LogWriter& MnxValidateContext::getLogWriter() const
+{
+    if (!logWriter) {
+        logWriter = std::make_unique<LogWriter>([](const std::string& lines) {
 #if defined(_WIN32) && !defined(MNXVALIDATE_TEST)
-    HANDLE hConsole = GetStdHandle(STD_ERROR_HANDLE);
-    if (hConsole && hConsole != INVALID_HANDLE_VALUE) {
-        DWORD consoleMode{};
-        if (::GetConsoleMode(hConsole, &consoleMode)) {
-            std::wstringstream wMsg;
-            wMsg << utils::stringToWstring(inputFile + getSeverityStr() + msg.str()) << std::endl;
-            DWORD written{};
-            if (::WriteConsoleW(hConsole, wMsg.str().data(), static_cast<DWORD>(wMsg.str().size()), &written, nullptr)) {
-                return;
+            HANDLE hConsole = GetStdHandle(STD_ERROR_HANDLE);
+            if (hConsole && hConsole != INVALID_HANDLE_VALUE) {
+                DWORD consoleMode{};
+                if (::GetConsoleMode(hConsole, &consoleMode)) {
+                    std::wstring wLines = utils::stringToWstring(lines);
+                    DWORD written{};
+                    if (::WriteConsoleW(hConsole, wLines.data(), static_cast<DWORD>(wLines.size()), &written, nullptr)) {
+                        return;
+                    }
+                    std::wcerr << L"Failed to write message to console: " << ::GetLastError() << std::endl;
+                }
             }
-            std::wcerr << L"Failed to write message to console: " << ::GetLastError() << std::endl;
-        }
-    }
-    std::wcerr << utils::stringToWstring(msg.str()) << std::endl;
+            std::wcerr << utils::stringToWstring(lines) << std::flush;
 #else
-    std::cerr << inputFile << getSeverityStr() << msg.str() << std::endl;
+            std::cerr << lines << std::flush;
 #endif
+        });
+    }
+    return *logWriter;
 }
 
 /** returns true if input path is a directory */
@@ -198,6 +377,7 @@ void MnxValidateContext::startLogging(const std::filesystem::path& defaultLogPat
         if (appending) {
             *logFile << std::endl;
         }
+        getLogWriter().setLogFile(logFile);
         logMessage(LogMsg() << "======= START =======", true);
         logMessage(LogMsg() << programName << " executed with the following arguments:", true);
         LogMsg args;
@@ -209,70 +389,497 @@ void MnxValidateContext::startLogging(const std::filesystem::path& defaultLogPat
     }   
 }
 
+void MnxValidateContext::flushLog() const
+{
+    if (logWriter) {
+        logWriter->flush();
+    }
+}
+
 void MnxValidateContext::endLogging()
 {
     if (!noLog && logFilePath.has_value() && !forTestOutput()) {
-        inputFilePath = "";
         logMessage(LogMsg(), true);
         logMessage(LogMsg() << programName << " processing complete", true);
         logMessage(LogMsg() << "======== END ========", true);
+        getLogWriter().setLogFile(nullptr);
+        logWriter->sync();
         logFile.reset();
     }
 }
 
-static bool validateJsonAgainstSchema(const std::filesystem::path& jsonFilePath, const MnxValidateContext& context)
+// Logs a file's errors. Errors of the same kind are logged once, with their count and first few locations,
+// so that a systematically broken file does not flood the log.
+static void logDiagnostics(const DiagnosticList& diagnostics, FileContext& context)
 {
-    try {
-        auto doc = std::make_unique<mnx::Document>(mnx::Document::create(jsonFilePath));
-        auto validateResult = mnx::validation::schemaValidate(*doc, context.mnxSchema);
-        if (validateResult) {
+    constexpr size_t kMaxLocations = 3;
+    for (const auto& group : diagnostics.groups(kMaxLocations)) {
+        const size_t first = group.examples.front();
+        if (group.count == 1) {
+            const auto diagnostic = diagnostics[first];
+            // semantic errors carry their location in the message
+            const std::string text = diagnostic.phase == ValidationPhase::Semantic ? diagnostic.message
+                : SchemaError{ diagnostic.pointer, diagnostic.message }.to_string();
+            context.logMessage(LogMsg() << "    " << text, LogSeverity::Error);
+            continue;
+        }
+        LogMsg msg;
+        msg << "    " << diagnostics.kind(first) << " (" << group.count << " times";
+        std::string separator = ", at ";
+        for (const size_t example : group.examples) {
+            if (const std::string location = diagnostics.location(example); !location.empty()) {
+                msg << separator << location;
+                separator = "; ";
+            }
+        }
+        if (group.count > group.examples.size() && separator == "; ") {
+            msg << "; ...";
+        }
+        msg << ")";
+        context.logMessage(std::move(msg), LogSeverity::Error);
+    }
+}
+
+// Logs a validation result as the checks that produced it would have reported it.
+static void logValidationResult(ValidationResult&& result, FileContext& context)
+{
+    switch (result.phase) {
+    case ValidationPhase::Read:
+    case ValidationPhase::Parse:
+        for (const auto& diagnostic : result.diagnostics) {
+            context.logMessage(LogMsg() << "Parsing error: " << diagnostic.message, LogSeverity::Error);
+        }
+        context.logMessage(LogMsg() << "Schema validation failed.", LogSeverity::Error);
+        break;
+    case ValidationPhase::Schema:
+        if (result.diagnostics.empty()) {
             context.logMessage(LogMsg() << "Schema validation succeeded.");
-            context.mnxDoc = std::move(doc);
-            return true;
+            break;
         }
         context.logMessage(LogMsg() << "Validation errors:", LogSeverity::Error);
-        for (const auto& error : validateResult.errors) {
-            context.logMessage(LogMsg() << "    "  << error.to_string(), LogSeverity::Error);
+        logDiagnostics(result.diagnostics, context);
+        if (result.truncated) {
+            context.logMessage(LogMsg() << "Stopped at the --max-errors limit of " << result.diagnostics.size() << ".", LogSeverity::Warning);
         }
-    } catch (const json::exception& e) {
-        context.logMessage(LogMsg() << "Parsing error: " << e.what(), LogSeverity::Error);
+        context.logMessage(LogMsg() << "Schema validation failed.", LogSeverity::Error);
+        break;
+    case ValidationPhase::Semantic:
+        context.logMessage(LogMsg() << "Schema validation succeeded.");
+        if (result.diagnostics.empty()) {
+            const auto& stats = result.stats.value();
+            context.logMessage(LogMsg() << "Semantic validation complete (" << stats.measures << " measures, "
+                << stats.parts << " parts, " << stats.layouts << " layouts).");
+            break;
+        }
+        context.logMessage(LogMsg() << "Semantic validation errors:", LogSeverity::Error);
+        logDiagnostics(result.diagnostics, context);
+        if (result.omittedErrorCount) {
+            context.logMessage(LogMsg() << "Stopped at the --max-errors limit of " << result.diagnostics.size() << ". "
+                << result.omittedErrorCount << " more were not shown.", LogSeverity::Warning);
+        }
+        break;
     }
-    context.logMessage(LogMsg() << "Schema validation failed.", LogSeverity::Error);
-    return false;
+    result.timings.phases[static_cast<size_t>(ValidationPhase::Read)] = context.timings.phases[static_cast<size_t>(ValidationPhase::Read)];
+    context.timings = result.timings;
+    context.phase = result.phase;
+    context.truncated = result.truncated;
+    context.diagnostics = std::move(result.diagnostics);
 }
 
-void MnxValidateContext::processFile(const std::filesystem::path inpFilePath) const
+void MnxValidateContext::loadSchema()
+{
+    if (mnxSchemaPath.has_value() && !mnxSchema.has_value()) {
+        mnxSchema = utils::fileToString(mnxSchemaPath.value());
+    }
+    if (!schemaValidator) {
+        schemaValidator = std::make_shared<const SchemaValidator>(mnxSchema);
+        if (!mnxSchema.has_value() && !schemaValidator->usesGeneratedCode()) {
+            logMessage(LogMsg() << "Validating with the generic schema validator, because " << generated::unavailableReason() << ".",
+                LogSeverity::Verbose);
+        }
+        if (schemaOnly && !schemaValidator->canStream()) {
+            logMessage(LogMsg() << "Validating each document after it is parsed, because " << schemaValidator->streamingUnavailableReason() << ".",
+                LogSeverity::Verbose);
+        }
+    }
+    if (!validator) {
+        validator = std::make_shared<const Validator>(schemaValidator, ValidatorOptions{ schemaOnly, maxErrors, jobs, semanticJobs, semanticSplitThreshold, rulesToSkip() });
+    }
+}
+
+void MnxValidateContext::openReport()
+{
+    if (reportPath.has_value() && !report) {
+        report = ReportWriter::create(reportFormat, reportPath.value(), programName);
+    }
+}
+
+void MnxValidateContext::closeReport()
 {
+    if (report) {
+        report->finish(timingStats.get());
+        report.reset();
+    }
+}
+
+void MnxValidateContext::logTruncation() const
+{
+    if (stopRequested) {
+        logMessage(LogMsg() << "Validation stopped at the first failing file (--fail-fast). Later inputs were not validated.", LogSeverity::Warning);
+    }
+    if (truncatedFileCount) {
+        logMessage(LogMsg() << "Errors were cut short at the --max-errors limit of " << maxErrors << " in " << truncatedFileCount << " file(s).", LogSeverity::Warning);
+    }
+}
+
+void MnxValidateContext::logMemoryUse() const
+{
+    const std::uint64_t peakBytes = utils::peakResidentBytes();
+    if (peakBytes) {
+        logMessage(LogMsg() << "Peak memory use: " << (peakBytes + 1024 * 1024 - 1) / (1024 * 1024) << " MB"
+            << (maxMemoryMegabytes ? " (--max-memory " + std::to_string(maxMemoryMegabytes) + " MB)" : std::string()) << ".",
+            maxMemoryMegabytes ? LogSeverity::Info : LogSeverity::Verbose);
+    }
+}
+
+void MnxValidateContext::startTimings()
+{
+    if (showTimings && !timingStats) {
+        timingStats = std::make_shared<TimingStats>(slowestFileCount);
+    }
+}
+
+void MnxValidateContext::logTimings()
+{
+    if (timingStats) {
+        for (auto& line : timingStats->summaryLines()) {
+            logMessage(LogMsg() << line, true);
+        }
+        timingStats.reset();
+    }
+}
+
+void MnxValidateContext::startErrorSummary()
+{
+    if (showErrorSummary && !errorSummary) {
+        errorSummary = std::make_shared<DiagnosticSummary>();
+    }
+}
+
+void MnxValidateContext::logErrorSummary()
+{
+    if (errorSummary) {
+        if (errorSummary->errorCount()) {
+            logMessage(LogMsg() << "Most frequent errors: " << errorSummary->errorCount() << " errors in " << errorSummary->inputCount() << " files", true);
+            logMessage(LogMsg() << "    " << std::setw(8) << "errors" << std::setw(8) << "files" << "  " << std::left << std::setw(10) << "phase" << "error", true);
+            for (const auto& entry : errorSummary->top(errorSummaryCount)) {
+                logMessage(LogMsg() << "    " << std::setw(8) << entry.count << std::setw(8) << entry.inputCount << "  "
+                    << std::left << std::setw(10) << phaseName(entry.phase) << entry.kind, true);
+            }
+        } else {
+            logMessage(LogMsg() << "Most frequent errors: no errors", true);
+        }
+        errorSummary.reset();
+    }
+}
+
+void MnxValidateContext::openCache()
+{
+    if (cacheDir.has_value() && !cache) {
+        std::ostringstream configuration;
+        configuration << MNXVALIDATE_VERSION << '\n' << MNXDOM_GIT_TAG_OR_BRANCH << '\n' << schemaOnly << '\n'
+                      << (schemaValidator ? schemaValidator->schemaText() : std::string());
+        if (maxErrors) {
+            configuration << '\n' << maxErrors; // appended only when set, so entries from runs without a limit stay valid
+        }
+        if (rulesToSkip().any()) {
+            configuration << "\nskip " << rulesToSkip().to_string();
+        }
+        cache = std::make_shared<ValidationCache>(cacheDir.value(), configuration.str(), cacheMaxMegabytes * 1024 * 1024);
+    }
+}
+
+void MnxValidateContext::closeCache()
+{
+    if (cache) {
+        logMessage(LogMsg() << "Validation cache: " << cache->hits() << " hits, " << cache->misses() << " misses.");
+        cache->trim();
+        cache.reset();
+    }
+}
+
+std::unique_ptr<FileContext> MnxValidateContext::validateFile(const std::filesystem::path& inpFilePath, std::optional<std::string> fileContents) const
+{
+    const auto startTime = std::chrono::steady_clock::now();
+    auto fileContext = std::make_unique<FileContext>(*this, inpFilePath);
+    auto& context = *fileContext;
+    // Once --fail-fast has stopped the run, every file still in flight comes after the failure and will never be logged.
+    if (stopRequested) {
+        return fileContext;
+    }
     try {
-        if (!std::filesystem::is_regular_file(inpFilePath) && !forTestOutput()) {
+        if (!fileContents && (!std::filesystem::exists(inpFilePath) || std::filesystem::is_directory(inpFilePath)) && !forTestOutput()) {
             throw std::runtime_error("Input file " + utils::pathToString(inpFilePath) + " does not exist or is not a file.");
         }
         constexpr char kProcessingMessage[] = "Processing File: ";
         constexpr size_t kProcessingMessageSize = sizeof(kProcessingMessage) - 1; // account for null terminator.
         std::string delimiter(kProcessingMessageSize + inpFilePath.u32string().size(), '='); // use u32string().size to get actual number of characters displayed
         // log header for each file
-        logMessage(LogMsg(), true);
-        logMessage(LogMsg() << delimiter, true);
-        logMessage(LogMsg() << kProcessingMessage << utils::pathToString(inpFilePath), true);
-        logMessage(LogMsg() << delimiter, true);
-        resetForFile(inpFilePath); // reset after logging the header
-
-        bool success = validateJsonAgainstSchema(inputFilePath, *this); // side-effect: validateJsonAgainstSchema creates the mnxDocument
-        if (success && !schemaOnly) {
-            auto result = mnx::validation::semanticValidate(*mnxDoc);
-            if (result) {
-                size_t layoutSize = mnxDoc->layouts() ? mnxDoc->layouts().value().size() : 0;
-                logMessage(LogMsg() << "Semantic validation complete (" << mnxDoc->global().measures().size() << " measures, "
-                    << mnxDoc->parts().size() << " parts, " << layoutSize << " layouts).");
-            } else {
-                logMessage(LogMsg() << "Semantic validation errors:", LogSeverity::Error);
-                for (const auto& error : result.errors) {
-                    logMessage(LogMsg() << "    "  << error.to_string(), LogSeverity::Error);
+        context.logMessage(LogMsg(), true);
+        context.logMessage(LogMsg() << delimiter, true);
+        context.logMessage(LogMsg() << kProcessingMessage << utils::pathToString(inpFilePath), true);
+        context.logMessage(LogMsg() << delimiter, true);
+        context.resetForFile(inpFilePath); // reset after logging the header
+
+        // large files are mapped rather than copied; pipes and other non-regular files are read.
+        // --watch reads files that are being saved, and a mapped file that is truncated meanwhile raises SIGBUS, so it always copies.
+        const auto readStart = std::chrono::steady_clock::now();
+        std::optional<utils::FileBuffer> fileBuffer;
+        if (!fileContents) {
+            fileBuffer.emplace(inpFilePath, !watch);
+        }
+        const std::string_view contents = fileBuffer ? fileBuffer->view() : std::string_view(fileContents.value());
+        context.recordPhase(ValidationPhase::Read, readStart);
+        context.timings.bytesRead = contents.size();
+
+        std::string cacheKey;
+        if (cache) {
+            cacheKey = cache->keyFor(contents);
+            if (auto cachedResult = cache->lookup(cacheKey)) {
+                context.logMessage(LogMsg() << "Using cached result.", LogSeverity::Verbose);
+                const std::string inputFile = messagePrefix(inpFilePath);
+                for (auto& msg : cachedResult->messages) {
+                    msg.inputFile = inputFile;
+                    context.messages.push_back(std::move(msg));
                 }
+                context.diagnostics = std::move(cachedResult->diagnostics);
+                context.phase = cachedResult->phase;
+                context.duration = std::chrono::steady_clock::now() - startTime;
+                return fileContext;
             }
         }
+        const size_t firstResultMessage = context.messages.size();
+
+        // The validator frees the document before it returns, rather than when the file's log is written,
+        // which may wait for earlier files.
+        auto result = validator->validate(contents, &stopRequested);
+        fileBuffer.reset(); // the result does not refer to its source
+        if (stopRequested) {
+            return fileContext;
+        }
+        logValidationResult(std::move(result), context);
+        // Only complete results get here: exceptions such as read errors are never cached.
+        // Neither are results cut short by --max-errors, since they do not record that they were.
+        if (cache && !context.truncated) {
+            cache->store(cacheKey, { std::vector<BufferedLogMsg>(context.messages.begin() + firstResultMessage, context.messages.end()),
+                                     context.diagnostics, context.phase });
+        }
+        // This describes how this run validated the file, not the result, so it is not cached.
+        if (const auto& discarded = context.timings.discardedSplit) {
+            context.logMessage(LogMsg() << "Split semantic checks found an error after " << std::chrono::duration<double, std::milli>(discarded.value()).count()
+                << " ms, so the file was checked again on one thread.", LogSeverity::Verbose);
+        }
     } catch (const std::exception& e) {
-        logMessage(LogMsg() << e.what(), true, LogSeverity::Error);
+        context.logMessage(LogMsg() << e.what(), true, LogSeverity::Error);
+        context.addDiagnostic(context.phase, {}, e.what());
+    }
+    context.duration = std::chrono::steady_clock::now() - startTime;
+    return fileContext;
+}
+
+void MnxValidateContext::flushFileLog(const FileContext& fileContext) const
+{
+    for (const auto& msg : fileContext.messages) {
+        writeLogMessage(msg.inputFile, msg.text, msg.alwaysShow, msg.severity);
+    }
+    if (report) {
+        report->writeFile(fileContext);
+    }
+    if (timingStats) {
+        timingStats->addFile(fileContext);
+    }
+    if (errorSummary) {
+        errorSummary->add(fileContext.diagnostics);
+    }
+    if (fileContext.truncated) {
+        truncatedFileCount++;
+    }
+    if (failFast && !fileContext.diagnostics.empty()) {
+        stopRequested = true;
+    }
+    if (logWriter) {
+        logWriter->flush();
+    }
+}
+
+void MnxValidateContext::processFile(const std::filesystem::path inpFilePath) const
+{
+    flushFileLog(*validateFile(inpFilePath));
+}
+
+void MnxValidateContext::processFiles(const std::vector<std::filesystem::path>& inpFilePaths) const
+{
+    size_t nextPath = 0;
+    processInputs([&]() -> std::optional<ValidationInput> {
+        if (nextPath < inpFilePaths.size()) {
+            return ValidationInput{ inpFilePaths[nextPath++], std::nullopt };
+        }
+        return std::nullopt;
+    }, inpFilePaths.size());
+}
+
+void MnxValidateContext::processInputs(const std::function<std::optional<ValidationInput>()>& nextInput, size_t maxInputs) const
+{
+    const size_t workerCount = std::min<size_t>(jobs ? jobs : defaultJobCount(), maxInputs);
+    if (workerCount <= 1) {
+        while (!stopRequested) {
+            auto input = nextInput();
+            if (!input) {
+                break;
+            }
+            flushFileLog(*validateFile(input->path, std::move(input->contents)));
+        }
+        return;
+    }
+
+    // A reader thread pulls inputs and queues them for the workers, keeping at most kInputsPerWorker per worker
+    // in flight so that memory use does not depend on the number of inputs. Workers take inputs in order, and
+    // with --max-memory only while the next one's estimated memory fits. The calling thread writes each
+    // file's log as soon as it and every file before it have finished.
+    constexpr size_t kInputsPerWorker = 2;
+    const size_t maxInFlight = workerCount * kInputsPerWorker;
+    struct Task
+    {
+        size_t index{};
+        ValidationInput input;
+        std::uintmax_t memoryCost{};    ///< the estimate admitted against #MnxValidateContext::maxMemoryMegabytes
+    };
+    std::mutex mutex;
+    std::condition_variable stateChanged;
+    std::deque<Task> queue;
+    MemoryBudget memoryBudget(maxMemoryMegabytes * 1024 * 1024);
+    std::map<size_t, std::unique_ptr<FileContext>> results;
+    size_t inputCount = 0;
+    size_t flushedCount = 0;
+    bool inputsDone = false;
+    bool stopping = false;
+    std::exception_ptr inputError;
+
+    auto reader = [&]() {
+        try {
+            while (true) {
+                {
+                    std::unique_lock lock(mutex);
+                    stateChanged.wait(lock, [&]() { return stopping || inputCount - flushedCount < maxInFlight; });
+                    if (stopping) {
+                        break;
+                    }
+                }
+                auto input = nextInput();
+                if (!input) {
+                    break;
+                }
+                std::uintmax_t memoryCost = 0;
+                if (maxMemoryMegabytes) {
+                    std::error_code ec;
+                    std::uintmax_t inputBytes = input->contents ? input->contents->size() : std::filesystem::file_size(input->path, ec);
+                    // the document is built from the decompressed text, which can be many times larger
+                    if (input->contents) {
+                        inputBytes = decompressedSizeHint(std::string_view(input->contents.value())).value_or(inputBytes);
+                    } else if (compressionForPath(input->path) != Compression::None) {
+                        inputBytes = decompressedSizeHint(input->path).value_or(inputBytes);
+                    }
+                    memoryCost = MemoryBudget::estimateFor(ec ? 0 : inputBytes);
+                }
+                {
+                    std::lock_guard lock(mutex);
+                    queue.push_back({ inputCount++, std::move(input.value()), memoryCost });
+                }
+                stateChanged.notify_all();
+            }
+        } catch (...) {
+            std::lock_guard lock(mutex);
+            inputError = std::current_exception();
+        }
+        {
+            std::lock_guard lock(mutex);
+            inputsDone = true;
+        }
+        stateChanged.notify_all();
+    };
+    auto worker = [&]() {
+        while (true) {
+            Task task;
+            {
+                std::unique_lock lock(mutex);
+                stateChanged.wait(lock, [&]() {
+                    return stopping || (queue.empty() ? inputsDone : memoryBudget.admits(queue.front().memoryCost));
+                });
+                if (stopping || queue.empty()) {
+                    return;
+                }
+                task = std::move(queue.front());
+                queue.pop_front();
+                memoryBudget.acquire(task.memoryCost);
+            }
+            auto result = validateFile(task.input.path, std::move(task.input.contents));
+            {
+                std::lock_guard lock(mutex);
+                memoryBudget.release(task.memoryCost);
+                results.emplace(task.index, std::move(result));
+            }
+            stateChanged.notify_all();
+        }
+    };
+
+    std::vector<std::jthread> threads;
+    threads.reserve(workerCount + 1);
+    threads.emplace_back(reader);
+    for (size_t x = 0; x < workerCount; x++) {
+        threads.emplace_back(worker);
+    }
+    struct StopOnExit // destroyed before the threads are joined, so an exception here does not leave them waiting
+    {
+        std::function<void()> stop;
+        ~StopOnExit() { stop(); }
+    } stopOnExit{ [&]() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        stateChanged.notify_all();
+    } };
+
+    while (true) {
+        std::unique_ptr<FileContext> result;
+        {
+            std::unique_lock lock(mutex);
+            stateChanged.wait(lock, [&]() { return results.contains(flushedCount) || (inputsDone && flushedCount == inputCount); });
+            auto it = results.find(flushedCount);
+            if (it == results.end()) {
+                break;
+            }
+            result = std::move(it->second);
+            results.erase(it);
+        }
+        flushFileLog(*result);
+        if (stopRequested) {
+            break; // stopOnExit stops the reader and the workers, which abandon their files at the next phase
+        }
+        {
+            std::lock_guard lock(mutex);
+            flushedCount++;
+        }
+        stateChanged.notify_all();
+    }
+    // After a stop the reader may still be running, so the error is read under the lock that the reader writes it under
+    std::exception_ptr error;
+    {
+        std::lock_guard lock(mutex);
+        error = inputError;
+    }
+    if (error) {
+        std::rethrow_exception(error);
     }
 }
 
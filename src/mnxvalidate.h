@@ -30,13 +30,22 @@
 #include <functional>
 #include <map>
 #include <unordered_map>
+#include <cstdint>
+#include <chrono>
+#include <atomic>
 
 #include "utils/stringutils.h"
 #include "mnxdom.h"
+#include "schemavalidator.h"
+#include "validator.h"
+#include "logwriter.h"
 
 constexpr char8_t MNX_EXTENSION[]                = u8"mnx";
 constexpr char8_t JSON_EXTENSION[]               = u8"json";
 
+constexpr int EXIT_CODE_ERRORS                  = 1;    ///< at least one input failed validation
+constexpr int EXIT_CODE_TRUNCATED               = 2;    ///< at least one input failed, and --fail-fast or --max-errors cut the run short
+
 #ifdef _WIN32
 #define _ARG(S) L##S
 #define _ARG_CONV(S) (utils::wstringToString(std::wstring(S)))
@@ -88,6 +97,84 @@ enum class LogSeverity
     Verbose     ///< Only emit if --verbose option specified. The message is for information.
 };
 
+/// @brief A log message captured while a file is being validated.
+struct BufferedLogMsg
+{
+    std::string inputFile;      ///< the input file name prefix that was current when the message was logged
+    std::string text;           ///< the utf-8 encoded message
+    LogSeverity severity{};     ///< the message severity
+    bool alwaysShow{};          ///< if true, the message is shown even with --quiet
+};
+
+/// @brief how the documents in a document stream are delimited
+enum class StreamFormat
+{
+    Ndjson,     ///< one document per line
+    Framed      ///< each document is preceded by a `<byte-count> [<id>]` header line
+};
+
+struct MnxValidateContext;
+class ValidationCache;
+class ReportWriter;
+class TimingStats;
+
+/**
+ * @brief Holds the state for validating a single input file.
+ *
+ * Each file gets its own FileContext, so files can be validated concurrently. Messages are buffered
+ * rather than written, and #MnxValidateContext::flushFileLog writes them out in input order.
+ */
+struct FileContext
+{
+public:
+    FileContext(const MnxValidateContext& validateContext, const std::filesystem::path& inputPath)
+        : context(validateContext), inputPath(inputPath) {}
+
+    const MnxValidateContext& context;
+    const std::filesystem::path inputPath;      ///< the input being validated
+    std::filesystem::path inputFilePath;        ///< prefixes logged messages once the file's header has been logged
+    std::vector<BufferedLogMsg> messages;
+    DiagnosticList diagnostics;                 ///< every error found in the input
+    ValidationPhase phase{ ValidationPhase::Read }; ///< the phase that failed, or the last phase that ran if none failed
+    std::chrono::steady_clock::duration duration{}; ///< how long the file took to validate
+    FileTimings timings;                        ///< how long each phase took
+    bool truncated{};                           ///< validation stopped at --max-errors, so the file may have more errors
+
+    /**
+     * @brief buffers a message for output when this file's log is flushed
+     * @param msg a utf-8 encoded message.
+     * @param severity the message severity
+    */
+    void logMessage(LogMsg&& msg, LogSeverity severity = LogSeverity::Info)
+    { logMessage(std::move(msg), false, severity); }
+
+    void logMessage(LogMsg&& msg, bool alwaysShow, LogSeverity severity = LogSeverity::Info);
+
+    /// @brief records the time since @p start as the duration of @p timedPhase and returns the current time
+    std::chrono::steady_clock::time_point recordPhase(ValidationPhase timedPhase, std::chrono::steady_clock::time_point start)
+    { return timings.record(timedPhase, start); }
+
+    void resetForFile(const std::filesystem::path& inpFile)
+    {
+        inputFilePath = inpFile;
+    }
+
+    /// @brief records an error for reports. The error is logged separately.
+    void addDiagnostic(ValidationPhase errorPhase, std::string_view pointer, std::string_view message)
+    {
+        phase = errorPhase;
+        diagnostics.add(errorPhase, pointer, message);
+    }
+};
+
+/// @brief the format of the machine-readable report written with --report
+enum class ReportFormat
+{
+    Jsonl,      ///< one json object per file
+    Sarif,      ///< a SARIF 2.1.0 log
+    Junit       ///< JUnit XML with one test case per file
+};
+
 class ICommand;
 struct MnxValidateContext
 {
@@ -102,6 +189,7 @@ public:
     bool showVersion{};
     bool showHelp{};
     bool showAbout{};
+    bool listRules{};
     bool recursiveSearch{};
     bool noLog{};
     bool verbose{};
@@ -111,10 +199,46 @@ public:
 
     std::optional<std::filesystem::path> mnxSchemaPath;
     std::optional<std::string> mnxSchema;
+    std::shared_ptr<const SchemaValidator> schemaValidator; ///< compiled once from #mnxSchema (or the embedded schema) and shared by all files
+    std::shared_ptr<const Validator> validator; ///< applies #schemaValidator, #schemaOnly and #maxErrors to each file
     bool schemaOnly{};
+    StreamFormat stdinFormat{ StreamFormat::Ndjson }; ///< the format of the document stream read for the `-` input
+    unsigned jobs{};            ///< maximum number of files validated concurrently (0 means one per usable CPU)
+    unsigned semanticJobs{ 1 }; ///< threads that check the semantics of one large file (0 means one per usable CPU)
+    size_t semanticSplitThreshold{ ValidatorOptions::kDefaultSemanticSplitThreshold }; ///< files with fewer part-measures are checked on one thread
+    std::optional<SemanticRuleSet> selectedRules; ///< the rule groups named by --rules, if it was given
+    SemanticRuleSet skippedRules;                 ///< the rule groups named by --skip-rules
+    size_t maxErrors{};         ///< stop reporting errors for a file once this many have been found (0 means no limit)
+    bool failFast{};            ///< stop the run at the first file that fails
+    std::uintmax_t maxMemoryMegabytes{}; ///< only start files while their estimated memory fits in this many megabytes (0 means no limit)
+
+    /// @brief set when --fail-fast stops the run. Workers check it between phases and abandon their files.
+    mutable std::atomic<bool> stopRequested{};
+    mutable size_t truncatedFileCount{};        ///< the number of logged files whose errors were cut short by #maxErrors
+
+    std::optional<std::filesystem::path> cacheDir;
+    std::uintmax_t cacheMaxMegabytes{ 512 };
+    std::shared_ptr<ValidationCache> cache;
+
+    std::optional<std::filesystem::path> reportPath;
+    ReportFormat reportFormat{ ReportFormat::Jsonl };
+    std::shared_ptr<ReportWriter> report;
+
+    bool showTimings{};
+    size_t slowestFileCount{ 10 };             ///< the number of slowest files listed by --timings
+    std::shared_ptr<TimingStats> timingStats;
 
-    mutable std::filesystem::path inputFilePath;
-    mutable std::unique_ptr<mnx::Document> mnxDoc;
+    bool showErrorSummary{};
+    size_t errorSummaryCount{ 10 };            ///< the number of error kinds listed by --error-summary
+    std::shared_ptr<DiagnosticSummary> errorSummary;
+
+    std::optional<std::filesystem::path> serveSocketPath;  ///< run as a server listening on this socket
+    std::optional<std::filesystem::path> clientSocketPath; ///< send the inputs to the server listening on this socket
+    bool stopServer{};                                     ///< with --client, ask the server to exit
+    std::ostream* messageOutput{};                         ///< if set, messages that would go to std::cerr are written here instead
+
+    bool watch{};                                          ///< after the first pass, revalidate inputs as they change
+    std::chrono::milliseconds watchDebounce{ 200 };        ///< how long the inputs must be quiet before they are revalidated
 
 #ifdef MNXVALIDATE_TEST // this is defined on the command line by the test program
     bool testOutput{};
@@ -123,7 +247,49 @@ public:
     // Parse general options and return remaining options
     std::vector<const arg_char*> parseOptions(int argc, arg_char* argv[]);
 
+    void loadSchema(); ///< Reads and compiles the schema and creates the #validator if that has not been done already
+    /// @brief The rule groups that are not checked: those --skip-rules names, and those --rules leaves out
+    SemanticRuleSet rulesToSkip() const { return (selectedRules ? ~selectedRules.value() : SemanticRuleSet{}) | skippedRules; }
+    void openCache(); ///< Opens the validation cache if one was requested and it is not already open. Call after #loadSchema.
+    void closeCache(); ///< Trims the validation cache and reports its hits and misses
+    void openReport(); ///< Starts the machine-readable report if one was requested and it is not already open
+    void closeReport(); ///< Completes the machine-readable report
+    void startTimings(); ///< Starts collecting timings if --timings was given and they are not already being collected
+    void logTimings(); ///< Logs the timing summary and stops collecting timings
+    void startErrorSummary(); ///< Starts counting error kinds if --error-summary was given and they are not already being counted
+    void logErrorSummary(); ///< Logs the most frequent error kinds and stops counting them
+    void logTruncation() const; ///< Logs whether --fail-fast or --max-errors cut the run short
+    void logMemoryUse() const; ///< Logs the peak memory use of the process, if --max-memory or --verbose was given
+
+    /// @brief the exit code for the run: 0, #EXIT_CODE_ERRORS or #EXIT_CODE_TRUNCATED
+    int exitCode() const
+    {
+        if (!errorOccurred) {
+            return 0;
+        }
+        return (stopRequested || truncatedFileCount) ? EXIT_CODE_TRUNCATED : EXIT_CODE_ERRORS;
+    }
+
     void processFile(const std::filesystem::path inpFilePath) const;
+    void processFiles(const std::vector<std::filesystem::path>& inpFilePaths) const; ///< Validates files on up to #jobs threads, logging in input order
+
+    /**
+     * @brief Validates inputs on up to #jobs threads as they are produced, logging in input order.
+     *
+     * Only a few inputs per worker are in flight at once, so memory use does not grow with the number of inputs.
+     * @param nextInput returns the next input, or std::nullopt when there are no more. It is called on a separate
+     * thread when there is more than one worker, so it must not log.
+     * @param maxInputs an upper bound on the number of inputs, used to avoid starting more workers than needed
+     */
+    void processInputs(const std::function<std::optional<ValidationInput>()>& nextInput, size_t maxInputs = SIZE_MAX) const;
+
+    /**
+     * @brief Validates a single file without writing anything. Safe to call from multiple threads at once.
+     * @param inpFilePath the file to validate, or the name to report for @p fileContents
+     * @param fileContents the document, if it is already in memory. Otherwise it is read from @p inpFilePath.
+     */
+    std::unique_ptr<FileContext> validateFile(const std::filesystem::path& inpFilePath, std::optional<std::string> fileContents = std::nullopt) const;
+    void flushFileLog(const FileContext& fileContext) const; ///< Writes the buffered messages of a validated file and its report record
 
     // Logging methods
     void startLogging(const std::filesystem::path& defaultLogPath, int argc, arg_char* argv[]); ///< Starts logging if logging was requested
@@ -136,8 +302,23 @@ public:
     void logMessage(LogMsg&& msg, LogSeverity severity = LogSeverity::Info) const
     { logMessage(std::move(msg), false, severity); }
 
+    void flushLog() const; ///< Flushes everything logged so far, without waiting, before the program goes idle
     void endLogging(); ///< Ends logging if logging was requested
 
+    /// @brief returns true if a message with this severity would be shown with the current options
+    bool shouldLog(bool alwaysShow, LogSeverity severity) const
+    {
+        if (!alwaysShow) {
+            if (severity == LogSeverity::Verbose && (!verbose || quiet)) {
+                return false;
+            }
+            if (severity == LogSeverity::Info && quiet) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     bool forTestOutput() const
     {
 #ifdef MNXVALIDATE_TEST
@@ -149,11 +330,10 @@ public:
 
 private:
     void logMessage(LogMsg&& msg, bool alwaysShow, LogSeverity severity = LogSeverity::Info) const;
+    void writeLogMessage(const std::string& inputFileName, const std::string& msg, bool alwaysShow, LogSeverity severity) const;
+    LogWriter& getLogWriter() const; ///< Starts the log writer thread the first time it is needed
 
-    void resetForFile(const std::filesystem::path& inpFile) const
-    {
-        inputFilePath = inpFile;
-    }
+    mutable std::unique_ptr<LogWriter> logWriter; ///< declared last so it drains before anything it writes to is destroyed
 };
 
 std::string getTimeStamp(const std::string& fmt);
@@ -161,6 +341,21 @@ std::string getTimeStamp(const std::string& fmt);
 bool createDirectoryIfNeeded(const std::filesystem::path& path);
 void showAboutPage();
 
+struct InputTarget;
+
+/**
+ * @brief Resolves each input pattern to files and validates them. Files matched by more than one pattern are validated once.
+ * @param inputTargets if set, receives what each pattern resolved to, even if --fail-fast stopped the run before it was searched
+ */
+void processInputPatterns(const std::vector<std::filesystem::path>& inputPatterns, MnxValidateContext& context, int argc, arg_char* argv[],
+                          std::vector<InputTarget>* inputTargets = nullptr);
+
+/// @brief Validates the inputs, then revalidates input files as they are created or modified until interrupted
+void watchInputPatterns(const std::vector<std::filesystem::path>& inputPatterns, MnxValidateContext& context, int argc, arg_char* argv[]);
+
+int runServer(MnxValidateContext& context, int argc, arg_char* argv[]); ///< Serves validation requests on #MnxValidateContext::serveSocketPath until stopped
+int runClient(const MnxValidateContext& context, int argc, arg_char* argv[]); ///< Forwards this command line to the server on #MnxValidateContext::clientSocketPath
+
 } // namespace mnxvalidate
 
 #ifdef MNXVALIDATE_TEST // this is defined on the command line by the test program
@@ -0,0 +1,283 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <chrono>
+#include <cctype>
+#include <iomanip>
+#include <stdexcept>
+
+#include "reportwriter.h"
+#include "timingstats.h"
+
+namespace mnxvalidate {
+
+namespace {
+
+double toMilliseconds(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+// Messages come from parsers and validators and may quote invalid utf-8 from the input, so replace rather than throw.
+std::string jsonString(const std::string& text)
+{
+    return json(text).dump(-1, ' ', false, json::error_handler_t::replace);
+}
+
+// ,"bytes":<n>,"phaseMs":{...} for the phases that ran, or nothing if timings were not requested
+std::string jsonTimings(const FileContext& file)
+{
+    if (!file.context.showTimings) {
+        return {};
+    }
+    std::ostringstream result;
+    result << ",\"bytes\":" << file.timings.bytesRead << ",\"phaseMs\":{";
+    bool first = true;
+    for (size_t phase = 0; phase < file.timings.phases.size(); phase++) {
+        if (const auto& duration = file.timings.phases[phase]) {
+            result << (first ? "" : ",") << '"' << phaseName(static_cast<ValidationPhase>(phase)) << "\":" << toMilliseconds(duration.value());
+            first = false;
+        }
+    }
+    result << '}';
+    return result.str();
+}
+
+std::string xmlEscape(const std::string& text)
+{
+    std::string result;
+    result.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+        case '&': result += "&amp;"; break;
+        case '<': result += "&lt;"; break;
+        case '>': result += "&gt;"; break;
+        case '"': result += "&quot;"; break;
+        case '\'': result += "&apos;"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20 && c != '\t' && c != '\n' && c != '\r') {
+                result += '?'; // not allowed in XML 1.0, even escaped
+            } else {
+                result += c;
+            }
+            break;
+        }
+    }
+    return result;
+}
+
+// Relative paths stay relative (SARIF resolves them against the run's working directory). Absolute paths become file URIs.
+std::string toUri(const std::filesystem::path& path)
+{
+    constexpr char kHexDigits[] = "0123456789ABCDEF";
+    std::string result = path.is_absolute() ? "file://" : "";
+    const std::string generic = utils::u8ToString(path.generic_u8string());
+    if (path.is_absolute() && !generic.starts_with('/')) {
+        result += '/'; // Windows drive letter
+    }
+    for (char c : generic) {
+        const auto u = static_cast<unsigned char>(c);
+        if (std::isalnum(u) || c == '-' || c == '.' || c == '_' || c == '~' || c == '/' || c == ':') {
+            result += c;
+        } else {
+            result += '%';
+            result += kHexDigits[u >> 4];
+            result += kHexDigits[u & 0xf];
+        }
+    }
+    return result;
+}
+
+class JsonlReportWriter : public ReportWriter
+{
+public:
+    explicit JsonlReportWriter(const std::filesystem::path& path)
+        : ReportWriter(path) {}
+
+    void writeFile(const FileContext& file) override
+    {
+        m_stream << "{\"file\":" << jsonString(utils::pathToString(file.inputPath))
+                 << ",\"status\":\"" << (file.diagnostics.empty() ? "passed" : "failed") << '"'
+                 << ",\"phase\":\"" << phaseName(file.phase) << '"'
+                 << ",\"durationMs\":" << toMilliseconds(file.duration)
+                 << jsonTimings(file)
+                 << ",\"errors\":[";
+        bool first = true;
+        for (const auto& diagnostic : file.diagnostics) {
+            m_stream << (first ? "" : ",") << "{\"phase\":\"" << phaseName(diagnostic.phase) << '"'
+                     << ",\"pointer\":" << jsonString(diagnostic.pointer)
+                     << ",\"message\":" << jsonString(diagnostic.message) << '}';
+            first = false;
+        }
+        m_stream << "]}\n";
+    }
+
+    // The summary is a final record of its own, with no "file" member.
+    void finish(const TimingStats* timings) override
+    {
+        if (timings) {
+            m_stream << "{\"timings\":" << timings->toJson().dump(-1, ' ', false, json::error_handler_t::replace) << "}\n";
+        }
+        m_stream.close();
+    }
+};
+
+class SarifReportWriter : public ReportWriter
+{
+public:
+    SarifReportWriter(const std::filesystem::path& path, const std::string& toolName)
+        : ReportWriter(path)
+    {
+        m_stream << "{\"$schema\":\"https://json.schemastore.org/sarif-2.1.0.json\",\"version\":\"2.1.0\",\"runs\":[{"
+                 << "\"tool\":{\"driver\":{\"name\":" << jsonString(toolName)
+                 << ",\"version\":\"" << MNXVALIDATE_VERSION << "\""
+                 << ",\"informationUri\":\"https://github.com/rpatters1/mnxvalidate\""
+                 << ",\"rules\":[";
+        for (auto phase : { ValidationPhase::Read, ValidationPhase::Parse, ValidationPhase::Schema, ValidationPhase::Semantic }) {
+            m_stream << (phase == ValidationPhase::Read ? "" : ",") << "{\"id\":\"" << phaseName(phase) << "\"}";
+        }
+        m_stream << "]}},\"results\":[\n";
+    }
+
+    // A passing file is a "pass" result, so that every file's duration is in the report.
+    void writeFile(const FileContext& file) override
+    {
+        const std::string location = "\"locations\":[{\"physicalLocation\":{\"artifactLocation\":{\"uri\":" + jsonString(toUri(file.inputPath)) + "}}";
+        std::ostringstream properties;
+        properties << "\"properties\":{\"durationMs\":" << toMilliseconds(file.duration) << jsonTimings(file) << '}';
+        if (file.diagnostics.empty()) {
+            writeSeparator();
+            m_stream << "{\"ruleId\":\"" << phaseName(file.phase) << "\",\"kind\":\"pass\",\"level\":\"none\""
+                     << ",\"message\":{\"text\":\"Validation succeeded.\"}," << location << "}]," << properties.str() << '}';
+            return;
+        }
+        for (const auto& diagnostic : file.diagnostics) {
+            writeSeparator();
+            m_stream << "{\"ruleId\":\"" << phaseName(diagnostic.phase) << "\",\"kind\":\"fail\",\"level\":\"error\""
+                     << ",\"message\":{\"text\":" << jsonString(diagnostic.message) << "}," << location;
+            if (!diagnostic.pointer.empty()) {
+                m_stream << ",\"logicalLocations\":[{\"fullyQualifiedName\":" << jsonString(diagnostic.pointer) << ",\"kind\":\"element\"}]";
+            }
+            m_stream << "}]," << properties.str() << '}';
+        }
+    }
+
+    void finish(const TimingStats* timings) override
+    {
+        m_stream << "\n]";
+        if (timings) {
+            m_stream << ",\"properties\":{\"timings\":" << timings->toJson().dump(-1, ' ', false, json::error_handler_t::replace) << '}';
+        }
+        m_stream << "}]}\n";
+        m_stream.close();
+    }
+
+private:
+    void writeSeparator()
+    {
+        if (m_hasResults) {
+            m_stream << ",\n";
+        }
+        m_hasResults = true;
+    }
+
+    bool m_hasResults{};
+};
+
+// The suite's totals are not known until the end, and JUnit consumers count the test cases themselves, so they are omitted.
+// For the same reason there is nowhere to put a timing summary: suite properties must precede the test cases.
+class JunitReportWriter : public ReportWriter
+{
+public:
+    JunitReportWriter(const std::filesystem::path& path, const std::string& toolName)
+        : ReportWriter(path), m_toolName(xmlEscape(toolName))
+    {
+        m_stream << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                 << "<testsuites name=\"" << m_toolName << "\">\n"
+                 << "<testsuite name=\"" << m_toolName << "\">\n";
+    }
+
+    void writeFile(const FileContext& file) override
+    {
+        m_stream << "  <testcase classname=\"" << m_toolName << '.' << phaseName(file.phase)
+                 << "\" name=\"" << xmlEscape(utils::pathToString(file.inputPath))
+                 << "\" time=\"" << std::fixed << std::setprecision(6)
+                 << std::chrono::duration<double>(file.duration).count() << std::defaultfloat << '"';
+        if (file.diagnostics.empty() && !file.context.showTimings) {
+            m_stream << "/>\n";
+            return;
+        }
+        m_stream << ">\n";
+        if (file.context.showTimings) {
+            m_stream << "    <properties>\n      <property name=\"bytes\" value=\"" << file.timings.bytesRead << "\"/>\n";
+            for (size_t phase = 0; phase < file.timings.phases.size(); phase++) {
+                if (const auto& duration = file.timings.phases[phase]) {
+                    m_stream << "      <property name=\"" << phaseName(static_cast<ValidationPhase>(phase)) << "Ms\" value=\""
+                             << toMilliseconds(duration.value()) << "\"/>\n";
+                }
+            }
+            m_stream << "    </properties>\n";
+        }
+        if (file.diagnostics.empty()) {
+            m_stream << "  </testcase>\n";
+            return;
+        }
+        const auto& firstError = file.diagnostics.front();
+        m_stream << "    <failure type=\"" << phaseName(firstError.phase) << "\" message=\"" << xmlEscape(firstError.message) << "\">";
+        for (const auto& diagnostic : file.diagnostics) {
+            std::string line = phaseName(diagnostic.phase) + ": ";
+            if (!diagnostic.pointer.empty()) {
+                line += diagnostic.pointer + ": ";
+            }
+            m_stream << xmlEscape(line + diagnostic.message) << '\n';
+        }
+        m_stream << "</failure>\n  </testcase>\n";
+    }
+
+    void finish(const TimingStats*) override
+    {
+        m_stream << "</testsuite>\n</testsuites>\n";
+        m_stream.close();
+    }
+
+private:
+    std::string m_toolName;
+};
+
+} // namespace
+
+ReportWriter::ReportWriter(const std::filesystem::path& path)
+{
+    m_stream.exceptions(std::ios::failbit | std::ios::badbit);
+    m_stream.open(path, std::ios::binary | std::ios::trunc);
+}
+
+std::unique_ptr<ReportWriter> ReportWriter::create(ReportFormat format, const std::filesystem::path& path, const std::string& toolName)
+{
+    switch (format) {
+    case ReportFormat::Jsonl: return std::make_unique<JsonlReportWriter>(path);
+    case ReportFormat::Sarif: return std::make_unique<SarifReportWriter>(path, toolName);
+    case ReportFormat::Junit: return std::make_unique<JunitReportWriter>(path, toolName);
+    }
+    throw std::invalid_argument("Unknown report format.");
+}
+
+} // namespace mnxvalidate
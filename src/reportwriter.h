@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <string>
+#include <memory>
+#include <fstream>
+#include <filesystem>
+
+#include "mnxvalidate.h"
+
+namespace mnxvalidate {
+
+/**
+ * @brief Writes a machine-readable report of the validated files.
+ *
+ * Each file's record is written as soon as the file is logged, so the report never holds more than one file
+ * in memory. #finish writes whatever the format needs after the last record and closes the file.
+ * With --timings, each record also carries the file's size and phase durations.
+ */
+class ReportWriter
+{
+public:
+    /// @brief Opens a report of the given format at @p path. Throws if the file cannot be created.
+    static std::unique_ptr<ReportWriter> create(ReportFormat format, const std::filesystem::path& path, const std::string& toolName);
+
+    virtual ~ReportWriter() = default;
+
+    virtual void writeFile(const FileContext& file) = 0; ///< Writes the record for one validated file
+
+    /// @brief Completes the report, including the run's timing summary if @p timings is not null
+    virtual void finish(const TimingStats* timings) = 0;
+
+protected:
+    explicit ReportWriter(const std::filesystem::path& path);
+
+    std::ofstream m_stream;
+};
+
+} // namespace mnxvalidate
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <type_traits>
+#include <stdexcept>
+
+#include "schemavalidator.h"
+#include "streamingschema.h"
+#include "generatedschema.h"
+
+namespace {
+
+#include "mnx_schema.xxd"
+
+// Thrown to abandon validation at the error limit. It is not a std::exception, so the validator cannot mistake it for one of its own.
+struct ErrorLimitReached {};
+
+class ErrorCollector : public nlohmann::json_schema::error_handler
+{
+public:
+    explicit ErrorCollector(size_t maxErrors) : m_maxErrors(maxErrors) {}
+
+    std::vector<mnxvalidate::SchemaError> errors;
+
+    void error(const nlohmann::json::json_pointer& ptr, const nlohmann::json&, const std::string& message) override
+    {
+        errors.push_back({ ptr.to_string(), message });
+        if (m_maxErrors && errors.size() >= m_maxErrors) {
+            throw ErrorLimitReached();
+        }
+    }
+
+private:
+    size_t m_maxErrors;
+};
+
+} // namespace
+
+namespace mnxvalidate {
+
+SchemaValidator::SchemaValidator(const std::optional<std::string>& schemaText)
+    : m_schemaText(schemaText.value_or(std::string(reinterpret_cast<const char*>(mnx_schema_json), mnx_schema_json_len)))
+{
+    const auto schema = nlohmann::json::parse(m_schemaText);
+    // the code generated from the embedded schema replaces the generic validator, which then need not be compiled
+    m_generated = !schemaText.has_value() && generated::isAvailable();
+    if (!m_generated) {
+        m_validator.set_root_schema(schema);
+    }
+    try {
+        m_streaming = std::make_unique<const StreamingSchema>(schema);
+    } catch (const std::exception& e) {
+        // the DOM validator still checks everything, so a schema the streaming one cannot handle only costs speed
+        m_streamingUnavailableReason = e.what();
+    }
+}
+
+SchemaValidator::~SchemaValidator() = default;
+
+SchemaValidationResult SchemaValidator::validate(const mnx::Document& document, size_t maxErrors) const
+{
+    ErrorCollector errorCollector(maxErrors);
+    if (m_generated) {
+        if constexpr (std::is_same_v<mnx::json, nlohmann::json>) {
+            return generated::validate(*document.root(), maxErrors);
+        } else {
+            return generated::validate(nlohmann::json(*document.root()), maxErrors);
+        }
+    }
+    bool truncated = false;
+    try {
+        if constexpr (std::is_same_v<mnx::json, nlohmann::json>) {
+            m_validator.validate(*document.root(), errorCollector);
+        } else {
+            m_validator.validate(nlohmann::json(*document.root()), errorCollector); // the validator only accepts nlohmann::json
+        }
+    } catch (const ErrorLimitReached&) {
+        truncated = true;
+    }
+    return { std::move(errorCollector.errors), truncated };
+}
+
+SchemaValidationResult SchemaValidator::validateText(std::string_view jsonText, size_t maxErrors) const
+{
+    if (!m_streaming) {
+        throw std::logic_error("The schema cannot be streamed: " + m_streamingUnavailableReason);
+    }
+    return m_streaming->validate(jsonText, maxErrors);
+}
+
+SchemaValidationResult SchemaValidator::validateText(Decompressor& input, size_t maxErrors) const
+{
+    if (!m_streaming) {
+        throw std::logic_error("The schema cannot be streamed: " + m_streamingUnavailableReason);
+    }
+    return m_streaming->validate(input, maxErrors);
+}
+
+} // namespace mnxvalidate
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <memory>
+#include <string_view>
+
+#include "mnxdom.h"
+#include "nlohmann/json-schema.hpp"
+
+namespace mnxvalidate {
+
+/// @brief A single error found by schema validation
+struct SchemaError
+{
+    std::string pointer;        ///< the json pointer to the offending value
+    std::string message;        ///< the validator's description of the error
+
+    std::string to_string() const
+    { return (pointer.empty() ? std::string("/") : pointer) + ": " + message; }
+};
+
+/// @brief The result of validating one document against a #SchemaValidator
+struct SchemaValidationResult
+{
+    std::vector<SchemaError> errors;
+    bool truncated{};           ///< validation stopped at the error limit, so there may be more errors
+
+    explicit operator bool() const { return errors.empty(); }
+};
+
+class StreamingSchema;
+class Decompressor;
+
+/**
+ * @brief A JSON schema that has been parsed and compiled once, for validating any number of documents.
+ *
+ * Building the validator is the expensive part of schema validation, so a run builds one of these up front
+ * rather than per file. #validate does not modify the validator, so worker threads can share one instance.
+ */
+class SchemaValidator
+{
+public:
+    /**
+     * @brief Compiles the schema text, or uses the embedded MNX schema if none is supplied. Throws if the schema is invalid.
+     *
+     * The embedded schema is checked by code generated from it at build time, unless the generator could not handle it.
+     * Passing the embedded schema's text selects the generic validator instead.
+     */
+    explicit SchemaValidator(const std::optional<std::string>& schemaText = std::nullopt);
+    ~SchemaValidator();
+
+    /**
+     * @brief Validates the document against the compiled schema
+     * @param document the document to validate
+     * @param maxErrors stop validating once this many errors have been found (0 means no limit)
+     */
+    SchemaValidationResult validate(const mnx::Document& document, size_t maxErrors = 0) const;
+
+    /// @brief True if #validate uses the code generated from the embedded schema at build time rather than the generic validator
+    bool usesGeneratedCode() const { return m_generated; }
+
+    /// @brief True if the schema can also be checked while json text is parsed, with #validateText
+    bool canStream() const { return m_streaming != nullptr; }
+
+    /// @brief Why #canStream is false, for logging
+    const std::string& streamingUnavailableReason() const { return m_streamingUnavailableReason; }
+
+    /**
+     * @brief Parses and validates json text in one pass, without building a document. Requires #canStream.
+     * @param jsonText the document
+     * @param maxErrors stop validating once this many errors have been found (0 means no limit)
+     * @throws nlohmann::json::exception if the text is not valid json
+     */
+    SchemaValidationResult validateText(std::string_view jsonText, size_t maxErrors = 0) const;
+
+    /// @brief Like #validateText, reading the json text as it is decompressed
+    SchemaValidationResult validateText(Decompressor& input, size_t maxErrors = 0) const;
+
+    /// @brief The text of the compiled schema
+    const std::string& schemaText() const { return m_schemaText; }
+
+private:
+    std::string m_schemaText;
+    nlohmann::json_schema::json_validator m_validator;
+    bool m_generated{};
+    std::unique_ptr<const StreamingSchema> m_streaming;
+    std::string m_streamingUnavailableReason;
+};
+
+} // namespace mnxvalidate
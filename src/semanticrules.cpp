@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "semanticrules.h"
+
+namespace mnxvalidate {
+
+namespace {
+
+struct RuleInfo
+{
+    std::string_view name;
+    std::string_view description;
+};
+
+constexpr std::array<RuleInfo, kSemanticRuleCount> kRuleInfo{ {
+    { "ties", "tie targets, lv and targetType, and that tied notes match in part, pitch and kit component" },
+    { "slurs", "slur targets, start notes and end notes" },
+    { "beams", "beam contents, order, voices, levels and hooks" },
+    { "ottavas", "ottavas that end before they begin" },
+    { "lyrics", "lyric line labels in events, and global.lyrics line metadata and order" },
+    { "layouts", "layouts, scores, pages, systems and layout changes, and the parts and staves they refer to" },
+} };
+
+/// @brief The members of a part that skipped groups own, by the objects they belong to
+struct PartMembers
+{
+    std::vector<std::string_view> measureKeys;     ///< members of part-measures: beams and ottavas
+    std::vector<std::string_view> eventKeys;       ///< members of events: slurs and lyrics
+    bool noteTies{};                                ///< the ties of notes and kit notes
+
+    bool empty() const { return measureKeys.empty() && eventKeys.empty() && !noteTies; }
+};
+
+/// @brief Erases the @p keys members of @p object, if it is an object
+void eraseMembers(mnx::json& object, const std::vector<std::string_view>& keys)
+{
+    if (!object.is_object()) {
+        return;
+    }
+    for (const auto key : keys) {
+        if (const auto it = object.find(key); it != object.end()) {
+            object.erase(it);
+        }
+    }
+}
+
+/// @brief Erases members from the events of a sequence's content, including those nested in tuplets, grace notes and tremolos
+void eraseEventMembers(mnx::json& content, const PartMembers& members)
+{
+    if (!content.is_array()) {
+        return;
+    }
+    for (auto& item : content) {
+        if (!item.is_object()) {
+            continue;
+        }
+        if (const auto type = item.find("type"); type != item.end() && *type == "event") {
+            eraseMembers(item, members.eventKeys);
+            for (const auto notesKey : { "notes", "kitNotes" }) {
+                if (const auto notes = item.find(notesKey); members.noteTies && notes != item.end() && notes->is_array()) {
+                    for (auto& note : *notes) {
+                        eraseMembers(note, { "ties" });
+                    }
+                }
+            }
+        } else if (const auto nested = item.find("content"); nested != item.end()) {
+            eraseEventMembers(*nested, members);
+        }
+    }
+}
+
+/// @brief Erases members from the measures of every part
+void erasePartMembers(mnx::json& parts, const PartMembers& members)
+{
+    if (!parts.is_array()) {
+        return;
+    }
+    for (auto& part : parts) {
+        const auto measures = part.is_object() ? part.find("measures") : part.end();
+        if (measures == part.end() || !measures->is_array()) {
+            continue;
+        }
+        for (auto& measure : *measures) {
+            eraseMembers(measure, members.measureKeys);
+            const auto sequences = measure.is_object() ? measure.find("sequences") : measure.end();
+            if (sequences == measure.end() || !sequences->is_array()) {
+                continue;
+            }
+            for (auto& sequence : *sequences) {
+                if (const auto content = sequence.is_object() ? sequence.find("content") : sequence.end(); content != sequence.end()) {
+                    eraseEventMembers(*content, members);
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+std::string_view semanticRuleName(SemanticRule rule)
+{
+    return kRuleInfo[static_cast<size_t>(rule)].name;
+}
+
+std::string_view semanticRuleDescription(SemanticRule rule)
+{
+    return kRuleInfo[static_cast<size_t>(rule)].description;
+}
+
+std::optional<SemanticRule> semanticRuleFromName(std::string_view name)
+{
+    for (const auto rule : kSemanticRules) {
+        if (semanticRuleName(rule) == name) {
+            return rule;
+        }
+    }
+    return std::nullopt;
+}
+
+void removeSkippedRuleContent(mnx::json& root, const SemanticRuleSet& skipped)
+{
+    if (skipped.none() || !root.is_object()) {
+        return;
+    }
+    auto isSkipped = [&](SemanticRule rule) { return skipped.test(static_cast<size_t>(rule)); };
+
+    // Each of these members is read by only one group. They are erased only where the schema puts them,
+    // so that members with the same name elsewhere, such as in extension data, are kept.
+    PartMembers partMembers;
+    for (const auto& [rule, key] : { std::pair{ SemanticRule::Beams, "beams" }, std::pair{ SemanticRule::Ottavas, "ottavas" } }) {
+        if (isSkipped(rule)) {
+            partMembers.measureKeys.push_back(key);
+        }
+    }
+    for (const auto& [rule, key] : { std::pair{ SemanticRule::Slurs, "slurs" }, std::pair{ SemanticRule::Lyrics, "lyrics" } }) {
+        if (isSkipped(rule)) {
+            partMembers.eventKeys.push_back(key);
+        }
+    }
+    partMembers.noteTies = isSkipped(SemanticRule::Ties);
+    if (const auto parts = root.find("parts"); parts != root.end() && !partMembers.empty()) {
+        erasePartMembers(*parts, partMembers);
+    }
+    if (isSkipped(SemanticRule::Lyrics)) {
+        if (const auto global = root.find("global"); global != root.end() && global->is_object()) {
+            global->erase("lyrics");
+        }
+    }
+    if (isSkipped(SemanticRule::Layouts)) {
+        root.erase("layouts");
+        root.erase("scores");
+    }
+}
+
+} // namespace mnxvalidate
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <string_view>
+#include <optional>
+#include <array>
+#include <bitset>
+
+#include "mnxdom.h"
+
+namespace mnxvalidate {
+
+/**
+ * @brief The groups of semantic checks that can be turned off, named after the checks in notes/validation_ideas.md.
+ *
+ * The checks themselves are made by mnxdom in one pass that cannot be told to leave any out. A group is skipped by
+ * removing the values only its checks read before the pass, so a skipped group costs nothing beyond that removal.
+ * Checks that read the same values as others (ids, durations, tuplets, clefs, staves, voices and kits) are always made.
+ */
+enum class SemanticRule
+{
+    Ties,       ///< tie targets, lv and targetType, and that tied notes match in part, pitch and kit component
+    Slurs,      ///< slur targets, start notes and end notes
+    Beams,      ///< beam contents, order, voices, levels and hooks
+    Ottavas,    ///< ottavas that end before they begin
+    Lyrics,     ///< lyric line labels in events, and global.lyrics line metadata and order
+    Layouts     ///< layouts, scores, pages, systems and layout changes, and the parts and staves they refer to
+};
+
+constexpr size_t kSemanticRuleCount = 6;
+using SemanticRuleSet = std::bitset<kSemanticRuleCount>; ///< indexed by #SemanticRule
+
+/// @brief Every rule group, in the order they are listed
+constexpr std::array<SemanticRule, kSemanticRuleCount> kSemanticRules{ SemanticRule::Ties, SemanticRule::Slurs, SemanticRule::Beams,
+                                                                       SemanticRule::Ottavas, SemanticRule::Lyrics, SemanticRule::Layouts };
+
+std::string_view semanticRuleName(SemanticRule rule);            ///< the name used by --rules and --skip-rules
+std::string_view semanticRuleDescription(SemanticRule rule);     ///< what the group checks, for --list-rules
+std::optional<SemanticRule> semanticRuleFromName(std::string_view name);
+
+/// @brief Removes from a document that passed schema validation the values that only the @p skipped groups check.
+void removeSkippedRuleContent(mnx::json& root, const SemanticRuleSet& skipped);
+
+} // namespace mnxvalidate
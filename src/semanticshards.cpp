@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <unordered_map>
+#include <exception>
+
+#include "semanticshards.h"
+
+namespace mnxvalidate {
+
+namespace {
+
+/// @brief A part-measure with its clefs and no music, enough for the layouts to be checked against
+mnx::json measureOutline(const mnx::json& measure)
+{
+    mnx::json outline = mnx::json::object();
+    if (measure.is_object()) {
+        if (const auto clefs = measure.find("clefs"); clefs != measure.end()) {
+            outline["clefs"] = *clefs;
+        }
+    }
+    outline["sequences"] = mnx::json::array();
+    return outline;
+}
+
+mnx::json partOutline(const mnx::json& part)
+{
+    if (!part.is_object()) {
+        return part;
+    }
+    mnx::json outline = mnx::json::object();
+    for (auto it = part.begin(); it != part.end(); ++it) {
+        if (it.key() != "measures") {
+            outline[it.key()] = it.value();
+        } else if (it->is_array()) {
+            auto& measures = outline["measures"] = mnx::json::array();
+            for (const auto& measure : *it) {
+                measures.push_back(measureOutline(measure));
+            }
+        }
+    }
+    return outline;
+}
+
+void collectIds(const mnx::json& value, std::vector<std::string_view>& ids)
+{
+    if (value.is_object()) {
+        for (auto it = value.begin(); it != value.end(); ++it) {
+            if (it.key() == "id" && it->is_string()) {
+                ids.push_back(it->template get_ref<const mnx::json::string_t&>());
+            } else {
+                collectIds(*it, ids);
+            }
+        }
+    } else if (value.is_array()) {
+        for (const auto& element : value) {
+            collectIds(element, ids);
+        }
+    }
+}
+
+bool isValid(const std::shared_ptr<mnx::json>& root)
+{
+    try {
+        mnx::Document document(root);
+        return mnx::validation::semanticValidate(document).errors.empty();
+    } catch (const std::exception&) {
+        return false; // the serial check fails the same way and reports it
+    }
+}
+
+/// @brief Moves a document's parts into the groups and, when it goes out of scope, back again
+class PartLoan
+{
+public:
+    PartLoan(mnx::json& parts, const std::vector<size_t>& groupStarts, const mnx::json& context)
+        : m_parts(parts), m_groupStarts(groupStarts)
+    {
+        for (size_t group = 0; group + 1 < m_groupStarts.size(); group++) {
+            auto root = std::make_shared<mnx::json>(context);
+            auto& groupParts = (*root)["parts"] = mnx::json::array();
+            for (size_t x = m_groupStarts[group]; x < m_groupStarts[group + 1]; x++) {
+                groupParts.push_back(std::move(m_parts[x]));
+            }
+            m_roots.push_back(std::move(root));
+        }
+    }
+
+    ~PartLoan()
+    {
+        for (size_t group = 0; group < m_roots.size(); group++) {
+            auto& groupParts = (*m_roots[group])["parts"];
+            for (size_t x = m_groupStarts[group]; x < m_groupStarts[group + 1]; x++) {
+                m_parts[x] = std::move(groupParts[x - m_groupStarts[group]]);
+            }
+        }
+    }
+
+    PartLoan(const PartLoan&) = delete;
+    PartLoan& operator=(const PartLoan&) = delete;
+
+    const std::vector<std::shared_ptr<mnx::json>>& roots() const { return m_roots; }
+
+private:
+    mnx::json& m_parts;
+    const std::vector<size_t>& m_groupStarts;
+    std::vector<std::shared_ptr<mnx::json>> m_roots;
+};
+
+} // namespace
+
+size_t semanticWorkload(const mnx::json& root)
+{
+    size_t result = 0;
+    const auto parts = root.find("parts");
+    if (parts != root.end() && parts->is_array()) {
+        for (const auto& part : *parts) {
+            const auto measures = part.is_object() ? part.find("measures") : part.end();
+            if (measures != part.end() && measures->is_array()) {
+                result += measures->size();
+            }
+        }
+    }
+    return result;
+}
+
+bool semanticShardsValid(mnx::json& root, unsigned threads)
+{
+    const auto parts = root.find("parts");
+    if (threads < 2 || parts == root.end() || !parts->is_array() || parts->size() < 2) {
+        return false;
+    }
+
+    // consecutive groups of parts with about the same number of measures
+    const size_t groupCount = std::min<size_t>(threads, parts->size());
+    const size_t totalWeight = semanticWorkload(root) + parts->size();
+    std::vector<size_t> groupStarts{ 0 };
+    size_t weight = 0;
+    for (size_t x = 0; x < parts->size() && groupStarts.size() < groupCount; x++) {
+        const auto measures = (*parts)[x].is_object() ? (*parts)[x].find("measures") : (*parts)[x].end();
+        weight += 1 + (measures != (*parts)[x].end() && measures->is_array() ? measures->size() : 0);
+        const size_t remainingParts = parts->size() - (x + 1);
+        const size_t remainingGroups = groupCount - groupStarts.size();
+        if ((weight * groupCount >= totalWeight * groupStarts.size() && remainingParts >= remainingGroups) || remainingParts == remainingGroups) {
+            groupStarts.push_back(x + 1);
+        }
+    }
+    groupStarts.push_back(parts->size());
+
+    mnx::json context = mnx::json::object();
+    std::shared_ptr<mnx::json> outline;
+    for (auto it = root.begin(); it != root.end(); ++it) {
+        if (it.key() != "parts" && it.key() != "layouts" && it.key() != "scores") {
+            context[it.key()] = it.value();
+        }
+    }
+    if (root.contains("layouts") || root.contains("scores")) {
+        outline = std::make_shared<mnx::json>(context);
+        for (const char* key : { "layouts", "scores" }) {
+            if (const auto it = root.find(key); it != root.end()) {
+                (*outline)[key] = *it;
+            }
+        }
+        auto& outlineParts = (*outline)["parts"] = mnx::json::array();
+        for (const auto& part : *parts) {
+            outlineParts.push_back(partOutline(part));
+        }
+    }
+
+    const PartLoan loan(*parts, groupStarts, context);
+    const size_t groups = loan.roots().size();
+    std::vector<std::vector<std::string_view>> groupIds(groups + 1);
+    std::atomic<bool> failed{};
+    std::atomic<size_t> nextTask{};
+    auto work = [&]() {
+        for (size_t x = nextTask++; x <= groups && !failed; x = nextTask++) {
+            if (x < groups) {
+                collectIds(loan.roots()[x]->at("parts"), groupIds[x]);
+                if (!isValid(loan.roots()[x])) {
+                    failed = true;
+                }
+            } else if (outline && !isValid(outline)) {
+                failed = true;
+            }
+        }
+    };
+    const size_t workerCount = std::min<size_t>(threads, groups + 1);
+    std::vector<std::thread> workers;
+    for (size_t x = 1; x < workerCount; x++) {
+        workers.emplace_back(work);
+    }
+    work(); // the calling thread is one of the workers
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    if (failed) {
+        return false;
+    }
+
+    // ids outside the parts belong to every group, so they may not appear in any part either
+    collectIds(context, groupIds[groups]);
+    for (const char* key : { "layouts", "scores" }) {
+        if (const auto it = root.find(key); it != root.end()) {
+            collectIds(*it, groupIds[groups]);
+        }
+    }
+    std::unordered_map<std::string_view, size_t> idGroups;
+    for (size_t group = 0; group < groupIds.size(); group++) {
+        for (const auto id : groupIds[group]) {
+            if (const auto [it, inserted] = idGroups.emplace(id, group); !inserted && it->second != group) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace mnxvalidate
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+
+#include "mnxdom.h"
+
+namespace mnxvalidate {
+
+/// @brief The number of measures summed over every part, which is what #ValidatorOptions::semanticSplitThreshold is compared with
+size_t semanticWorkload(const mnx::json& root);
+
+/**
+ * @brief Checks the semantics of a document that passed schema validation on up to @p threads threads.
+ *
+ * The parts are divided into groups, and each group is validated as a document of its own that also holds everything
+ * outside the parts except the layouts and scores. The layouts and scores are validated against an outline of every
+ * part, with the measures' clefs but none of their music. Ids are compared across the groups, since each group
+ * only sees its own.
+ *
+ * The groups cannot say which of a document's errors they found, or in what order the serial check would report them,
+ * so this only decides whether a document is valid. The parts are moved into the groups rather than copied, and are
+ * back in @p root when this returns.
+ *
+ * @return true if every group and the outline are valid, so the whole document is. false if it has fewer than two
+ * parts or anything failed, in which case the serial check must be run to report the errors.
+ */
+bool semanticShardsValid(mnx::json& root, unsigned threads);
+
+} // namespace mnxvalidate
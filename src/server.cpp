@@ -0,0 +1,470 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <unordered_set>
+#include <stdexcept>
+#include <csignal>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <iterator>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#include "mnxvalidate.h"
+#include "documentstream.h"
+
+// Server protocol
+// ---------------
+// Every message in either direction is a frame: a 4-byte big-endian length, then that many bytes,
+// the first of which is the frame type. A client sends any number of request frames followed by
+// kFrameEnd. The server answers with kFrameOutput frames and then exactly one kFrameExit.
+//
+//  client -> server
+//    'A' <utf-8 argument>              a command line argument, as the CLI would accept it
+//    'D' <name> '\0' <document bytes>  a document to validate in memory, reported as <name>
+//    'S'                               stop the server
+//    'E'                               end of request
+//  server -> client
+//    'O' <utf-8 text>                  log output
+//    'X' <decimal exit code>           the request is complete
+
+namespace {
+
+constexpr char kFrameArgument = 'A';
+constexpr char kFrameDocument = 'D';
+constexpr char kFrameStop = 'S';
+constexpr char kFrameEnd = 'E';
+constexpr char kFrameOutput = 'O';
+constexpr char kFrameExit = 'X';
+constexpr std::uint32_t kMaxFrameSize = 1u << 30;
+
+/// An option whose value is the next argument. The client makes path values absolute, because the server has its own working directory.
+struct ValueOption
+{
+    std::string_view name;
+    bool isPath;
+};
+
+constexpr ValueOption kValueOptions[] = {
+    { "--log", false },
+    { "--schema", true },
+    { "--stdin-format", false },
+    { "--jobs", false },
+    { "--rules", false },
+    { "--skip-rules", false },
+    { "--rules-file", true },
+    { "--semantic-jobs", false },
+    { "--semantic-threshold", false },
+    { "--cache-dir", true },
+    { "--cache-max-size", false },
+    { "--report", true },
+    { "--report-format", false },
+    { "--max-errors", false },
+    { "--max-memory", false },
+    { "--timings-slowest", false },
+    { "--error-summary-top", false },
+    { "--serve", true },
+    { "--client", true },
+    { "--watch-debounce", false },
+};
+
+const ValueOption* findValueOption(std::string_view arg)
+{
+    const auto it = std::find_if(std::begin(kValueOptions), std::end(kValueOptions),
+        [arg](const ValueOption& option) { return option.name == arg; });
+    return it != std::end(kValueOptions) ? it : nullptr;
+}
+
+} // namespace
+
+namespace mnxvalidate {
+
+#ifdef _WIN32
+
+int runServer(MnxValidateContext&, int, arg_char*[])
+{
+    throw std::runtime_error("--serve is not supported on this platform");
+}
+
+int runClient(const MnxValidateContext&, int, arg_char*[])
+{
+    throw std::runtime_error("--client is not supported on this platform");
+}
+
+#else
+
+namespace {
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+extern "C" void handleStopSignal(int)
+{
+    stopRequested = 1;
+}
+
+class Socket
+{
+public:
+    explicit Socket(int fd) : m_fd(fd) {}
+    ~Socket() { if (m_fd >= 0) ::close(m_fd); }
+    Socket(const Socket&) = delete;
+    Socket& operator=(const Socket&) = delete;
+
+    int fd() const { return m_fd; }
+
+    void sendFrame(char type, std::string_view payload = {}) const
+    {
+        const auto size = static_cast<std::uint32_t>(payload.size() + 1);
+        const unsigned char header[] = { static_cast<unsigned char>(size >> 24), static_cast<unsigned char>(size >> 16),
+                                         static_cast<unsigned char>(size >> 8), static_cast<unsigned char>(size),
+                                         static_cast<unsigned char>(type) };
+        writeAll(header, sizeof(header));
+        writeAll(payload.data(), payload.size());
+    }
+
+    /// @brief reads the next frame. Returns false if the peer closed the connection.
+    bool readFrame(char& type, std::string& payload) const
+    {
+        unsigned char header[4];
+        if (!readAll(header, sizeof(header))) {
+            return false;
+        }
+        const std::uint32_t size = (std::uint32_t(header[0]) << 24) | (std::uint32_t(header[1]) << 16) | (std::uint32_t(header[2]) << 8) | header[3];
+        if (size == 0 || size > kMaxFrameSize) {
+            throw std::runtime_error("Invalid frame size received: " + std::to_string(size));
+        }
+        if (!readAll(&type, 1)) {
+            return false;
+        }
+        payload.resize(size - 1);
+        return readAll(payload.data(), payload.size());
+    }
+
+private:
+    void writeAll(const void* data, size_t size) const
+    {
+        const char* next = static_cast<const char*>(data);
+        while (size > 0) {
+            const ssize_t written = ::write(m_fd, next, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::string("Socket write failed: ") + std::strerror(errno));
+            }
+            next += written;
+            size -= static_cast<size_t>(written);
+        }
+    }
+
+    bool readAll(void* data, size_t size) const
+    {
+        char* next = static_cast<char*>(data);
+        while (size > 0) {
+            const ssize_t received = ::read(m_fd, next, size);
+            if (received == 0) {
+                return false;
+            }
+            if (received < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::string("Socket read failed: ") + std::strerror(errno));
+            }
+            next += received;
+            size -= static_cast<size_t>(received);
+        }
+        return true;
+    }
+
+    int m_fd;
+};
+
+sockaddr_un makeSocketAddress(const std::filesystem::path& socketPath)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    const std::string pathString = utils::pathToString(socketPath);
+    if (pathString.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Socket path is too long: " + pathString);
+    }
+    std::memcpy(address.sun_path, pathString.c_str(), pathString.size() + 1);
+    return address;
+}
+
+// Validates one request. The server's compiled schema and cache are reused unless the request's options need different ones.
+void handleRequest(const MnxValidateContext& server, const Socket& connection, const std::vector<std::string>& requestArgs,
+    const std::vector<std::pair<std::string, std::string>>& documents)
+{
+    MnxValidateContext context(server.programName);
+    std::ostringstream output;
+    context.messageOutput = &output;
+    std::vector<std::string> argStrings{ server.programName };
+    argStrings.insert(argStrings.end(), requestArgs.begin(), requestArgs.end());
+    std::vector<arg_char*> argv;
+    for (auto& arg : argStrings) {
+        argv.push_back(arg.data());
+    }
+    const int argc = static_cast<int>(argv.size());
+    try {
+        const auto args = context.parseOptions(argc, argv.data());
+        if (context.serveSocketPath || context.clientSocketPath) {
+            throw std::invalid_argument("--serve and --client cannot be sent to a server");
+        }
+        if (context.reportPath) {
+            throw std::invalid_argument("--report cannot be sent to a server");
+        }
+        if (context.watch) {
+            throw std::invalid_argument("--watch cannot be sent to a server");
+        }
+        if (context.listRules) {
+            throw std::invalid_argument("--list-rules cannot be sent to a server");
+        }
+        if (std::find(args.begin(), args.end(), std::string_view("-")) != args.end()) {
+            throw std::invalid_argument("stdin streams cannot be sent to a server");
+        }
+        context.noLog = true; // output goes back to the client
+        if (!context.jobs) {
+            context.jobs = server.jobs;
+        }
+        if (!context.mnxSchemaPath) {
+            context.schemaValidator = server.schemaValidator;
+        }
+        const bool sharesCache = !context.cacheDir && !context.mnxSchemaPath && context.schemaOnly == server.schemaOnly
+            && context.maxErrors == server.maxErrors && context.rulesToSkip() == server.rulesToSkip();
+        if (sharesCache) {
+            context.cache = server.cache;
+        }
+        context.startTimings();
+        context.startErrorSummary();
+        processInputPatterns(std::vector<std::filesystem::path>(args.begin(), args.end()), context, argc, argv.data());
+        context.loadSchema(); // in case there were only in-memory documents
+        for (const auto& [name, contents] : documents) {
+            if (context.stopRequested) {
+                break;
+            }
+            context.flushFileLog(*context.validateFile(utils::utf8ToPath(name), contents));
+        }
+        if (sharesCache) {
+            context.cache.reset(); // the server reports and trims its own cache
+        }
+        context.closeCache();
+        context.logTimings();
+        context.logErrorSummary();
+    } catch (const std::exception& e) {
+        context.logMessage(LogMsg() << e.what(), LogSeverity::Error);
+    }
+    context.logTruncation();
+    connection.sendFrame(kFrameOutput, output.str());
+    connection.sendFrame(kFrameExit, std::to_string(context.exitCode()));
+}
+
+// Reads and answers requests on the connection until the client disconnects. Returns true if the client asked the server to stop.
+bool serveConnection(const MnxValidateContext& server, const Socket& connection)
+{
+    std::vector<std::string> requestArgs;
+    std::vector<std::pair<std::string, std::string>> documents;
+    char type{};
+    std::string payload;
+    while (connection.readFrame(type, payload)) {
+        switch (type) {
+        case kFrameArgument:
+            requestArgs.push_back(std::move(payload));
+            break;
+        case kFrameDocument: {
+            const auto separator = payload.find('\0');
+            if (separator == std::string::npos) {
+                throw std::runtime_error("Document frame has no name");
+            }
+            documents.emplace_back(payload.substr(0, separator), payload.substr(separator + 1));
+            break;
+        }
+        case kFrameStop:
+            connection.sendFrame(kFrameExit, "0");
+            return true;
+        case kFrameEnd:
+            handleRequest(server, connection, requestArgs, documents);
+            requestArgs.clear();
+            documents.clear();
+            break;
+        default:
+            throw std::runtime_error("Unknown frame type received: " + std::to_string(int(type)));
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+int runServer(MnxValidateContext& context, int argc, arg_char* argv[])
+{
+    const auto socketPath = context.serveSocketPath.value();
+    const auto address = makeSocketAddress(socketPath);
+    context.startLogging(std::filesystem::current_path(), argc, argv);
+    context.loadSchema();
+    context.openCache();
+
+    Socket listener(::socket(AF_UNIX, SOCK_STREAM, 0));
+    if (listener.fd() < 0) {
+        throw std::runtime_error(std::string("Unable to create socket: ") + std::strerror(errno));
+    }
+    std::error_code ec;
+    std::filesystem::remove(socketPath, ec); // a stale socket from a server that did not shut down cleanly
+    if (::bind(listener.fd(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || ::listen(listener.fd(), SOMAXCONN) != 0) {
+        throw std::runtime_error("Unable to listen on " + utils::pathToString(socketPath) + ": " + std::strerror(errno));
+    }
+    std::signal(SIGPIPE, SIG_IGN);
+    stopRequested = 0;
+    std::signal(SIGINT, handleStopSignal);
+    std::signal(SIGTERM, handleStopSignal);
+    context.logMessage(LogMsg() << "Listening on " << utils::pathToString(socketPath), LogSeverity::Verbose);
+
+    // shared with the connection threads, which may still be finishing when this function returns
+    struct ServerState
+    {
+        std::atomic<size_t> activeConnections{};
+        std::atomic<bool> stopping{};
+        std::mutex mutex;
+        std::unordered_set<int> connectionFds;  ///< open connections, guarded by #mutex
+    };
+    auto state = std::make_shared<ServerState>();
+    while (!stopRequested && !state->stopping) {
+        pollfd pending{ listener.fd(), POLLIN, 0 };
+        if (::poll(&pending, 1, 250) <= 0) {
+            continue; // timeout or signal: check whether to stop
+        }
+        const int fd = ::accept(listener.fd(), nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+        state->activeConnections++;
+        {
+            std::lock_guard lock(state->mutex);
+            state->connectionFds.insert(fd);
+        }
+        std::thread([&context, state, fd]() {
+            {
+                Socket connection(fd);
+                try {
+                    if (serveConnection(context, connection)) {
+                        state->stopping = true;
+                    }
+                } catch (const std::exception&) {
+                    // the client went away or sent garbage: drop the connection
+                }
+                std::lock_guard lock(state->mutex);
+                state->connectionFds.erase(fd); // before the descriptor is closed and can be reused
+            }
+            state->activeConnections--;
+            state->activeConnections.notify_all();
+        }).detach();
+    }
+    {
+        // A client that stays connected without sending a request would otherwise keep the server running.
+        // Shutting down only the reading side lets a request that is being validated still send its result.
+        std::lock_guard lock(state->mutex);
+        for (const int fd : state->connectionFds) {
+            ::shutdown(fd, SHUT_RD);
+        }
+    }
+    for (size_t active = state->activeConnections; active > 0; active = state->activeConnections) {
+        state->activeConnections.wait(active);
+    }
+    std::filesystem::remove(socketPath, ec);
+    context.logMessage(LogMsg() << "Server stopped", LogSeverity::Verbose);
+    context.closeCache();
+    context.endLogging();
+    return 0;
+}
+
+int runClient(const MnxValidateContext& context, int argc, arg_char* argv[])
+{
+    const auto address = makeSocketAddress(context.clientSocketPath.value());
+    Socket connection(::socket(AF_UNIX, SOCK_STREAM, 0));
+    if (connection.fd() < 0 || ::connect(connection.fd(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        throw std::runtime_error("Unable to connect to server at " + utils::pathToString(context.clientSocketPath.value()) + ": " + std::strerror(errno));
+    }
+    std::signal(SIGPIPE, SIG_IGN);
+    if (context.stopServer) {
+        connection.sendFrame(kFrameStop);
+    } else {
+        // The server cannot read this process's stdin, so its documents are sent in kFrameDocument frames.
+        auto sendStdin = [&, sent = false]() mutable {
+            if (sent) {
+                return;
+            }
+            sent = true;
+            DocumentStreamReader reader(std::cin, context.stdinFormat, "stdin");
+            while (auto input = reader.next()) {
+                connection.sendFrame(kFrameDocument, utils::pathToString(input->path) + '\0' + input->contents.value());
+            }
+        };
+        for (int x = 1; x < argc; x++) {
+            const std::string_view arg(argv[x]);
+            if (arg == "-" || arg == "--stdin-stream") {
+                sendStdin();
+            } else if (arg.rfind("--", 0) == 0) {
+                const ValueOption* option = findValueOption(arg);
+                const bool hasValue = option && x + 1 < argc && std::string_view(argv[x + 1]).rfind("--", 0) != 0;
+                if (arg == "--client") {
+                    x += hasValue ? 1 : 0;
+                    continue;
+                }
+                connection.sendFrame(kFrameArgument, arg);
+                if (hasValue) {
+                    x++;
+                    const std::filesystem::path value = option->isPath ? std::filesystem::absolute(argv[x]) : std::filesystem::path(argv[x]);
+                    connection.sendFrame(kFrameArgument, utils::pathToString(value));
+                }
+            } else {
+                connection.sendFrame(kFrameArgument, utils::pathToString(std::filesystem::absolute(argv[x])));
+            }
+        }
+        connection.sendFrame(kFrameEnd);
+    }
+    char type{};
+    std::string payload;
+    while (connection.readFrame(type, payload)) {
+        if (type == kFrameOutput) {
+            std::cerr << payload << std::flush;
+        } else if (type == kFrameExit) {
+            return std::stoi(payload);
+        }
+    }
+    throw std::runtime_error("Server closed the connection before responding");
+}
+
+#endif
+
+} // namespace mnxvalidate
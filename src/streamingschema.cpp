@@ -0,0 +1,771 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <regex>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+
+#include "streamingschema.h"
+#include "utils/schemautils.h"
+
+namespace mnxvalidate {
+
+using json = nlohmann::json;
+
+namespace {
+
+// Thrown to abandon validation at the error limit. It is not a std::exception, so nothing mistakes it for a parse error.
+struct ErrorLimitReached {};
+
+constexpr size_t kNone = std::numeric_limits<size_t>::max();
+
+using namespace utils;
+
+} // namespace
+
+/// @brief One compiled (sub)schema. Subschemas are shared through pointers, so recursive `$ref`s form cycles.
+struct StreamingSchema::Node
+{
+    bool alwaysFalse{};                                 ///< the `false` schema
+    std::uint8_t types{ TypeAny };
+    std::optional<std::vector<json>> enumValues;
+    std::optional<json> constValue;
+
+    std::optional<double> minimum, maximum, exclusiveMinimum, exclusiveMaximum, multipleOf;
+    std::optional<size_t> minLength, maxLength;
+    std::optional<std::regex> pattern;
+    std::string patternText;
+
+    std::unordered_map<std::string, const Node*> properties;
+    std::vector<std::pair<std::regex, const Node*>> patternProperties;
+    const Node* additionalProperties{};
+    const Node* propertyNames{};
+    std::optional<size_t> minProperties, maxProperties;
+
+    /// property names whose presence is tracked, for `required` and `dependencies`
+    std::vector<std::string> trackedNames;
+    std::unordered_map<std::string, size_t> trackedSlots;
+    std::vector<size_t> required;                                       ///< slots
+    std::vector<std::pair<size_t, std::vector<size_t>>> dependentRequired; ///< slot, then the slots it requires
+    std::vector<std::pair<size_t, const Node*>> dependentSchemas;       ///< slot, then the schema the object must match if it is present
+
+    std::vector<const Node*> tupleItems;               ///< `items` as an array
+    const Node* items{};                                ///< `items` as a schema, or `additionalItems` after #tupleItems
+    const Node* contains{};
+    std::optional<size_t> minItems, maxItems;
+
+    std::vector<const Node*> allOf;                     ///< including a resolved `$ref`
+    std::vector<const Node*> anyOf;
+    std::vector<const Node*> oneOf;
+    const Node* notNode{};
+    const Node* ifNode{};
+    const Node* thenNode{};
+    const Node* elseNode{};
+
+    size_t trackedSlot(const std::string& name)
+    {
+        const auto [it, inserted] = trackedSlots.emplace(name, trackedNames.size());
+        if (inserted) {
+            trackedNames.push_back(name);
+        }
+        return it->second;
+    }
+};
+
+// Compiles every subschema reachable from the root once, keyed by its json pointer so that `$ref`s share nodes.
+class StreamingSchema::Compiler
+{
+public:
+    Compiler(const json& root, std::vector<std::unique_ptr<Node>>& nodes) : m_root(root), m_nodes(nodes) {}
+
+    const Node* compile(const json& schema, const std::string& pointer)
+    {
+        if (const auto it = m_byPointer.find(pointer); it != m_byPointer.end()) {
+            return it->second;
+        }
+        Node& node = *m_nodes.emplace_back(std::make_unique<Node>());
+        m_byPointer.emplace(pointer, &node); // before the children, so that cycles end here
+        if (schema.is_boolean()) {
+            node.alwaysFalse = !schema.get<bool>();
+            return &node;
+        }
+        if (!schema.is_object()) {
+            throw std::invalid_argument("the subschema at " + pointer + " is not an object");
+        }
+        // Draft 7 ignores everything beside a `$ref`, and so does the DOM validator
+        if (const auto ref = schema.find("$ref"); ref != schema.end()) {
+            node.allOf.push_back(resolve(ref->get<std::string>()));
+            return &node;
+        }
+        for (const auto& [keyword, value] : schema.items()) {
+            compileKeyword(node, keyword, value, pointer);
+        }
+        if (const auto additionalItems = schema.find("additionalItems"); additionalItems != schema.end() && !node.tupleItems.empty()) {
+            node.items = compile(*additionalItems, pointer + "/additionalItems");
+        }
+        return &node;
+    }
+
+private:
+    const Node* resolve(const std::string& ref)
+    {
+        if (ref.empty() || ref[0] != '#') {
+            throw std::invalid_argument("the schema refers to " + ref + ", outside the schema");
+        }
+        const json::json_pointer target(ref.substr(1));
+        if (!m_root.contains(target)) {
+            throw std::invalid_argument("the schema refers to " + ref + ", which does not exist");
+        }
+        return compile(m_root.at(target), target.to_string());
+    }
+
+    const Node* child(const json& value, const std::string& pointer, const std::string& token)
+    {
+        return compile(value, pointer + "/" + escapePointerToken(token));
+    }
+
+    std::vector<const Node*> children(const json& values, const std::string& pointer)
+    {
+        std::vector<const Node*> result;
+        for (size_t x = 0; x < values.size(); x++) {
+            result.push_back(compile(values[x], pointer + "/" + std::to_string(x)));
+        }
+        return result;
+    }
+
+    // Streaming never holds a whole object or array to compare, so enum and const are limited to scalars,
+    // which a container can never equal.
+    static void requireScalar(const std::string& keyword, const json& value)
+    {
+        if (value.is_structured()) {
+            throw std::invalid_argument("the schema has an object or array in " + keyword + ", which cannot be compared while streaming");
+        }
+    }
+
+    static std::regex compileRegex(const std::string& pattern)
+    {
+        return std::regex(pattern, std::regex::ECMAScript | std::regex::optimize);
+    }
+
+    void compileKeyword(Node& node, const std::string& keyword, const json& value, const std::string& pointer)
+    {
+        const std::string keywordPointer = pointer + "/" + escapePointerToken(keyword);
+        if (keyword == "type") {
+            node.types = 0;
+            if (value.is_array()) {
+                for (const auto& type : value) {
+                    node.types |= typeBitsFor(type.get<std::string>());
+                }
+            } else {
+                node.types = typeBitsFor(value.get<std::string>());
+            }
+        } else if (keyword == "enum") {
+            node.enumValues = value.get<std::vector<json>>();
+            for (const auto& enumValue : *node.enumValues) {
+                requireScalar(keyword, enumValue);
+            }
+        } else if (keyword == "const") {
+            requireScalar(keyword, value);
+            node.constValue = value;
+        } else if (keyword == "minimum") {
+            node.minimum = value.get<double>();
+        } else if (keyword == "maximum") {
+            node.maximum = value.get<double>();
+        } else if (keyword == "exclusiveMinimum") {
+            node.exclusiveMinimum = value.get<double>();
+        } else if (keyword == "exclusiveMaximum") {
+            node.exclusiveMaximum = value.get<double>();
+        } else if (keyword == "multipleOf") {
+            node.multipleOf = value.get<double>();
+        } else if (keyword == "minLength") {
+            node.minLength = value.get<size_t>();
+        } else if (keyword == "maxLength") {
+            node.maxLength = value.get<size_t>();
+        } else if (keyword == "pattern") {
+            node.patternText = value.get<std::string>();
+            node.pattern = compileRegex(node.patternText);
+        } else if (keyword == "properties") {
+            for (const auto& [name, subschema] : value.items()) {
+                node.properties.emplace(name, child(subschema, keywordPointer, name));
+            }
+        } else if (keyword == "patternProperties") {
+            for (const auto& [regex, subschema] : value.items()) {
+                node.patternProperties.emplace_back(compileRegex(regex), child(subschema, keywordPointer, regex));
+            }
+        } else if (keyword == "additionalProperties") {
+            node.additionalProperties = compile(value, keywordPointer);
+        } else if (keyword == "propertyNames") {
+            node.propertyNames = compile(value, keywordPointer);
+        } else if (keyword == "minProperties") {
+            node.minProperties = value.get<size_t>();
+        } else if (keyword == "maxProperties") {
+            node.maxProperties = value.get<size_t>();
+        } else if (keyword == "required") {
+            for (const auto& name : value) {
+                node.required.push_back(node.trackedSlot(name.get<std::string>()));
+            }
+        } else if (keyword == "dependencies") {
+            for (const auto& [name, dependency] : value.items()) {
+                const size_t slot = node.trackedSlot(name);
+                if (dependency.is_array()) {
+                    std::vector<size_t> requiredSlots;
+                    for (const auto& requiredName : dependency) {
+                        requiredSlots.push_back(node.trackedSlot(requiredName.get<std::string>()));
+                    }
+                    node.dependentRequired.emplace_back(slot, std::move(requiredSlots));
+                } else {
+                    node.dependentSchemas.emplace_back(slot, child(dependency, keywordPointer, name));
+                }
+            }
+        } else if (keyword == "items") {
+            if (value.is_array()) {
+                node.tupleItems = children(value, keywordPointer);
+            } else {
+                node.items = compile(value, keywordPointer);
+            }
+        } else if (keyword == "contains") {
+            node.contains = compile(value, keywordPointer);
+        } else if (keyword == "minItems") {
+            node.minItems = value.get<size_t>();
+        } else if (keyword == "maxItems") {
+            node.maxItems = value.get<size_t>();
+        } else if (keyword == "uniqueItems") {
+            if (value.get<bool>()) {
+                throw std::invalid_argument("the schema uses uniqueItems, which needs every item of an array at once");
+            }
+        } else if (keyword == "allOf") {
+            const auto nodes = children(value, keywordPointer);
+            node.allOf.insert(node.allOf.end(), nodes.begin(), nodes.end());
+        } else if (keyword == "anyOf") {
+            node.anyOf = children(value, keywordPointer);
+        } else if (keyword == "oneOf") {
+            node.oneOf = children(value, keywordPointer);
+        } else if (keyword == "not") {
+            node.notNode = compile(value, keywordPointer);
+        } else if (keyword == "if") {
+            node.ifNode = compile(value, keywordPointer);
+        } else if (keyword == "then") {
+            node.thenNode = compile(value, keywordPointer);
+        } else if (keyword == "else") {
+            node.elseNode = compile(value, keywordPointer);
+        } else if (keyword == "format" || keyword == "contentEncoding" || keyword == "contentMediaType") {
+            throw std::invalid_argument("the schema uses " + keyword + ", which the streaming validator does not check");
+        } else if (keyword == "$id" && pointer != "") {
+            throw std::invalid_argument("the schema has a nested $id, so its $refs may not be local");
+        }
+        // Anything else is an annotation, a container of definitions, or a keyword draft 7 does not have,
+        // none of which the DOM validator checks either. (`additionalItems` is compiled with its tuple.)
+    }
+
+    const json& m_root;
+    std::vector<std::unique_ptr<Node>>& m_nodes;
+    std::unordered_map<std::string, const Node*> m_byPointer;
+};
+
+// Receives the SAX events for one document. Each open instance (the root, and every object, array and scalar
+// inside it that is being read) has a frame holding the validations that apply to it. A validation is one node
+// checked against one instance. Combinators add validations for their subschemas to the same frame, and their
+// results are gathered when the instance ends, in reverse order so that subschemas finish before their owners.
+class StreamingSchema::Handler
+{
+public:
+    Handler(const Node& root, size_t maxErrors) : m_root(root), m_maxErrors(maxErrors) {}
+
+    std::vector<SchemaError> errors;
+
+    bool null() { return scalar(TypeNull, nullptr); }
+    bool boolean(bool value) { return scalar(TypeBoolean, value); }
+    bool number_integer(json::number_integer_t value) { return scalar(TypeInteger, value); }
+    bool number_unsigned(json::number_unsigned_t value) { return scalar(TypeInteger, value); }
+    bool number_float(json::number_float_t value, const json::string_t&)
+    {
+        return scalar(std::isfinite(value) && value == std::floor(value) ? TypeInteger : TypeNumber, value);
+    }
+    bool string(json::string_t& value) { return scalar(TypeString, value); }
+    bool binary(json::binary_t&) { return true; } // json text has no binary values
+
+    bool start_object(std::size_t)
+    {
+        beginInstance(Frame::Kind::Object, TypeObject);
+        return true;
+    }
+
+    bool key(json::string_t& name)
+    {
+        const size_t objectDepth = m_depth - 1;
+        m_frames[objectDepth].key = name;
+        auto& validations = m_frames[objectDepth].validations;
+        for (size_t x = 0; x < validations.size(); x++) {
+            Validation& validation = validations[x];
+            if (!validation.active()) {
+                continue;
+            }
+            if (const auto slot = validation.node->trackedSlots.find(name); slot != validation.node->trackedSlots.end()) {
+                validation.seen[slot->second] = true;
+            }
+            if (validation.node->propertyNames) {
+                Frame& frame = pushFrame(Frame::Kind::Scalar);
+                expand(frame, validation.node->propertyNames, validation.reports, kNone, x, Role::PropertyName);
+                checkScalar(frame, TypeString, json(name));
+                endInstance();
+            }
+        }
+        return true;
+    }
+
+    bool end_object()
+    {
+        endInstance();
+        return true;
+    }
+
+    bool start_array(std::size_t)
+    {
+        beginInstance(Frame::Kind::Array, TypeArray);
+        return true;
+    }
+
+    bool end_array()
+    {
+        endInstance();
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const json::exception& exception)
+    {
+        if (const auto* parseError = dynamic_cast<const json::parse_error*>(&exception)) {
+            throw *parseError;
+        }
+        if (const auto* outOfRange = dynamic_cast<const json::out_of_range*>(&exception)) {
+            throw *outOfRange;
+        }
+        throw std::runtime_error(exception.what());
+    }
+
+private:
+    /// @brief how a validation's result is used when its instance ends
+    enum class Role : std::uint8_t
+    {
+        Root,           ///< decides whether the document is valid
+        Member,         ///< a property or item of the parent frame's validation
+        PropertyName,   ///< a property name checked against the parent frame's `propertyNames`
+        Contains,       ///< an item checked against the parent frame's `contains`
+        AllOf,          ///< the owner fails if this fails
+        AnyOf,          ///< counted by the owner
+        OneOf,          ///< counted by the owner
+        Not,
+        If,
+        Then,
+        Else,
+        Dependency      ///< the owner's dependency schema for one property
+    };
+
+    struct Validation
+    {
+        const Node* node{};
+        size_t owner{ kNone };      ///< the combinator validation in the same frame, if any
+        size_t parent{ kNone };     ///< the validation in the parent frame, for Member, PropertyName and Contains
+        size_t slot{};              ///< the tracked property, for Dependency
+        Role role{};
+        bool reports{};             ///< errors are reported, rather than only deciding a combinator
+        bool failed{};
+        size_t anyOfMatches{};
+        size_t oneOfMatches{};
+        size_t containsMatches{};
+        bool notMatched{};
+        bool ifMatched{};
+        bool thenFailed{};
+        bool elseFailed{};
+        std::vector<bool> seen;                 ///< by tracked slot
+        std::vector<size_t> failedDependencies; ///< tracked slots whose dependency schema failed
+
+        /// @brief false once the outcome cannot change what is reported
+        bool active() const { return reports || !failed; }
+    };
+
+    struct Frame
+    {
+        enum class Kind { Scalar, Object, Array };
+        Kind kind{};
+        std::vector<Validation> validations;
+        std::string key;    ///< the current property, for objects
+        size_t count{};     ///< the properties or items so far
+    };
+
+    // Frames are reused from level to level, so their vectors keep their capacity. They live in a deque so that
+    // pushing one (for a property name) leaves references into the frames below intact.
+    Frame& pushFrame(Frame::Kind kind)
+    {
+        if (m_depth == m_frames.size()) {
+            m_frames.emplace_back();
+        }
+        Frame& frame = m_frames[m_depth++];
+        frame.kind = kind;
+        frame.validations.clear();
+        frame.key.clear();
+        frame.count = 0;
+        return frame;
+    }
+
+    void expand(Frame& frame, const Node* node, bool reports, size_t owner, size_t parent, Role role, size_t slot = 0)
+    {
+        const size_t index = frame.validations.size();
+        Validation& validation = frame.validations.emplace_back();
+        validation.node = node;
+        validation.owner = owner;
+        validation.parent = parent;
+        validation.slot = slot;
+        validation.role = role;
+        validation.reports = reports;
+        validation.seen.assign(node->trackedNames.size(), false);
+        // validation is not used past here: expanding may move it
+        for (const Node* sub : node->allOf) {
+            expand(frame, sub, reports, index, kNone, Role::AllOf);
+        }
+        for (const Node* sub : node->anyOf) {
+            expand(frame, sub, false, index, kNone, Role::AnyOf);
+        }
+        for (const Node* sub : node->oneOf) {
+            expand(frame, sub, false, index, kNone, Role::OneOf);
+        }
+        if (node->notNode) {
+            expand(frame, node->notNode, false, index, kNone, Role::Not);
+        }
+        if (node->ifNode) {
+            expand(frame, node->ifNode, false, index, kNone, Role::If);
+            if (node->thenNode) {
+                expand(frame, node->thenNode, false, index, kNone, Role::Then);
+            }
+            if (node->elseNode) {
+                expand(frame, node->elseNode, false, index, kNone, Role::Else);
+            }
+        }
+        for (const auto& [dependencySlot, sub] : node->dependentSchemas) {
+            expand(frame, sub, false, index, kNone, Role::Dependency, dependencySlot);
+        }
+    }
+
+    // Starts an instance: the root, or the value of the current property or item of the frame below.
+    Frame& beginInstance(Frame::Kind kind, std::uint8_t type)
+    {
+        Frame& frame = pushFrame(kind);
+        if (m_depth == 1) {
+            expand(frame, &m_root, true, kNone, kNone, Role::Root);
+        } else {
+            Frame& container = m_frames[m_depth - 2];
+            auto& containerValidations = container.validations;
+            for (size_t x = 0; x < containerValidations.size(); x++) {
+                const Validation& validation = containerValidations[x];
+                if (!validation.active()) {
+                    continue;
+                }
+                const Node& node = *validation.node;
+                if (container.kind == Frame::Kind::Object) {
+                    bool matched = false;
+                    if (const auto property = node.properties.find(container.key); property != node.properties.end()) {
+                        expand(frame, property->second, validation.reports, kNone, x, Role::Member);
+                        matched = true;
+                    }
+                    for (const auto& [regex, sub] : node.patternProperties) {
+                        if (std::regex_search(container.key, regex)) {
+                            expand(frame, sub, validation.reports, kNone, x, Role::Member);
+                            matched = true;
+                        }
+                    }
+                    if (!matched && node.additionalProperties) {
+                        expand(frame, node.additionalProperties, validation.reports, kNone, x, Role::Member);
+                    }
+                } else {
+                    const Node* item = container.count < node.tupleItems.size() ? node.tupleItems[container.count] : node.items;
+                    if (item) {
+                        expand(frame, item, validation.reports, kNone, x, Role::Member);
+                    }
+                    if (node.contains) {
+                        expand(frame, node.contains, false, kNone, x, Role::Contains);
+                    }
+                }
+            }
+            container.count++;
+        }
+        if (kind != Frame::Kind::Scalar) {
+            for (auto& validation : frame.validations) {
+                if (validation.active()) {
+                    checkType(validation, type);
+                    if (validation.node->enumValues || validation.node->constValue) {
+                        checkValue(validation, nullptr, true);
+                    }
+                }
+            }
+        }
+        return frame;
+    }
+
+    template <typename T>
+    bool scalar(std::uint8_t type, T&& value)
+    {
+        Frame& frame = beginInstance(Frame::Kind::Scalar, type);
+        checkScalar(frame, type, json(std::forward<T>(value)));
+        endInstance();
+        return true;
+    }
+
+    void checkScalar(Frame& frame, std::uint8_t type, const json& value)
+    {
+        for (auto& validation : frame.validations) {
+            if (!validation.active()) {
+                continue;
+            }
+            checkType(validation, type);
+            checkValue(validation, &value, false);
+            const Node& node = *validation.node;
+            if (value.is_number()) {
+                const double number = value.get<double>();
+                if (node.minimum && number < *node.minimum) {
+                    fail(validation, "instance is below minimum of " + formatNumber(*node.minimum));
+                }
+                if (node.exclusiveMinimum && number <= *node.exclusiveMinimum) {
+                    fail(validation, "instance is below or equals minimum of " + formatNumber(*node.exclusiveMinimum));
+                }
+                if (node.maximum && number > *node.maximum) {
+                    fail(validation, "instance exceeds maximum of " + formatNumber(*node.maximum));
+                }
+                if (node.exclusiveMaximum && number >= *node.exclusiveMaximum) {
+                    fail(validation, "instance exceeds or equals maximum of " + formatNumber(*node.exclusiveMaximum));
+                }
+                if (node.multipleOf) {
+                    const double remainder = std::remainder(number, *node.multipleOf);
+                    const double epsilon = std::nextafter(number, 0) - number;
+                    if (std::fabs(remainder) > std::fabs(epsilon)) {
+                        fail(validation, "instance is not a multiple of " + formatNumber(*node.multipleOf));
+                    }
+                }
+            } else if (value.is_string()) {
+                const auto& text = value.get_ref<const std::string&>();
+                if (node.minLength || node.maxLength) {
+                    const size_t length = utf8Length(text);
+                    if (node.minLength && length < *node.minLength) {
+                        fail(validation, "instance is too short as per minLength:" + std::to_string(*node.minLength));
+                    }
+                    if (node.maxLength && length > *node.maxLength) {
+                        fail(validation, "instance is too long as per maxLength: " + std::to_string(*node.maxLength));
+                    }
+                }
+                if (node.pattern && !std::regex_search(text, *node.pattern)) {
+                    fail(validation, "instance does not match regex pattern: " + node.patternText);
+                }
+            }
+        }
+    }
+
+    void checkType(Validation& validation, std::uint8_t type)
+    {
+        if (validation.node->alwaysFalse) {
+            fail(validation, "instance invalid as per false-schema");
+        } else if (!(validation.node->types & type)) {
+            fail(validation, "unexpected instance type");
+        }
+    }
+
+    // Checks enum and const, whose values the compiler has limited to scalars. A container never equals one.
+    void checkValue(Validation& validation, const json* value, bool isContainer)
+    {
+        const Node& node = *validation.node;
+        if (node.enumValues) {
+            const bool found = !isContainer && std::find(node.enumValues->begin(), node.enumValues->end(), *value) != node.enumValues->end();
+            if (!found) {
+                fail(validation, "instance not found in required enum");
+            }
+        }
+        if (node.constValue && (isContainer || *node.constValue != *value)) {
+            fail(validation, "instance not const");
+        }
+    }
+
+    // Finishes the instance in the top frame and passes each root validation's result to the frame below.
+    void endInstance()
+    {
+        Frame& frame = m_frames[m_depth - 1];
+        auto& validations = frame.validations;
+        for (size_t x = validations.size(); x-- > 0;) {
+            Validation& validation = validations[x];
+            if (validation.active()) {
+                checkEnd(frame, validation);
+            }
+            if (validation.owner != kNone) {
+                Validation& owner = validations[validation.owner];
+                switch (validation.role) {
+                case Role::AllOf: owner.failed |= validation.failed; break;
+                case Role::AnyOf: owner.anyOfMatches += !validation.failed; break;
+                case Role::OneOf: owner.oneOfMatches += !validation.failed; break;
+                case Role::Not: owner.notMatched = !validation.failed; break;
+                case Role::If: owner.ifMatched = !validation.failed; break;
+                case Role::Then: owner.thenFailed = validation.failed; break;
+                case Role::Else: owner.elseFailed = validation.failed; break;
+                case Role::Dependency:
+                    if (validation.failed) {
+                        owner.failedDependencies.push_back(validation.slot);
+                    }
+                    break;
+                default: break;
+                }
+            } else if (validation.parent != kNone) {
+                Validation& parent = m_frames[m_depth - 2].validations[validation.parent];
+                if (validation.role == Role::Contains) {
+                    parent.containsMatches += !validation.failed;
+                } else {
+                    parent.failed |= validation.failed;
+                }
+            }
+        }
+        m_depth--;
+    }
+
+    void checkEnd(const Frame& frame, Validation& validation)
+    {
+        const Node& node = *validation.node;
+        if (frame.kind == Frame::Kind::Object) {
+            for (const size_t slot : node.required) {
+                if (!validation.seen[slot]) {
+                    fail(validation, "required property '" + node.trackedNames[slot] + "' not found in object");
+                }
+            }
+            for (const auto& [slot, requiredSlots] : node.dependentRequired) {
+                if (validation.seen[slot]) {
+                    for (const size_t requiredSlot : requiredSlots) {
+                        if (!validation.seen[requiredSlot]) {
+                            fail(validation, "required property '" + node.trackedNames[requiredSlot] + "' not found in object as a dependency of '"
+                                + node.trackedNames[slot] + "'");
+                        }
+                    }
+                }
+            }
+            for (const size_t slot : validation.failedDependencies) {
+                if (validation.seen[slot]) {
+                    fail(validation, "instance does not match the dependency schema of '" + node.trackedNames[slot] + "'");
+                }
+            }
+            if (node.minProperties && frame.count < *node.minProperties) {
+                fail(validation, "too few properties");
+            }
+            if (node.maxProperties && frame.count > *node.maxProperties) {
+                fail(validation, "too many properties");
+            }
+        } else if (frame.kind == Frame::Kind::Array) {
+            if (node.minItems && frame.count < *node.minItems) {
+                fail(validation, "array has too few items");
+            }
+            if (node.maxItems && frame.count > *node.maxItems) {
+                fail(validation, "array has too many items");
+            }
+            if (node.contains && validation.containsMatches == 0) {
+                fail(validation, "array does not contain required element as per 'contains'");
+            }
+        }
+        if (!node.anyOf.empty() && validation.anyOfMatches == 0) {
+            fail(validation, "no subschema has succeeded, but one of them is required to validate");
+        }
+        if (!node.oneOf.empty() && validation.oneOfMatches != 1) {
+            fail(validation, validation.oneOfMatches == 0 ? "no subschema has succeeded, but one of them is required to validate"
+                : "more than one subschema has succeeded, but exactly one of them is required to validate");
+        }
+        if (node.notNode && validation.notMatched) {
+            fail(validation, "the subschema has succeeded, but it is required to not validate");
+        }
+        if (node.ifNode) {
+            if (validation.ifMatched && node.thenNode && validation.thenFailed) {
+                fail(validation, "instance does not match the 'then' subschema");
+            } else if (!validation.ifMatched && node.elseNode && validation.elseFailed) {
+                fail(validation, "instance does not match the 'else' subschema");
+            }
+        }
+    }
+
+    void fail(Validation& validation, const std::string& message)
+    {
+        validation.failed = true;
+        if (!validation.reports) {
+            return;
+        }
+        errors.push_back({ currentPointer(), message });
+        if (m_maxErrors && errors.size() >= m_maxErrors) {
+            throw ErrorLimitReached();
+        }
+    }
+
+    // The pointer of the instance in the top frame, built only when an error needs it
+    std::string currentPointer() const
+    {
+        std::string pointer;
+        for (size_t x = 0; x + 1 < m_depth; x++) {
+            const Frame& frame = m_frames[x];
+            pointer += '/';
+            pointer += frame.kind == Frame::Kind::Object ? escapePointerToken(frame.key) : std::to_string(frame.count - 1);
+        }
+        return pointer;
+    }
+
+    const Node& m_root;
+    const size_t m_maxErrors;
+    std::deque<Frame> m_frames;
+    size_t m_depth{};
+};
+
+StreamingSchema::StreamingSchema(const json& schema)
+{
+    Compiler compiler(schema, m_nodes);
+    m_root = compiler.compile(schema, "");
+}
+
+StreamingSchema::~StreamingSchema() = default;
+
+template <typename InputIterator>
+SchemaValidationResult StreamingSchema::validateRange(InputIterator first, InputIterator last, size_t maxErrors) const
+{
+    Handler handler(*m_root, maxErrors);
+    bool truncated = false;
+    try {
+        json::sax_parse(first, last, &handler);
+    } catch (const ErrorLimitReached&) {
+        truncated = true;
+    }
+    return { std::move(handler.errors), truncated };
+}
+
+SchemaValidationResult StreamingSchema::validate(std::string_view jsonText, size_t maxErrors) const
+{
+    return validateRange(jsonText.begin(), jsonText.end(), maxErrors);
+}
+
+SchemaValidationResult StreamingSchema::validate(Decompressor& input, size_t maxErrors) const
+{
+    return validateRange(input.begin(), input.end(), maxErrors);
+}
+
+} // namespace mnxvalidate
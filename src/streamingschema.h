@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+
+#include "nlohmann/json.hpp"
+#include "schemavalidator.h"
+#include "compression.h"
+
+namespace mnxvalidate {
+
+/**
+ * @brief A JSON schema compiled for validating documents as they are parsed, without building a DOM.
+ *
+ * The schema is checked against nlohmann's SAX events. Only a stack of validator state for the open objects
+ * and arrays is kept, so memory use depends on how deeply the document nests rather than on its size.
+ * Combinators (`anyOf`, `oneOf`, `not`, `if`) run their subschemas side by side and decide when the instance ends.
+ *
+ * Keywords follow draft 7, like the DOM validator. Keywords that cannot be checked in bounded memory
+ * (`uniqueItems`), that need callbacks the DOM validator is not given (`format`, `contentEncoding`), and
+ * `$ref`s outside the schema make the schema unsupported, and the constructor throws.
+ */
+class StreamingSchema
+{
+public:
+    /// @throws std::invalid_argument naming what cannot be streamed
+    explicit StreamingSchema(const nlohmann::json& schema);
+    ~StreamingSchema();
+
+    StreamingSchema(const StreamingSchema&) = delete;
+    StreamingSchema& operator=(const StreamingSchema&) = delete;
+
+    /**
+     * @brief Parses and validates json text in one pass. Safe to call from multiple threads at once.
+     * @param jsonText the document
+     * @param maxErrors stop validating once this many errors have been found (0 means no limit)
+     * @throws nlohmann::json::exception if the text is not valid json
+     */
+    SchemaValidationResult validate(std::string_view jsonText, size_t maxErrors = 0) const;
+
+    /// @brief Validates json text as it is decompressed
+    /// @throws DecompressionError if the input cannot be decompressed
+    SchemaValidationResult validate(Decompressor& input, size_t maxErrors = 0) const;
+
+    struct Node;
+
+private:
+    class Compiler;
+    class Handler;
+
+    template <typename InputIterator>
+    SchemaValidationResult validateRange(InputIterator first, InputIterator last, size_t maxErrors) const;
+
+    std::vector<std::unique_ptr<Node>> m_nodes;
+    const Node* m_root{};
+};
+
+} // namespace mnxvalidate
@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+#include "timingstats.h"
+
+namespace mnxvalidate {
+
+namespace {
+
+double toMilliseconds(std::chrono::nanoseconds duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+double toSeconds(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration<double>(duration).count();
+}
+
+constexpr double kBytesPerMegabyte = 1024.0 * 1024.0;
+constexpr std::array<double, 3> kPercentiles = { 0.50, 0.95, 0.99 };
+
+std::string rowName(size_t row)
+{
+    return row < 4 ? phaseName(static_cast<ValidationPhase>(row)) : "total";
+}
+
+} // namespace
+
+// Values below 2^kSubBucketBits get a bucket each. Above that, each power of two is split into 2^kSubBucketBits buckets.
+size_t DurationHistogram::bucketFor(std::uint64_t nanoseconds)
+{
+    constexpr std::uint64_t kSubBuckets = std::uint64_t(1) << kSubBucketBits;
+    if (nanoseconds < kSubBuckets) {
+        return static_cast<size_t>(nanoseconds);
+    }
+    const unsigned exponent = static_cast<unsigned>(std::bit_width(nanoseconds)) - 1;
+    const unsigned shift = exponent - kSubBucketBits;
+    return static_cast<size_t>(((exponent - kSubBucketBits + 1) << kSubBucketBits) | ((nanoseconds >> shift) & (kSubBuckets - 1)));
+}
+
+std::uint64_t DurationHistogram::bucketUpperBound(size_t bucket)
+{
+    constexpr std::uint64_t kSubBuckets = std::uint64_t(1) << kSubBucketBits;
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+    const unsigned shift = static_cast<unsigned>(bucket >> kSubBucketBits) - 1;
+    const std::uint64_t lowerBound = (kSubBuckets + (bucket & (kSubBuckets - 1))) << shift;
+    return lowerBound + (std::uint64_t(1) << shift) - 1;
+}
+
+void DurationHistogram::add(std::chrono::nanoseconds value)
+{
+    const auto nanoseconds = static_cast<std::uint64_t>(std::max<std::chrono::nanoseconds::rep>(value.count(), 0));
+    const size_t bucket = bucketFor(nanoseconds);
+    if (bucket >= m_counts.size()) {
+        m_counts.resize(bucket + 1);
+    }
+    m_counts[bucket]++;
+    m_count++;
+    m_total += value;
+    m_max = std::max(m_max, value);
+}
+
+std::chrono::nanoseconds DurationHistogram::percentile(double fraction) const
+{
+    if (!m_count) {
+        return {};
+    }
+    const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(fraction * double(m_count))));
+    std::uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < m_counts.size(); bucket++) {
+        seen += m_counts[bucket];
+        if (seen >= rank) {
+            return std::min(std::chrono::nanoseconds(bucketUpperBound(bucket)), m_max);
+        }
+    }
+    return m_max;
+}
+
+TimingStats::TimingStats(size_t slowestCount)
+    : m_startTime(std::chrono::steady_clock::now()), m_slowestCount(slowestCount)
+{
+}
+
+void TimingStats::addScan(std::chrono::steady_clock::duration duration)
+{
+    m_scanDuration += duration;
+}
+
+void TimingStats::addFile(const FileContext& file)
+{
+    m_fileCount++;
+    m_bytesRead += file.timings.bytesRead;
+    for (size_t phase = 0; phase < file.timings.phases.size(); phase++) {
+        if (const auto& duration = file.timings.phases[phase]) {
+            m_phases[phase].add(duration.value());
+        }
+    }
+    m_phases[kTotalRow].add(file.duration);
+    if (file.timings.discardedSplit) {
+        m_splitFallbackCount++;
+        m_splitDiscarded += file.timings.discardedSplit.value();
+    }
+
+    auto fasterFirst = [](const SlowFile& a, const SlowFile& b) { return a.duration > b.duration; };
+    if (m_slowest.size() < m_slowestCount) {
+        m_slowest.push_back({ file.duration, file.inputPath });
+        std::push_heap(m_slowest.begin(), m_slowest.end(), fasterFirst);
+    } else if (m_slowestCount && file.duration > m_slowest.front().duration) {
+        std::pop_heap(m_slowest.begin(), m_slowest.end(), fasterFirst);
+        m_slowest.back() = { file.duration, file.inputPath };
+        std::push_heap(m_slowest.begin(), m_slowest.end(), fasterFirst);
+    }
+}
+
+std::vector<TimingStats::SlowFile> TimingStats::slowestFiles() const
+{
+    auto result = m_slowest;
+    std::sort(result.begin(), result.end(), [](const SlowFile& a, const SlowFile& b) { return a.duration > b.duration; });
+    return result;
+}
+
+std::vector<std::string> TimingStats::summaryLines() const
+{
+    const double elapsedSeconds = toSeconds(std::chrono::steady_clock::now() - m_startTime);
+    const double megabytes = double(m_bytesRead) / kBytesPerMegabyte;
+    std::vector<std::string> lines;
+    std::ostringstream line;
+    auto endLine = [&]() {
+        lines.push_back(line.str());
+        line.str({});
+    };
+    line << std::fixed << std::setprecision(3);
+    line << "Timings: " << m_fileCount << " files, " << megabytes << " MB in " << elapsedSeconds << " s";
+    if (elapsedSeconds > 0) {
+        line << " (" << std::setprecision(1) << double(m_fileCount) / elapsedSeconds << " files/s, "
+             << std::setprecision(3) << megabytes / elapsedSeconds << " MB/s)";
+    }
+    endLine();
+    line << "    finding files: " << toMilliseconds(m_scanDuration) << " ms";
+    endLine();
+    if (m_splitFallbackCount) {
+        line << "    split semantic checks redone on one thread: " << m_splitFallbackCount << " files, "
+             << toMilliseconds(m_splitDiscarded) << " ms discarded";
+        endLine();
+    }
+    line << "    " << std::left << std::setw(10) << "phase" << std::right << std::setw(8) << "files"
+         << std::setw(12) << "total ms" << std::setw(10) << "p50 ms" << std::setw(10) << "p95 ms"
+         << std::setw(10) << "p99 ms" << std::setw(10) << "max ms";
+    endLine();
+    for (size_t row = 0; row < m_phases.size(); row++) {
+        const auto& phase = m_phases[row];
+        line << "    " << std::left << std::setw(10) << rowName(row) << std::right << std::setw(8) << phase.count()
+             << std::setw(12) << toMilliseconds(phase.total());
+        for (double fraction : kPercentiles) {
+            line << std::setw(10) << toMilliseconds(phase.percentile(fraction));
+        }
+        line << std::setw(10) << toMilliseconds(phase.max());
+        endLine();
+    }
+    const auto slowest = slowestFiles();
+    if (!slowest.empty()) {
+        line << "Slowest files:";
+        endLine();
+        for (const auto& file : slowest) {
+            line << "    " << std::setw(10) << toMilliseconds(file.duration) << " ms  " << utils::pathToString(file.path);
+            endLine();
+        }
+    }
+    return lines;
+}
+
+json TimingStats::toJson() const
+{
+    const double elapsedSeconds = toSeconds(std::chrono::steady_clock::now() - m_startTime);
+    json result;
+    result["files"] = m_fileCount;
+    result["bytes"] = m_bytesRead;
+    result["elapsedMs"] = elapsedSeconds * 1000.0;
+    result["scanMs"] = toMilliseconds(m_scanDuration);
+    if (elapsedSeconds > 0) {
+        result["filesPerSecond"] = double(m_fileCount) / elapsedSeconds;
+        result["megabytesPerSecond"] = double(m_bytesRead) / kBytesPerMegabyte / elapsedSeconds;
+    }
+    json& phases = result["phases"] = json::object();
+    for (size_t row = 0; row < m_phases.size(); row++) {
+        const auto& phase = m_phases[row];
+        phases[rowName(row)] = {
+            { "count", phase.count() },
+            { "totalMs", toMilliseconds(phase.total()) },
+            { "p50Ms", toMilliseconds(phase.percentile(kPercentiles[0])) },
+            { "p95Ms", toMilliseconds(phase.percentile(kPercentiles[1])) },
+            { "p99Ms", toMilliseconds(phase.percentile(kPercentiles[2])) },
+            { "maxMs", toMilliseconds(phase.max()) }
+        };
+    }
+    result["semanticSplitFallbacks"] = { { "count", m_splitFallbackCount }, { "discardedMs", toMilliseconds(m_splitDiscarded) } };
+    json& slowest = result["slowest"] = json::array();
+    for (const auto& file : slowestFiles()) {
+        slowest.push_back({ { "file", utils::pathToString(file.path) }, { "durationMs", toMilliseconds(file.duration) } });
+    }
+    return result;
+}
+
+} // namespace mnxvalidate
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+
+#include "mnxvalidate.h"
+
+namespace mnxvalidate {
+
+/**
+ * @brief A histogram of durations with buckets about 3% wide, so percentiles take the same memory for any number of files.
+ */
+class DurationHistogram
+{
+public:
+    void add(std::chrono::nanoseconds value);
+
+    /// @brief The upper bound of the bucket holding the value at @p fraction of the way through the sorted values
+    std::chrono::nanoseconds percentile(double fraction) const;
+
+    size_t count() const { return m_count; }
+    std::chrono::nanoseconds total() const { return m_total; }
+    std::chrono::nanoseconds max() const { return m_max; }
+
+private:
+    static constexpr unsigned kSubBucketBits = 5;
+
+    static size_t bucketFor(std::uint64_t nanoseconds);
+    static std::uint64_t bucketUpperBound(size_t bucket);
+
+    std::vector<std::uint64_t> m_counts;
+    size_t m_count{};
+    std::chrono::nanoseconds m_total{};
+    std::chrono::nanoseconds m_max{};
+};
+
+/**
+ * @brief Collects the per-phase timings of a run for --timings.
+ *
+ * Files are added as their logs are flushed, which always happens on one thread, so no locking is needed.
+ */
+class TimingStats
+{
+public:
+    /// @param slowestCount the number of slowest files to keep
+    explicit TimingStats(size_t slowestCount);
+
+    void addScan(std::chrono::steady_clock::duration duration);    ///< Adds time spent finding input files
+    void addFile(const FileContext& file);                          ///< Adds a validated file's timings
+
+    std::vector<std::string> summaryLines() const;  ///< The aggregate table and the slowest files, one line per entry
+    json toJson() const;                            ///< The same summary for machine-readable reports
+
+private:
+    /// @brief the phases in the table: one per #ValidationPhase, then the whole file
+    static constexpr size_t kTotalRow = 4;
+
+    struct SlowFile
+    {
+        std::chrono::steady_clock::duration duration;
+        std::filesystem::path path;
+    };
+
+    std::vector<SlowFile> slowestFiles() const; ///< slowest first
+
+    std::chrono::steady_clock::time_point m_startTime;
+    std::chrono::steady_clock::duration m_scanDuration{};
+    std::array<DurationHistogram, kTotalRow + 1> m_phases;
+    size_t m_fileCount{};
+    size_t m_splitFallbackCount{};                              ///< files whose split semantic checks were redone on one thread
+    std::chrono::steady_clock::duration m_splitDiscarded{};     ///< the time those split checks took
+    std::uintmax_t m_bytesRead{};
+    size_t m_slowestCount{};
+    std::vector<SlowFile> m_slowest;    ///< a min-heap on duration, so the fastest of the slowest files is replaced first
+};
+
+} // namespace mnxvalidate
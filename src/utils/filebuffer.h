@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "stringutils.h"
+
+namespace utils {
+
+/**
+ * @brief The contents of an input file, memory-mapped when that is worthwhile and read into memory otherwise.
+ *
+ * Mapping lets the parser read large files straight from the page cache, without a heap copy the size of the file.
+ * Small files are cheaper to read than to map, and pipes and other non-regular files cannot be mapped, so those
+ * are read into a buffer.
+ *
+ * A mapping is only as stable as the file: if another process truncates it while it is mapped, reading the lost pages
+ * raises SIGBUS instead of an error. Pass `allowMapping = false` for files that may be rewritten while they are read,
+ * such as the inputs of --watch, which are revalidated as soon as an editor saves them.
+ */
+class FileBuffer
+{
+public:
+    static constexpr std::uintmax_t kMinMappedSize = 1024 * 1024; ///< files smaller than this are always read
+
+    /// @brief Opens and maps or reads the file. Throws std::runtime_error if it cannot be read.
+    explicit FileBuffer(const std::filesystem::path& path, bool allowMapping = true)
+    {
+        if (!allowMapping || !map(path)) {
+            read(path);
+        }
+    }
+
+    ~FileBuffer() { unmap(); }
+
+    FileBuffer(const FileBuffer&) = delete;
+    FileBuffer& operator=(const FileBuffer&) = delete;
+
+    std::string_view view() const
+    { return m_mapping ? std::string_view(static_cast<const char*>(m_mapping), m_mappedSize) : std::string_view(m_buffer); }
+
+    bool isMapped() const { return m_mapping != nullptr; }
+
+private:
+    bool map(const std::filesystem::path& path)
+    {
+#ifdef _WIN32
+        HANDLE file = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER size{};
+        if (::GetFileType(file) == FILE_TYPE_DISK && ::GetFileSizeEx(file, &size) && std::uintmax_t(size.QuadPart) >= kMinMappedSize) {
+            HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping) {
+                m_mapping = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                ::CloseHandle(mapping); // the view keeps the mapping alive
+                m_mappedSize = m_mapping ? static_cast<size_t>(size.QuadPart) : 0;
+            }
+        }
+        ::CloseHandle(file);
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info{};
+        if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && std::uintmax_t(info.st_size) >= kMinMappedSize) {
+            void* mapping = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                ::madvise(mapping, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL); // the parser reads it front to back, once
+                m_mapping = mapping;
+                m_mappedSize = static_cast<size_t>(info.st_size);
+            }
+        }
+        ::close(fd); // the mapping stays valid without the descriptor
+#endif
+        return m_mapping != nullptr;
+    }
+
+    void unmap()
+    {
+        if (m_mapping) {
+#ifdef _WIN32
+            ::UnmapViewOfFile(m_mapping);
+#else
+            ::munmap(m_mapping, m_mappedSize);
+#endif
+            m_mapping = nullptr;
+        }
+    }
+
+    void read(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Unable to open " + pathToString(path));
+        }
+        // the size is not known in advance for pipes and devices, so read in chunks
+        constexpr size_t kChunkSize = 64 * 1024;
+        std::error_code ec;
+        const auto size = std::filesystem::is_regular_file(path, ec) ? std::filesystem::file_size(path, ec) : 0;
+        m_buffer.reserve(ec ? 0 : static_cast<size_t>(size));
+        char chunk[kChunkSize];
+        while (file.read(chunk, kChunkSize) || file.gcount() > 0) {
+            m_buffer.append(chunk, static_cast<size_t>(file.gcount()));
+        }
+        if (file.bad()) {
+            throw std::runtime_error("Unable to read " + pathToString(path));
+        }
+    }
+
+    std::string m_buffer;
+    void* m_mapping{};
+    size_t m_mappedSize{};
+};
+
+} // namespace utils
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "nlohmann/json.hpp"
+
+// Helpers shared by the streaming validator, the generated validator and the generator (tools/schemagen.cpp),
+// which is built for the host and so cannot link the library. Everything here is inline for that reason.
+
+namespace utils {
+
+/// The json types a schema can allow, as bits
+enum TypeBits : std::uint8_t
+{
+    TypeNull = 1 << 0,
+    TypeBoolean = 1 << 1,
+    TypeInteger = 1 << 2,
+    TypeNumber = 1 << 3,    ///< any number, including integers
+    TypeString = 1 << 4,
+    TypeArray = 1 << 5,
+    TypeObject = 1 << 6,
+    TypeAny = 0x7f
+};
+
+inline std::uint8_t typeBitsFor(const std::string& name)
+{
+    if (name == "null") return TypeNull;
+    if (name == "boolean") return TypeBoolean;
+    if (name == "integer") return TypeInteger;
+    if (name == "number") return TypeNumber | TypeInteger;
+    if (name == "string") return TypeString;
+    if (name == "array") return TypeArray;
+    if (name == "object") return TypeObject;
+    throw std::invalid_argument("unknown type '" + name + "' in schema");
+}
+
+inline std::string escapePointerToken(std::string_view token)
+{
+    std::string result;
+    result.reserve(token.size());
+    for (const char c : token) {
+        if (c == '~') {
+            result += "~0";
+        } else if (c == '/') {
+            result += "~1";
+        } else {
+            result += c;
+        }
+    }
+    return result;
+}
+
+/// The number of code points in utf-8 text, for minLength and maxLength
+inline size_t utf8Length(std::string_view text)
+{
+    size_t length = 0;
+    for (const char c : text) {
+        length += (static_cast<unsigned char>(c) & 0xC0) != 0x80; // count every byte that starts a code point
+    }
+    return length;
+}
+
+/// A schema limit as the generic validator prints it in its messages
+inline std::string formatNumber(double value)
+{
+    if (value == std::floor(value) && std::fabs(value) < 1e15) {
+        return std::to_string(static_cast<std::int64_t>(value));
+    }
+    return nlohmann::json(value).dump();
+}
+
+} // namespace utils
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace utils {
+
+/**
+ * @brief A bounded, lock-free queue for exactly one producer thread and one consumer thread.
+ *
+ * Neither side takes a lock. When the queue is full, #push blocks until the consumer makes room, and
+ * #waitWhileEmpty blocks the consumer until something is pushed. Both block with std::atomic::wait,
+ * so an idle side costs nothing.
+ */
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    /// @brief Adds a value, waiting for room if the queue is full. Producer thread only.
+    void push(T&& value)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t head = m_head.load(std::memory_order_acquire);
+        while (tail - head == Capacity) {
+            m_head.wait(head, std::memory_order_acquire);
+            head = m_head.load(std::memory_order_acquire);
+        }
+        m_slots[tail & (Capacity - 1)] = std::move(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        m_tail.notify_one();
+    }
+
+    /// @brief Removes the oldest value into @p value, or returns false if the queue is empty. Consumer thread only.
+    bool tryPop(T& value)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(m_slots[head & (Capacity - 1)]);
+        m_head.store(head + 1, std::memory_order_release);
+        m_head.notify_one();
+        return true;
+    }
+
+    /// @brief Blocks until the queue is not empty. Consumer thread only.
+    void waitWhileEmpty() const
+    {
+        m_tail.wait(m_head.load(std::memory_order_relaxed), std::memory_order_acquire);
+    }
+
+private:
+    std::array<T, Capacity> m_slots{};
+    alignas(64) std::atomic<size_t> m_head{};   ///< the next slot to pop, written by the consumer
+    alignas(64) std::atomic<size_t> m_tail{};   ///< the next slot to push, written by the producer
+};
+
+} // namespace utils
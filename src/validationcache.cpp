@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <cstring>
+#include <algorithm>
+
+#include "validationcache.h"
+
+namespace {
+
+constexpr char kCacheMagic[] = "mnxvalidate-cache 2";
+constexpr char kEntryExtension[] = ".entry";
+
+std::uint64_t mix(std::uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+// A fast non-cryptographic hash that consumes 8 bytes per step.
+std::uint64_t hashBytes(std::string_view data, std::uint64_t seed)
+{
+    std::uint64_t hash = mix(seed ^ (data.size() * 0x9e3779b97f4a7c15ull));
+    size_t x = 0;
+    for (; x + sizeof(std::uint64_t) <= data.size(); x += sizeof(std::uint64_t)) {
+        std::uint64_t word;
+        std::memcpy(&word, data.data() + x, sizeof(word));
+        hash = (hash ^ mix(word)) * 0x9e3779b97f4a7c15ull;
+    }
+    std::uint64_t tail = 0;
+    if (x < data.size()) { // an empty view may have a null data(), which memcpy must not be given even for no bytes
+        std::memcpy(&tail, data.data() + x, data.size() - x);
+    }
+    return mix(hash ^ mix(tail));
+}
+
+std::string toHex(std::uint64_t value)
+{
+    constexpr char kDigits[] = "0123456789abcdef";
+    std::string result(16, '0');
+    for (size_t x = result.size(); x > 0; x--) {
+        result[x - 1] = kDigits[value & 0xf];
+        value >>= 4;
+    }
+    return result;
+}
+
+} // namespace
+
+namespace mnxvalidate {
+
+ValidationCache::ValidationCache(const std::filesystem::path& cacheDir, const std::string& configuration, std::uintmax_t maxBytes)
+    : m_cacheDir(cacheDir), m_configHash(hashBytes(configuration, 0)), m_maxBytes(maxBytes)
+{
+    std::filesystem::create_directories(m_cacheDir);
+}
+
+std::string ValidationCache::keyFor(std::string_view fileContents) const
+{
+    // two independently seeded hashes make a 128-bit key
+    return toHex(hashBytes(fileContents, m_configHash)) + toHex(hashBytes(fileContents, ~m_configHash));
+}
+
+std::filesystem::path ValidationCache::entryPath(const std::string& key) const
+{
+    // shard by the first byte of the key to keep directories small
+    return m_cacheDir / key.substr(0, 2) / (key + kEntryExtension);
+}
+
+std::optional<CachedResult> ValidationCache::lookup(const std::string& key)
+{
+    const auto path = entryPath(key);
+    std::ifstream entry(path, std::ios::binary);
+    std::string magic;
+    size_t messageCount{};
+    size_t diagnosticCount{};
+    int phase{};
+    if (entry && std::getline(entry, magic) && magic == kCacheMagic && entry >> messageCount >> diagnosticCount >> phase) {
+        CachedResult result;
+        result.phase = static_cast<ValidationPhase>(phase);
+        result.messages.reserve(messageCount);
+        int severity{};
+        int alwaysShow{};
+        size_t length{};
+        while (result.messages.size() < messageCount && entry >> severity >> alwaysShow >> length && entry.get() == '\n') {
+            BufferedLogMsg msg{ {}, std::string(length, '\0'), static_cast<LogSeverity>(severity), alwaysShow != 0 };
+            if (!entry.read(msg.text.data(), static_cast<std::streamsize>(length)) || entry.get() != '\n') {
+                break;
+            }
+            result.messages.push_back(std::move(msg));
+        }
+        size_t pointerLength{};
+        std::string pointer;
+        std::string message;
+        while (result.messages.size() == messageCount && result.diagnostics.size() < diagnosticCount
+               && entry >> phase >> pointerLength >> length && entry.get() == '\n') {
+            pointer.resize(pointerLength);
+            message.resize(length);
+            if (!entry.read(pointer.data(), static_cast<std::streamsize>(pointerLength))
+                || !entry.read(message.data(), static_cast<std::streamsize>(length)) || entry.get() != '\n') {
+                break;
+            }
+            result.diagnostics.add(static_cast<ValidationPhase>(phase), pointer, message);
+        }
+        // a truncated or otherwise damaged entry is a miss
+        if (result.messages.size() == messageCount && result.diagnostics.size() == diagnosticCount) {
+            std::error_code ec;
+            std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec); // keep it from being trimmed
+            m_hits++;
+            return result;
+        }
+    }
+    m_misses++;
+    return std::nullopt;
+}
+
+void ValidationCache::store(const std::string& key, const CachedResult& result)
+{
+    const auto path = entryPath(key);
+    std::ostringstream tempName;
+    tempName << key << ".tmp." << std::this_thread::get_id() << "." << std::chrono::steady_clock::now().time_since_epoch().count();
+    const auto tempPath = path.parent_path() / tempName.str();
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    {
+        std::ofstream entry(tempPath, std::ios::binary | std::ios::trunc);
+        entry << kCacheMagic << '\n' << result.messages.size() << ' ' << result.diagnostics.size() << ' ' << static_cast<int>(result.phase) << '\n';
+        for (const auto& msg : result.messages) {
+            entry << static_cast<int>(msg.severity) << ' ' << int(msg.alwaysShow) << ' ' << msg.text.size() << '\n' << msg.text << '\n';
+        }
+        for (const auto& diagnostic : result.diagnostics) {
+            entry << static_cast<int>(diagnostic.phase) << ' ' << diagnostic.pointer.size() << ' ' << diagnostic.message.size() << '\n'
+                  << diagnostic.pointer << diagnostic.message << '\n';
+        }
+        if (!entry.flush()) {
+            entry.close();
+            std::filesystem::remove(tempPath, ec);
+            return;
+        }
+    }
+    std::filesystem::rename(tempPath, path, ec); // atomic, so readers never see a partial entry
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return;
+    }
+    m_stores++;
+}
+
+void ValidationCache::trim()
+{
+    if (m_stores == 0) {
+        return; // nothing was added, so nothing can have grown past the limit
+    }
+    struct Entry
+    {
+        std::filesystem::path path;
+        std::filesystem::file_time_type lastUsed;
+        std::uintmax_t size;
+    };
+    std::vector<Entry> entries;
+    std::uintmax_t totalSize = 0;
+    std::error_code ec;
+    for (auto it = std::filesystem::recursive_directory_iterator(m_cacheDir, ec); !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+        if (it->is_regular_file(ec) && it->path().extension() == kEntryExtension) {
+            Entry entry{ it->path(), it->last_write_time(ec), it->file_size(ec) };
+            if (!ec) {
+                totalSize += entry.size;
+                entries.push_back(std::move(entry));
+            }
+        }
+    }
+    if (totalSize <= m_maxBytes) {
+        return;
+    }
+    // trim to 90% of the limit so that the next run does not immediately have to trim again
+    const std::uintmax_t targetSize = m_maxBytes - m_maxBytes / 10;
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.lastUsed < b.lastUsed; });
+    for (const auto& entry : entries) {
+        if (totalSize <= targetSize) {
+            break;
+        }
+        if (std::filesystem::remove(entry.path, ec)) { // another process may have removed it already
+            totalSize -= entry.size;
+        }
+    }
+}
+
+} // namespace mnxvalidate
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+
+#include "mnxvalidate.h"
+
+namespace mnxvalidate {
+
+/// @brief What the cache stores for one file
+struct CachedResult
+{
+    std::vector<BufferedLogMsg> messages;   ///< the messages logged after the file's header
+    DiagnosticList diagnostics;             ///< the errors recorded for reports
+    ValidationPhase phase{};                ///< the phase that decided the result
+};
+
+/**
+ * @brief An on-disk cache of validation results, keyed by the content of the validated file.
+ *
+ * Each entry holds the messages logged for one file after its header, and the errors recorded for reports. The key is a hash of the file's bytes
+ * combined with everything else that affects the result: the schema text, the program and mnxdom versions,
+ * and --schema-only. Entries are written to a temporary file and renamed into place, so any number of
+ * threads or processes can share a cache directory.
+ */
+class ValidationCache
+{
+public:
+    /**
+     * @brief Opens (and if necessary creates) the cache directory
+     * @param cacheDir the cache directory
+     * @param configuration text that identifies every setting other than file content that affects the result
+     * @param maxBytes the size the cache is trimmed to by #trim
+     */
+    ValidationCache(const std::filesystem::path& cacheDir, const std::string& configuration, std::uintmax_t maxBytes);
+
+    /// @brief computes the cache key for a file's contents
+    std::string keyFor(std::string_view fileContents) const;
+
+    /// @brief returns the cached result for the key, if there is one. Thread-safe.
+    std::optional<CachedResult> lookup(const std::string& key);
+
+    /// @brief stores the result for the key. Thread-safe. Failure to write is not an error.
+    void store(const std::string& key, const CachedResult& result);
+
+    /// @brief removes the least recently used entries until the cache fits in its size limit
+    void trim();
+
+    size_t hits() const { return m_hits; }
+    size_t misses() const { return m_misses; }
+
+private:
+    std::filesystem::path entryPath(const std::string& key) const;
+
+    std::filesystem::path m_cacheDir;
+    std::uint64_t m_configHash{};
+    std::uintmax_t m_maxBytes{};
+    std::atomic<size_t> m_hits{};
+    std::atomic<size_t> m_misses{};
+    std::atomic<size_t> m_stores{};
+};
+
+} // namespace mnxvalidate
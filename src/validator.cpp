@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <algorithm>
+#include <thread>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "validator.h"
+#include "compression.h"
+#include "utils/filebuffer.h"
+#include "utils/stringutils.h"
+#include "semanticshards.h"
+#include "mnxdom.h"
+
+namespace mnxvalidate {
+
+using Clock = std::chrono::steady_clock;
+
+unsigned defaultJobCount()
+{
+#ifdef __linux__
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0) {
+        const int cpuCount = CPU_COUNT(&cpuSet);
+        if (cpuCount > 0) {
+            return static_cast<unsigned>(cpuCount);
+        }
+    }
+#endif
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+static void addDiagnostic(ValidationResult& result, ValidationPhase phase, std::string_view pointer, std::string_view message)
+{
+    result.phase = phase;
+    result.diagnostics.add(phase, pointer, message);
+}
+
+static void addSchemaErrors(ValidationResult& result, const SchemaValidationResult& schemaResult)
+{
+    for (const auto& error : schemaResult.errors) {
+        addDiagnostic(result, ValidationPhase::Schema, error.pointer, error.message);
+    }
+    result.truncated = schemaResult.truncated;
+}
+
+Validator::Validator(const std::optional<std::string>& schemaText, ValidatorOptions options)
+    : Validator(std::make_shared<const SchemaValidator>(schemaText), options)
+{
+}
+
+Validator::Validator(std::shared_ptr<const SchemaValidator> schema, ValidatorOptions options)
+    : m_schema(std::move(schema)), m_options(options)
+{
+    if (!m_schema) {
+        throw std::invalid_argument("Validator requires a schema");
+    }
+}
+
+ValidationResult Validator::validate(std::string_view contents, const std::atomic<bool>* cancel) const
+{
+    ValidationResult result;
+    result.timings.bytesRead = contents.size();
+    auto phaseStart = Clock::now();
+
+    // Schema-only validation needs no document when the schema can be checked as the json is parsed, so memory
+    // use depends on how deeply the json nests rather than on its size.
+    // Compressed input is decompressed as it is parsed, so the decompressed text is never held in memory.
+    const Compression compression = detectCompression(contents);
+    if (m_options.schemaOnly && m_schema->canStream()) {
+        try {
+            // parsing and validation are one pass, so their time is recorded as schema validation
+            result.phase = ValidationPhase::Schema;
+            std::optional<Decompressor> decompressor;
+            if (compression != Compression::None) {
+                decompressor.emplace(contents, compression);
+            }
+            auto schemaResult = decompressor ? m_schema->validateText(decompressor.value(), m_options.maxErrors)
+                                             : m_schema->validateText(contents, m_options.maxErrors);
+            result.timings.record(ValidationPhase::Schema, phaseStart);
+            addSchemaErrors(result, schemaResult);
+        } catch (const DecompressionError& e) {
+            result.timings.record(ValidationPhase::Schema, phaseStart);
+            addDiagnostic(result, ValidationPhase::Read, {}, e.what());
+        } catch (const nlohmann::json::exception& e) {
+            result.timings.record(ValidationPhase::Parse, phaseStart);
+            addDiagnostic(result, ValidationPhase::Parse, {}, e.what());
+        } catch (const std::exception& e) {
+            result.timings.record(ValidationPhase::Schema, phaseStart);
+            addDiagnostic(result, ValidationPhase::Schema, {}, e.what());
+        }
+        return result;
+    }
+
+    const auto isCancelled = [&]() {
+        result.cancelled = cancel && cancel->load();
+        return result.cancelled;
+    };
+    try {
+        result.phase = ValidationPhase::Parse;
+        // parsing from contiguous memory is much faster than parsing from a stream
+        auto root = std::make_shared<mnx::json>();
+        if (compression == Compression::None) {
+            *root = mnx::json::parse(contents.begin(), contents.end());
+        } else {
+            Decompressor decompressor(contents, compression);
+            *root = mnx::json::parse(decompressor.begin(), decompressor.end());
+        }
+        mnx::json& rootJson = *root;
+        auto document = std::make_unique<mnx::Document>(std::move(root));
+        phaseStart = result.timings.record(ValidationPhase::Parse, phaseStart);
+        if (isCancelled()) {
+            return result;
+        }
+        result.phase = ValidationPhase::Schema;
+        addSchemaErrors(result, m_schema->validate(*document, m_options.maxErrors));
+        phaseStart = result.timings.record(ValidationPhase::Schema, phaseStart);
+        if (!result.diagnostics.empty() || m_options.schemaOnly || isCancelled()) {
+            return result;
+        }
+        result.phase = ValidationPhase::Semantic;
+        result.stats = DocumentStats{ document->global().measures().size(), document->parts().size(),
+                                      document->layouts() ? document->layouts().value().size() : 0 };
+        removeSkippedRuleContent(rootJson, m_options.skippedRules);
+        // Split documents only show that they are valid. Any error is reported by the serial check, so the output does not change.
+        const unsigned semanticJobs = m_options.semanticJobs ? m_options.semanticJobs : defaultJobCount();
+        bool splitValid = false;
+        if (semanticJobs > 1 && result.stats->parts > 1 && semanticWorkload(rootJson) >= m_options.semanticSplitThreshold) {
+            const auto splitStart = Clock::now();
+            splitValid = semanticShardsValid(rootJson, semanticJobs);
+            if (!splitValid) {
+                result.timings.discardedSplit = Clock::now() - splitStart;
+            }
+        }
+        if (!splitValid) {
+            auto semanticResult = mnx::validation::semanticValidate(*document);
+            const size_t errorCount = m_options.maxErrors ? std::min(m_options.maxErrors, semanticResult.errors.size()) : semanticResult.errors.size();
+            for (size_t x = 0; x < errorCount; x++) {
+                addDiagnostic(result, ValidationPhase::Semantic, {}, semanticResult.errors[x].to_string());
+            }
+            if (errorCount < semanticResult.errors.size()) {
+                result.truncated = true;
+                result.omittedErrorCount = semanticResult.errors.size() - errorCount;
+            }
+        }
+        result.timings.record(ValidationPhase::Semantic, phaseStart);
+    } catch (const DecompressionError& e) {
+        // the document is decompressed as it is parsed, so corrupt input surfaces during parsing
+        result.timings.record(ValidationPhase::Parse, phaseStart);
+        addDiagnostic(result, ValidationPhase::Read, {}, e.what());
+    } catch (const std::exception& e) {
+        // json errors, and anything the checks throw on a document they cannot make sense of, fail the phase that was running
+        result.timings.record(result.phase, phaseStart);
+        addDiagnostic(result, result.phase, {}, e.what());
+    }
+    return result;
+}
+
+ValidationResult Validator::validateFile(const std::filesystem::path& path) const
+{
+    return validateInput({ path, std::nullopt });
+}
+
+ValidationResult Validator::validateInput(const ValidationInput& input) const
+{
+    const auto readStart = Clock::now();
+    std::optional<utils::FileBuffer> fileBuffer;
+    if (!input.contents) {
+        try {
+            fileBuffer.emplace(input.path);
+        } catch (const std::exception& e) {
+            ValidationResult result;
+            result.name = utils::pathToString(input.path);
+            result.timings.record(ValidationPhase::Read, readStart);
+            addDiagnostic(result, ValidationPhase::Read, {}, e.what());
+            return result;
+        }
+    }
+    const auto readTime = Clock::now() - readStart;
+    ValidationResult result = validate(fileBuffer ? fileBuffer->view() : std::string_view(input.contents.value()));
+    result.name = utils::pathToString(input.path);
+    result.timings.phases[static_cast<size_t>(ValidationPhase::Read)] = readTime;
+    return result;
+}
+
+std::vector<ValidationResult> Validator::validateBatch(const std::vector<ValidationInput>& inputs) const
+{
+    std::vector<ValidationResult> results(inputs.size());
+    std::atomic<size_t> nextInput{};
+    auto work = [&]() {
+        for (size_t x = nextInput++; x < inputs.size(); x = nextInput++) {
+            results[x] = validateInput(inputs[x]);
+        }
+    };
+    const size_t workerCount = std::min<size_t>(m_options.jobs ? m_options.jobs : defaultJobCount(), inputs.size());
+    std::vector<std::thread> workers;
+    for (size_t x = 1; x < workerCount; x++) {
+        workers.emplace_back(work);
+    }
+    work(); // the calling thread is one of the workers
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return results;
+}
+
+} // namespace mnxvalidate
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <optional>
+#include <memory>
+#include <filesystem>
+#include <chrono>
+#include <atomic>
+#include <cstdint>
+
+#include "schemavalidator.h"
+#include "diagnosticlist.h"
+#include "semanticrules.h"
+
+namespace mnxvalidate {
+
+/// @brief An input to validate: a file, or a document that is already in memory
+struct ValidationInput
+{
+    std::filesystem::path path;                 ///< the file to read, or the name to report for #contents
+    std::optional<std::string> contents;        ///< the document, if it is already in memory
+};
+
+/// @brief How long each phase took for one input, recorded for --timings and reports
+struct FileTimings
+{
+    /// @brief indexed by #ValidationPhase. A phase that did not run (because an earlier one failed or the result was cached) has no value.
+    std::array<std::optional<std::chrono::steady_clock::duration>, 4> phases;
+    std::uintmax_t bytesRead{};     ///< the size of the input
+    /// @brief Time spent on split semantic checks that found an error, after which the document was checked again on one thread.
+    /// It is included in the semantic phase.
+    std::optional<std::chrono::steady_clock::duration> discardedSplit;
+
+    /// @brief records the time since @p start as the duration of @p timedPhase and returns the current time
+    std::chrono::steady_clock::time_point record(ValidationPhase timedPhase, std::chrono::steady_clock::time_point start)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        phases[static_cast<size_t>(timedPhase)] = now - start;
+        return now;
+    }
+};
+
+/// @brief The size of a document that passed schema validation
+struct DocumentStats
+{
+    size_t measures{};
+    size_t parts{};
+    size_t layouts{};
+};
+
+/// @brief The result of validating one input
+struct ValidationResult
+{
+    std::string name;                           ///< the utf-8 encoded name of the input, for batches
+    ValidationPhase phase{ ValidationPhase::Read }; ///< the phase that failed, or the last phase that ran if none failed
+    DiagnosticList diagnostics;                 ///< every error found, up to the error limit
+    std::optional<DocumentStats> stats;         ///< set if semantic validation ran
+    bool truncated{};                           ///< validation stopped at the error limit, so the input may have more errors
+    size_t omittedErrorCount{};                 ///< semantic errors found beyond the error limit, which are not in #diagnostics
+    bool cancelled{};                           ///< validation was abandoned between phases, so the result is incomplete
+    FileTimings timings;
+
+    bool valid() const { return diagnostics.empty() && !cancelled; }
+    explicit operator bool() const { return valid(); }
+};
+
+/// @brief The options a #Validator applies to every input
+struct ValidatorOptions
+{
+    bool schemaOnly{};          ///< only validate against the schema
+    size_t maxErrors{};         ///< stop reporting errors for an input once this many have been found (0 means no limit)
+    unsigned jobs{};            ///< the number of threads #Validator::validateBatch uses (0 means one per usable CPU)
+    unsigned semanticJobs{ 1 }; ///< the number of threads that check the semantics of one large document (0 means one per usable CPU, 1 means no splitting)
+    size_t semanticSplitThreshold{ kDefaultSemanticSplitThreshold }; ///< documents with fewer measures than this, summed over their parts, are checked on one thread
+
+    SemanticRuleSet skippedRules; ///< the semantic rule groups that are not checked
+
+    static constexpr size_t kDefaultSemanticSplitThreshold = 20000;
+};
+
+/**
+ * @brief Validates MNX documents with a schema compiled once, returning structured results rather than logging.
+ *
+ * A Validator does not change after it is constructed, so any number of threads can share one.
+ */
+class Validator
+{
+public:
+    /// @brief Compiles the schema text, or the embedded MNX schema if none is supplied. Throws if the schema is invalid.
+    explicit Validator(const std::optional<std::string>& schemaText = std::nullopt, ValidatorOptions options = {});
+
+    /// @brief Uses a schema that has already been compiled, which may be shared with other validators
+    Validator(std::shared_ptr<const SchemaValidator> schema, ValidatorOptions options);
+
+    /**
+     * @brief Validates a document that is in memory.
+     * @param contents the document
+     * @param cancel if set, checked between phases. Once it is true, validation stops and the result is marked cancelled.
+     */
+    ValidationResult validate(std::string_view contents, const std::atomic<bool>* cancel = nullptr) const;
+
+    /// @brief Reads and validates a file. A file that cannot be read fails in the read phase.
+    ValidationResult validateFile(const std::filesystem::path& path) const;
+
+    /// @brief Validates the inputs on up to #ValidatorOptions::jobs threads. The results are in input order.
+    std::vector<ValidationResult> validateBatch(const std::vector<ValidationInput>& inputs) const;
+
+    const ValidatorOptions& options() const { return m_options; }
+    const SchemaValidator& schema() const { return *m_schema; }
+
+private:
+    ValidationResult validateInput(const ValidationInput& input) const;
+
+    std::shared_ptr<const SchemaValidator> m_schema;
+    ValidatorOptions m_options;
+};
+
+unsigned defaultJobCount(); ///< the number of CPUs this process may run on
+
+} // namespace mnxvalidate
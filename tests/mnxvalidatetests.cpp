@@ -68,6 +68,20 @@ void checkStderr(const std::vector<std::string>& expectedMessages, std::function
     }
 }
 
+std::string captureStderr(ArgList& args, int& result)
+{
+    std::ostringstream nullStream; // used to suppress std::cout
+    std::streambuf* originalCout = std::cout.rdbuf(nullStream.rdbuf());
+    std::ostringstream errStream;
+    std::streambuf* originalCerr = std::cerr.rdbuf(errStream.rdbuf());
+
+    result = mnxValidateTestMain(args.argc(), args.argv());
+
+    std::cout.rdbuf(originalCout);
+    std::cerr.rdbuf(originalCerr);
+    return errStream.str();
+}
+
 void checkStdout(const std::vector<std::string>& expectedMessages, std::function<void()> callback)
 {
     // Redirect stdout to capture messages
@@ -130,6 +144,14 @@ void copyInputToOutput(const std::string& fileName, std::filesystem::path& outpu
     ASSERT_TRUE(std::filesystem::exists(outputPath));
 }
 
+void writeFile(const std::filesystem::path& path, const std::string& contents)
+{
+    std::ofstream file;
+    file.exceptions(std::ios::failbit | std::ios::badbit);
+    file.open(path, std::ios::binary | std::ios::trunc);
+    file << contents;
+}
+
 void compareFiles(const std::filesystem::path& path1, const std::filesystem::path& path2)
 {
     ASSERT_TRUE(std::filesystem::is_regular_file(path1)) << "unable to find " << utils::pathToString(path1);
@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "mnxvalidate.h"
+#include "archivereader.h"
+#include "compression.h"
+#include "test_utils.h"
+
+using namespace mnxvalidate;
+
+namespace {
+
+struct TestEntry
+{
+    std::string name;
+    std::string contents;
+    bool deflate{};
+    bool encrypted{};
+};
+
+void appendLittleEndian(std::string& output, std::uint64_t value, size_t byteCount)
+{
+    for (size_t x = 0; x < byteCount; x++) {
+        output.push_back(static_cast<char>((value >> (8 * x)) & 0xff));
+    }
+}
+
+// A minimal zip writer. Deflated data is taken from a gzip member, whose trailer also holds the crc.
+std::string makeZip(const std::vector<TestEntry>& entries)
+{
+    std::string archive;
+    std::string directory;
+    for (const auto& entry : entries) {
+        const std::string gzip = compress(entry.contents, Compression::Gzip);
+        const std::string crc = gzip.substr(gzip.size() - 8, 4);
+        const std::string data = entry.deflate ? gzip.substr(10, gzip.size() - 18) : entry.contents;
+        auto appendCommon = [&](std::string& output) {
+            appendLittleEndian(output, 20, 2);                          // version needed
+            appendLittleEndian(output, entry.encrypted ? 1 : 0, 2);     // flags
+            appendLittleEndian(output, entry.deflate ? 8 : 0, 2);       // method
+            appendLittleEndian(output, 0, 4);                           // time and date
+            output += crc;
+            appendLittleEndian(output, data.size(), 4);
+            appendLittleEndian(output, entry.contents.size(), 4);
+            appendLittleEndian(output, entry.name.size(), 2);
+            appendLittleEndian(output, 0, 2);                           // extra length
+        };
+        const size_t localOffset = archive.size();
+        appendLittleEndian(archive, 0x04034b50, 4);
+        appendCommon(archive);
+        archive += entry.name + data;
+
+        appendLittleEndian(directory, 0x02014b50, 4);
+        appendLittleEndian(directory, 20, 2);                           // version made by
+        appendCommon(directory);
+        appendLittleEndian(directory, 0, 2 + 2 + 2);                    // comment length, disk, internal attributes
+        appendLittleEndian(directory, 0, 4);                            // external attributes
+        appendLittleEndian(directory, localOffset, 4);
+        directory += entry.name;
+    }
+    const size_t directoryOffset = archive.size();
+    archive += directory;
+    appendLittleEndian(archive, 0x06054b50, 4);
+    appendLittleEndian(archive, 0, 4);                                  // disk numbers
+    appendLittleEndian(archive, entries.size(), 2);
+    appendLittleEndian(archive, entries.size(), 2);
+    appendLittleEndian(archive, directory.size(), 4);
+    appendLittleEndian(archive, directoryOffset, 4);
+    appendLittleEndian(archive, 0, 2);                                  // comment length
+    return archive;
+}
+
+std::string tarHeader(const std::string& name, size_t size, char type)
+{
+    std::string header(512, '\0');
+    header.replace(0, std::min<size_t>(name.size(), 100), name.substr(0, 100));
+    auto octal = [&](size_t offset, size_t width, std::uint64_t value) {
+        std::string digits(width - 1, '0');
+        for (size_t x = width - 1; x-- > 0 && value; value /= 8) {
+            digits[x] = static_cast<char>('0' + value % 8);
+        }
+        header.replace(offset, width - 1, digits);
+    };
+    octal(100, 8, 0644);
+    octal(124, 12, size);
+    header[156] = type;
+    header.replace(257, 6, std::string("ustar\0", 6));
+    header.replace(263, 2, "00");
+    header.replace(148, 8, 8, ' ');
+    std::uint64_t sum = 0;
+    for (char c : header) {
+        sum += static_cast<unsigned char>(c);
+    }
+    octal(148, 7, sum);
+    return header;
+}
+
+// A minimal ustar writer. Names longer than 100 bytes get a GNU long name entry.
+std::string makeTar(const std::vector<TestEntry>& entries)
+{
+    std::string archive;
+    auto appendData = [&](const std::string& data) {
+        archive += data;
+        archive.append((512 - data.size() % 512) % 512, '\0');
+    };
+    for (const auto& entry : entries) {
+        if (entry.name.size() > 100) {
+            archive += tarHeader("././@LongLink", entry.name.size() + 1, 'L');
+            appendData(entry.name + '\0');
+        }
+        archive += tarHeader(entry.name, entry.contents.size(), '0');
+        appendData(entry.contents);
+    }
+    archive.append(1024, '\0');
+    return archive;
+}
+
+std::vector<TestEntry> testEntries()
+{
+    const std::string valid = utils::fileToString(getInputPath() / "valid.mnx");
+    return {
+        { "top.mnx", valid, true },
+        { "./scores/deflated.mnx", valid, true },
+        { "scores/stored.json", valid, false },
+        { "scores/compressed.mnx.gz", compress(valid, Compression::Gzip), false },
+        { "scores/broken.mnx", R"({"mnx": )", true },
+        { "scores/readme.txt", "not an input", false },
+        { "scores/" + std::string(120, 'x') + ".mnx", valid, false },
+    };
+}
+
+std::vector<std::string> readNames(const std::filesystem::path& archivePath, std::vector<std::string>* errors = nullptr)
+{
+    ArchiveReader reader(archivePath);
+    const Validator validator;
+    std::vector<std::string> names;
+    while (auto entry = reader.next([](std::string_view name) { return !name.ends_with(".txt"); })) {
+        const bool expectValid = entry->name.find("broken") == std::string::npos;
+        EXPECT_EQ(validator.validate(entry->contents).valid(), expectValid) << entry->name;
+        names.push_back(entry->name);
+    }
+    if (errors) {
+        *errors = reader.errors();
+    }
+    return names;
+}
+
+} // namespace
+
+TEST(Archive, EntryPaths)
+{
+    const auto split = ArchiveReader::splitEntryPath("in/bundle.zip!/scores/*.mnx");
+    ASSERT_TRUE(split.has_value());
+    EXPECT_EQ(split->archive, std::filesystem::path("in/bundle.zip"));
+    EXPECT_EQ(split->entry, "scores/*.mnx");
+    EXPECT_FALSE(ArchiveReader::splitEntryPath("in/wow!/score.mnx").has_value()) << "only archives have entries";
+    EXPECT_EQ(ArchiveReader::entryPath("in/bundle.tar.gz", "a.mnx"), std::filesystem::path("in/bundle.tar.gz!/a.mnx"));
+    for (const char* name : { "a.zip", "a.tar", "a.TGZ", "a.tzst", "a.tar.gz", "a.tar.zst" }) {
+        EXPECT_TRUE(ArchiveReader::isArchivePath(name)) << name;
+    }
+    for (const char* name : { "a.mnx", "a.mnx.gz", "a.gz", "tar" }) {
+        EXPECT_FALSE(ArchiveReader::isArchivePath(name)) << name;
+    }
+}
+
+TEST(Archive, ReadsZipAndTar)
+{
+    setupTestDataPaths();
+    const auto outputDir = getOutputPath() / "archives";
+    std::filesystem::create_directories(outputDir);
+    auto entries = testEntries();
+    const std::vector<std::string> expected = { "top.mnx", "scores/deflated.mnx", "scores/stored.json", "scores/compressed.mnx.gz",
+                                                "scores/broken.mnx", entries.back().name };
+
+    const std::string tar = makeTar(entries);
+    writeFile(outputDir / "bundle.tar", tar);
+    EXPECT_EQ(readNames(outputDir / "bundle.tar"), expected);
+    writeFile(outputDir / "bundle.tar.gz", compress(tar, Compression::Gzip));
+    EXPECT_EQ(readNames(outputDir / "bundle.tar.gz"), expected);
+
+    entries.push_back({ "scores/secret.mnx", "{}", false, true });
+    writeFile(outputDir / "bundle.zip", makeZip(entries));
+    std::vector<std::string> errors;
+    EXPECT_EQ(readNames(outputDir / "bundle.zip", &errors), expected);
+    ASSERT_EQ(errors.size(), 1u);
+    EXPECT_NE(errors[0].find("bundle.zip!/scores/secret.mnx: encrypted"), std::string::npos) << errors[0];
+
+    writeFile(outputDir / "notarchive.zip", "PK\x03\x04 but nothing else");
+    EXPECT_THROW(ArchiveReader(outputDir / "notarchive.zip"), std::runtime_error);
+    writeFile(outputDir / "notarchive.tar", std::string(600, 'x'));
+    EXPECT_THROW(ArchiveReader(outputDir / "notarchive.tar"), std::runtime_error);
+}
+
+TEST(Archive, CommandLine)
+{
+    setupTestDataPaths();
+    const auto outputDir = getOutputPath() / "archive_inputs";
+    std::filesystem::create_directories(outputDir);
+    const auto archivePath = outputDir / "bundle.zip";
+    writeFile(archivePath, makeZip(testEntries()));
+    const std::string archive = utils::pathToString(archivePath);
+
+    // like a directory, only the top level is searched without --recursive
+    {
+        ArgList args = { MNXVALIDATE_NAME, archive, "--verbose" };
+        checkStderr({ "Processing File: " + archive + "!/top.mnx", "Searched 7 entries" }, [&]() {
+            EXPECT_EQ(mnxValidateTestMain(args.argc(), args.argv()), 0);
+        });
+    }
+    // errors are reported with the archive's name and the entry's path
+    {
+        ArgList args = { MNXVALIDATE_NAME, archive, "--recursive" };
+        checkStderr({ "Processing File: " + archive + "!/scores/deflated.mnx", "Processing File: " + archive + "!/scores/compressed.mnx.gz",
+                      "bundle.zip!/scores/broken.mnx [***ERROR***]" }, [&]() {
+            EXPECT_NE(mnxValidateTestMain(args.argc(), args.argv()), 0);
+        });
+    }
+    {
+        ArgList args = { MNXVALIDATE_NAME, archive + "!/scores/*.{mnx,json}" };
+        checkStderr({ "Processing File: " + archive + "!/scores/stored.json", "Processing File: " + archive + "!/scores/compressed.mnx.gz" }, [&]() {
+            EXPECT_NE(mnxValidateTestMain(args.argc(), args.argv()), 0);
+        });
+    }
+    {
+        ArgList args = { MNXVALIDATE_NAME, archive + "!/scores/missing.mnx" };
+        checkStderr("does not exist in the archive", [&]() {
+            EXPECT_NE(mnxValidateTestMain(args.argc(), args.argv()), 0);
+        });
+    }
+}
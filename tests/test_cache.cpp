@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "mnxvalidate.h"
+#include "validationcache.h"
+#include "corpusgenerator.h"
+#include "test_utils.h"
+
+using namespace mnxvalidate;
+
+TEST(Cache, ReplaysCachedResults)
+{
+    setupTestDataPaths();
+    std::filesystem::path validPath;
+    copyInputToOutput("valid.mnx", validPath);
+    std::filesystem::path invalidPath;
+    copyInputToOutput("generic_nonascii_其れ.json", invalidPath);
+    auto cachePath = getOutputPath() / "cache";
+    ArgList args = { MNXVALIDATE_NAME, utils::pathToString(validPath), utils::pathToString(invalidPath),
+                     "--cache-dir", utils::pathToString(cachePath), "--verbose" };
+    checkStderr({ "Schema validation succeeded", "Schema validation failed", "0 hits, 2 misses", "!Using cached result" }, [&]() {
+        EXPECT_NE(mnxValidateTestMain(args.argc(), args.argv()), 0) << "validate " << utils::pathToString(invalidPath);
+    });
+    checkStderr({ "Schema validation succeeded", "Schema validation failed", "2 hits, 0 misses", "Using cached result" }, [&]() {
+        EXPECT_NE(mnxValidateTestMain(args.argc(), args.argv()), 0) << "cached failure should still fail";
+    });
+}
+
+TEST(Cache, ChangedFileIsRevalidated)
+{
+    setupTestDataPaths();
+    std::filesystem::path inputPath;
+    copyInputToOutput("valid.mnx", inputPath);
+    auto cachePath = getOutputPath() / "cache";
+    ArgList args = { MNXVALIDATE_NAME, utils::pathToString(inputPath), "--cache-dir", utils::pathToString(cachePath) };
+    checkStderr({ "Processing", "Schema validation succeeded", "0 hits, 1 misses" }, [&]() {
+        EXPECT_EQ(mnxValidateTestMain(args.argc(), args.argv()), 0) << "validate " << utils::pathToString(inputPath);
+    });
+    {
+        std::ofstream file(inputPath, std::ios::trunc);
+        file << "{ \"broken\": ";
+    }
+    checkStderr({ "Processing", "Parsing error", "0 hits, 1 misses" }, [&]() {
+        EXPECT_NE(mnxValidateTestMain(args.argc(), args.argv()), 0) << "changed file should be revalidated";
+    });
+    ArgList schemaOnlyArgs = { MNXVALIDATE_NAME, utils::pathToString(inputPath), "--cache-dir", utils::pathToString(cachePath), "--schema-only" };
+    checkStderr({ "Processing", "Parsing error", "0 hits, 1 misses" }, [&]() {
+        EXPECT_NE(mnxValidateTestMain(schemaOnlyArgs.argc(), schemaOnlyArgs.argv()), 0) << "--schema-only is part of the cache key";
+    });
+}
+
+TEST(Cache, SplitFallbackIsNotReplayed)
+{
+    setupTestDataPaths();
+    CorpusOptions options;
+    options.parts = 4;
+    options.measures = 16;
+    options.errors = { { InjectedError::MissingTieTarget, 1.0 } };
+    std::ostringstream score;
+    CorpusGenerator(options, 7).writeScore(score, 0);
+    const auto inputPath = getOutputPath() / "split_invalid.mnx";
+    writeFile(inputPath, score.str());
+    auto cachePath = getOutputPath() / "cache";
+    ArgList args = { MNXVALIDATE_NAME, utils::pathToString(inputPath), "--cache-dir", utils::pathToString(cachePath), "--verbose",
+                     "--semantic-jobs", "4", "--semantic-threshold", "1" };
+    checkStderr({ "Semantic validation errors", "checked again on one thread", "0 hits, 1 misses" }, [&]() {
+        EXPECT_NE(mnxValidateTestMain(args.argc(), args.argv()), 0) << "validate " << utils::pathToString(inputPath);
+    });
+    checkStderr({ "Semantic validation errors", "Using cached result", "!checked again on one thread", "1 hits, 0 misses" }, [&]() {
+        EXPECT_NE(mnxValidateTestMain(args.argc(), args.argv()), 0) << "a cached result should not replay how it was found";
+    });
+}
+
+TEST(Cache, EmptyInputKey)
+{
+    setupTestDataPaths();
+    const ValidationCache cache(getOutputPath() / "cache", "configuration", 0);
+    const std::string key = cache.keyFor(std::string_view());
+    EXPECT_EQ(key.size(), 32u);
+    EXPECT_EQ(cache.keyFor(""), key) << "an empty view without storage should hash like an empty string";
+    EXPECT_NE(cache.keyFor(" "), key);
+}
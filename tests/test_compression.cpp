@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+
+#include "gtest/gtest.h"
+#include "mnxvalidate.h"
+#include "compression.h"
+#include "filewatcher.h"
+#include "corpusgenerator.h"
+#include "test_utils.h"
+
+using namespace mnxvalidate;
+
+static std::string decompressAll(std::string_view compressed)
+{
+    Decompressor decompressor(compressed, detectCompression(compressed));
+    std::string result;
+    for (auto chunk = decompressor.next(); !chunk.empty(); chunk = decompressor.next()) {
+        EXPECT_LE(chunk.size(), Decompressor::kChunkSize);
+        result += chunk;
+    }
+    EXPECT_EQ(decompressor.decompressedSize(), result.size());
+    return result;
+}
+
+TEST(Compression, Detection)
+{
+    EXPECT_EQ(detectCompression(compress("{}", Compression::Gzip)), Compression::Gzip);
+    EXPECT_EQ(detectCompression("{}"), Compression::None);
+    EXPECT_EQ(detectCompression(""), Compression::None);
+    EXPECT_EQ(detectCompression("\x28\xb5\x2f\xfd"), Compression::Zstd);
+    EXPECT_EQ(compressionForPath("a/score.mnx.gz"), Compression::Gzip);
+    EXPECT_EQ(compressionForPath("a/score.MNX.ZST"), Compression::Zstd);
+    EXPECT_EQ(compressionForPath("a/score.mnx"), Compression::None);
+    EXPECT_EQ(compressionForPath("a/gz"), Compression::None);
+}
+
+TEST(Compression, RoundTrip)
+{
+    // several chunks of output, so that chunk boundaries fall inside json tokens
+    CorpusOptions options;
+    options.measures = 512;
+    std::ostringstream score;
+    CorpusGenerator(options, 1).writeScore(score, 0);
+    const std::string text = score.str();
+    ASSERT_GT(text.size(), 4 * Decompressor::kChunkSize);
+
+    for (Compression compression : { Compression::Gzip, Compression::Zstd }) {
+        if (!isCompressionSupported(compression)) {
+            EXPECT_THROW(Decompressor("", compression), DecompressionError);
+            continue;
+        }
+        const std::string compressed = compress(text, compression);
+        EXPECT_EQ(detectCompression(compressed), compression);
+        EXPECT_LT(compressed.size(), text.size());
+        EXPECT_EQ(decompressAll(compressed), text);
+        EXPECT_EQ(decompressAll(compressed + compressed), text + text) << "concatenated members or frames are one stream";
+
+        const Validator validator;
+        EXPECT_TRUE(validator.validate(compressed).valid());
+        const auto truncated = validator.validate(std::string_view(compressed).substr(0, compressed.size() / 2));
+        EXPECT_EQ(truncated.phase, ValidationPhase::Read);
+        EXPECT_EQ(truncated.diagnostics.size(), 1u);
+        std::string corrupt = compressed;
+        corrupt[corrupt.size() / 2] = static_cast<char>(~corrupt[corrupt.size() / 2]);
+        corrupt[corrupt.size() / 2 + 1] = static_cast<char>(~corrupt[corrupt.size() / 2 + 1]);
+        EXPECT_FALSE(validator.validate(corrupt).valid());
+    }
+}
+
+TEST(Compression, ValidatesCompressedFiles)
+{
+    setupTestDataPaths();
+    const auto outputDir = getOutputPath() / "compressed";
+    std::filesystem::create_directories(outputDir);
+    const std::string valid = utils::fileToString(getInputPath() / "valid.mnx");
+    const auto gzipPath = outputDir / "valid.mnx.gz";
+    writeFile(gzipPath, compress(valid, Compression::Gzip));
+    EXPECT_EQ(decompressedSizeHint(gzipPath), valid.size());
+
+    const Validator validator;
+    const auto result = validator.validateFile(gzipPath);
+    EXPECT_TRUE(result.valid());
+    EXPECT_EQ(result.phase, ValidationPhase::Semantic);
+    EXPECT_EQ(result.timings.bytesRead, std::filesystem::file_size(gzipPath)) << "the bytes read are the compressed bytes";
+
+    // the streaming schema validator reads compressed text too
+    ArgList args = { MNXVALIDATE_NAME, utils::pathToString(gzipPath), "--schema", utils::pathToString(getInputPath() / "generic_schema.json"), "--schema-only" };
+    checkStderr({ "Processing", "Validation errors:", "required property 'name'", "Schema validation failed" }, [&]() {
+        EXPECT_NE(mnxValidateTestMain(args.argc(), args.argv()), 0) << "validate " << utils::pathToString(gzipPath);
+    });
+}
+
+TEST(Compression, DirectoryAndWildcardInputs)
+{
+    setupTestDataPaths();
+    const auto outputDir = getOutputPath() / "compressed_inputs";
+    std::filesystem::create_directories(outputDir);
+    const std::string valid = utils::fileToString(getInputPath() / "valid.mnx");
+    std::vector<std::filesystem::path> inputs = { outputDir / "plain.mnx", outputDir / "gzip.mnx.gz" };
+    writeFile(inputs[0], valid);
+    writeFile(inputs[1], compress(valid, Compression::Gzip));
+    if (isCompressionSupported(Compression::Zstd)) {
+        inputs.push_back(outputDir / "zstd.json.zst");
+        writeFile(inputs.back(), compress(valid, Compression::Zstd));
+    }
+    writeFile(outputDir / "notes.txt.gz", compress("not an input", Compression::Gzip));
+
+    const InputTarget target{ outputDir, GlobPattern(std::filesystem::path("*.mnx").native()), {} };
+    EXPECT_TRUE(target.wantsFile(outputDir / "plain.mnx"));
+    EXPECT_TRUE(target.wantsFile(outputDir / "gzip.mnx.gz")) << "a pattern for the uncompressed name matches the compressed file";
+    EXPECT_FALSE(target.wantsFile(outputDir / "zstd.json.zst"));
+    EXPECT_FALSE(target.wantsFile(outputDir / "notes.txt.gz"));
+    EXPECT_FALSE(target.wantsFile(outputDir / "archive.gz"));
+    const InputTarget gzipTarget{ outputDir, GlobPattern(std::filesystem::path("*.gz").native()), {} };
+    EXPECT_TRUE(gzipTarget.wantsFile(outputDir / "gzip.mnx.gz"));
+    EXPECT_FALSE(gzipTarget.wantsFile(outputDir / "notes.txt.gz"));
+
+    ArgList args = { MNXVALIDATE_NAME, utils::pathToString(outputDir), "--verbose" };
+    std::vector<std::string> messages;
+    for (const auto& input : inputs) {
+        messages.push_back("Processing File: " + utils::pathToString(input));
+    }
+    checkStderr(messages, [&]() {
+        EXPECT_EQ(mnxValidateTestMain(args.argc(), args.argv()), 0);
+    });
+}
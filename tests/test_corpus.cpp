@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <filesystem>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "mnxvalidate.h"
+#include "corpusgenerator.h"
+#include "test_utils.h"
+
+using namespace mnxvalidate;
+
+static std::string generate(const CorpusOptions& options, std::uint64_t seed, std::uint64_t index = 0)
+{
+    std::ostringstream output;
+    CorpusGenerator(options, seed).writeScore(output, index);
+    return output.str();
+}
+
+static std::filesystem::path writeScore(const std::string& score, const std::string& fileName)
+{
+    setupTestDataPaths();
+    const auto path = getOutputPath() / fileName;
+    writeFile(path, score);
+    return path;
+}
+
+TEST(Corpus, Deterministic)
+{
+    CorpusOptions options;
+    options.parts = 3;
+    options.measures = 24;
+    options.voices = 2;
+    options.layouts = 2;
+    const std::string score = generate(options, 42);
+    EXPECT_EQ(generate(options, 42), score) << "same seed should produce the same score";
+    EXPECT_NE(generate(options, 43), score) << "different seeds should produce different scores";
+    EXPECT_NE(generate(options, 42, 1), score) << "each score in a corpus should differ";
+    EXPECT_NO_THROW(EXPECT_TRUE(json::parse(score).contains("mnx")));
+
+    options.errors = { { InjectedError::MissingSlurTarget, 0.5 } };
+    EXPECT_NE(generate(options, 42), score);
+    options.errors = { { InjectedError::MissingSlurTarget, 0.0 } };
+    EXPECT_EQ(generate(options, 42), score) << "deciding which errors to inject should not change the music";
+}
+
+TEST(Corpus, GeneratedScoreIsValid)
+{
+    CorpusOptions options;
+    options.parts = 4;
+    options.measures = 64;
+    options.voices = 2;
+    options.tupletRate = 0.3;
+    options.tieRate = 0.5;
+    options.slurRate = 0.5;
+    const auto path = writeScore(generate(options, 7), "generated_valid.mnx");
+    ArgList args = { MNXVALIDATE_NAME, utils::pathToString(path) };
+    checkStderr({ "Processing", "Schema validation succeeded", "Semantic validation complete" }, [&]() {
+        EXPECT_EQ(mnxValidateTestMain(args.argc(), args.argv()), 0) << "generated score should be valid";
+    });
+}
+
+TEST(Corpus, InjectedErrorIsDetected)
+{
+    CorpusOptions options;
+    options.errors = { { InjectedError::MissingTieTarget, 1.0 } };
+    std::ostringstream output;
+    const auto injected = CorpusGenerator(options, 7).writeScore(output, 0);
+    ASSERT_EQ(injected.size(), 1u);
+    EXPECT_EQ(injected.begin()->first, InjectedError::MissingTieTarget);
+    EXPECT_EQ(injected.begin()->second, options.parts * options.measures);
+    const auto path = writeScore(output.str(), "generated_invalid.mnx");
+    ArgList args = { MNXVALIDATE_NAME, utils::pathToString(path) };
+    checkStderr({ "Processing", "Schema validation succeeded", "Semantic validation errors" }, [&]() {
+        EXPECT_NE(mnxValidateTestMain(args.argc(), args.argv()), 0) << "injected error should be detected";
+    });
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <fstream>
+#include <filesystem>
+
+#include "gtest/gtest.h"
+#include "mnxvalidate.h"
+#include "diagnosticlist.h"
+#include "test_utils.h"
+
+using namespace mnxvalidate;
+
+TEST(Diagnostics, FormatsWhatWasAdded)
+{
+    DiagnosticList diagnostics;
+    const std::string messages[] = {
+        "Event \"ev1\" in measure 12 has no note",
+        "doesn't match 'x' at 1.5, utf-8",
+        "[json.exception.parse_error.101] parse error at line 1, column 13: last read: '\"a\"} x'",
+        "a \x1f placeholder character"
+    };
+    for (const auto& message : messages) {
+        diagnostics.add(ValidationPhase::Semantic, "/global", message);
+    }
+    ASSERT_EQ(diagnostics.size(), std::size(messages));
+    size_t x = 0;
+    for (const auto& diagnostic : diagnostics) {
+        EXPECT_EQ(diagnostic.message, messages[x++]);
+        EXPECT_EQ(diagnostic.pointer, "/global");
+        EXPECT_EQ(diagnostic.phase, ValidationPhase::Semantic);
+    }
+    EXPECT_EQ(diagnostics.kind(0), "Event \"...\" in measure ... has no note");
+}
+
+TEST(Diagnostics, GroupsByKind)
+{
+    DiagnosticList diagnostics;
+    for (int x = 0; x < 5; x++) {
+        diagnostics.add(ValidationPhase::Semantic, {}, "Event \"ev" + std::to_string(x) + "\" has no note");
+        diagnostics.add(ValidationPhase::Schema, "/tags/" + std::to_string(x), "unexpected instance type");
+    }
+    diagnostics.add(ValidationPhase::Schema, "/name", "required property 'name' not found in object");
+
+    const auto groups = diagnostics.groups(3);
+    ASSERT_EQ(groups.size(), 3u);
+    EXPECT_EQ(groups[0].count, 5u);
+    ASSERT_EQ(groups[0].examples.size(), 3u);
+    EXPECT_EQ(diagnostics.location(groups[0].examples[2]), "ev2");
+    EXPECT_EQ(groups[1].count, 5u);
+    EXPECT_EQ(diagnostics.location(groups[1].examples[0]), "/tags/0");
+    EXPECT_EQ(groups[2].count, 1u);
+
+    DiagnosticSummary summary;
+    summary.add(diagnostics);
+    summary.add(diagnostics);
+    summary.add(DiagnosticList());
+    EXPECT_EQ(summary.errorCount(), 22u);
+    EXPECT_EQ(summary.inputCount(), 2u);
+    const auto top = summary.top(2);
+    ASSERT_EQ(top.size(), 2u);
+    EXPECT_EQ(top[0].kind, "Event \"...\" has no note") << "ties keep the order kinds were first seen in";
+    EXPECT_EQ(top[0].count, 10u);
+    EXPECT_EQ(top[0].inputCount, 2u);
+    EXPECT_EQ(top[1].phase, ValidationPhase::Schema);
+}
+
+TEST(Diagnostics, RepeatedErrorsAreCollapsed)
+{
+    setupTestDataPaths();
+    const auto root = getOutputPath() / "diagnostics";
+    std::filesystem::create_directories(root);
+    const auto inputPath = root / "tags.json";
+    std::ofstream(inputPath) << R"({"name": "a", "email": "b", "tags": [1, 2, 3, 4, 5, "x"], "extra": 1})";
+    ArgList args = { MNXVALIDATE_NAME, utils::pathToString(inputPath), "--schema", utils::pathToString(getInputPath() / "generic_schema.json"),
+        "--schema-only", "--error-summary" };
+    checkStderr({ "unexpected instance type (5 times, at /tags/0; /tags/1; /tags/2; ...)", "/extra: ",
+        "Most frequent errors: 6 errors in 1 files" }, [&]() {
+        EXPECT_NE(mnxValidateTestMain(args.argc(), args.argv()), 0);
+    });
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <vector>
+#include <sstream>
+#include <random>
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "mnxvalidate.h"
+#include "generatedschema.h"
+#include "corpusgenerator.h"
+#include "test_utils.h"
+
+using namespace mnxvalidate;
+
+namespace {
+
+// Mutates documents in ways that tend to break a schema: values of the wrong type, missing and extra members,
+// and values moved from elsewhere in the document.
+class Mutator
+{
+public:
+    explicit Mutator(std::uint64_t seed) : m_random(seed) {}
+
+    void mutate(nlohmann::json& document)
+    {
+        std::vector<nlohmann::json*> values;
+        collect(document, values);
+        nlohmann::json& target = *values[pick(values.size())];
+        const nlohmann::json donor = *values[pick(values.size())];
+        switch (pick(6)) {
+        case 0:
+            target = randomValue();
+            break;
+        case 1:
+            if (target.is_object() && !target.empty()) {
+                target.erase(std::next(target.begin(), pick(target.size())));
+            } else if (target.is_array() && !target.empty()) {
+                target.erase(pick(target.size()));
+            } else {
+                target = nullptr;
+            }
+            break;
+        case 2:
+            if (target.is_object()) {
+                target[pick(2) || target.empty() ? "unexpected" : target.begin().key() + "x"] = donor;
+            } else if (target.is_array()) {
+                target.push_back(target.empty() ? donor : target[pick(target.size())]);
+            } else {
+                target = donor;
+            }
+            break;
+        case 3:
+            target = donor;
+            break;
+        case 4:
+            if (target.is_number()) {
+                const double number = target.get<double>();
+                const double choices[] = { -number, number + 0.5, number * 1000, 0, -1 };
+                target = choices[pick(std::size(choices))];
+                if (pick(2)) {
+                    target = static_cast<std::int64_t>(target.get<double>());
+                }
+            } else if (target.is_string()) {
+                const std::string text = target.get<std::string>();
+                const std::string choices[] = { "", text + "x", "x" + text, "-", "\xC3\xA9" };
+                target = choices[pick(std::size(choices))];
+            } else {
+                target = randomValue();
+            }
+            break;
+        default:
+            // an existing value under a name taken from the document
+            if (donor.is_string() && target.is_object() && !target.empty()) {
+                target[donor.get<std::string>()] = *std::next(target.begin(), pick(target.size()));
+            } else {
+                target = donor;
+            }
+            break;
+        }
+    }
+
+private:
+    size_t pick(size_t count) { return std::uniform_int_distribution<size_t>(0, count - 1)(m_random); }
+
+    static void collect(nlohmann::json& value, std::vector<nlohmann::json*>& values)
+    {
+        values.push_back(&value);
+        if (value.is_structured()) {
+            for (auto& member : value) {
+                collect(member, values);
+            }
+        }
+    }
+
+    nlohmann::json randomValue()
+    {
+        switch (pick(8)) {
+        case 0: return nullptr;
+        case 1: return pick(2) == 1;
+        case 2: return static_cast<std::int64_t>(pick(2000)) - 1000;
+        case 3: return static_cast<double>(pick(1000)) / 8.0;
+        case 4: return std::string(pick(4), 'a');
+        case 5: return nlohmann::json::array();
+        case 6: return nlohmann::json::object();
+        default: return nlohmann::json::array({ 1, "x" });
+        }
+    }
+
+    std::mt19937_64 m_random;
+};
+
+bool isValid(const SchemaValidator& validator, const nlohmann::json& document)
+{
+    return bool(validator.validate(mnx::Document(std::make_shared<mnx::json>(mnx::json::parse(document.dump())))));
+}
+
+} // namespace
+
+TEST(GeneratedSchema, UsedForEmbeddedSchema)
+{
+    setupTestDataPaths();
+    if (!generated::isAvailable()) {
+        GTEST_SKIP() << "no validator was generated: " << generated::unavailableReason();
+    }
+    const SchemaValidator embedded;
+    EXPECT_TRUE(embedded.usesGeneratedCode());
+    EXPECT_FALSE(SchemaValidator(embedded.schemaText()).usesGeneratedCode()) << "supplying the text selects the generic validator";
+    EXPECT_FALSE(SchemaValidator(utils::fileToString(getInputPath() / "generic_schema.json")).usesGeneratedCode());
+
+    const auto valid = nlohmann::json::parse(utils::fileToString(getInputPath() / "valid.mnx"));
+    EXPECT_TRUE(generated::validate(valid));
+    const auto invalid = generated::validate(nlohmann::json{ { "mnx", 3 }, { "unexpected", true } }, 1);
+    EXPECT_EQ(invalid.errors.size(), 1u);
+    EXPECT_TRUE(invalid.truncated);
+}
+
+// The generated validator must reach the same verdict as the generic one on every document. The streaming validator
+// is checked as well, when it can handle the schema.
+TEST(GeneratedSchema, MatchesGenericOnFuzzedCorpus)
+{
+    setupTestDataPaths();
+    if (!generated::isAvailable()) {
+        GTEST_SKIP() << "no validator was generated: " << generated::unavailableReason();
+    }
+    const SchemaValidator generatedValidator;
+    const SchemaValidator genericValidator(generatedValidator.schemaText());
+
+    std::vector<nlohmann::json> bases = { nlohmann::json::parse(utils::fileToString(getInputPath() / "valid.mnx")) };
+    CorpusOptions options;
+    options.measures = 4;
+    options.voices = 2;
+    options.tupletRate = 0.5;
+    for (std::uint64_t seed = 1; seed <= 3; seed++) {
+        std::ostringstream score;
+        CorpusGenerator(options, seed).writeScore(score, 0);
+        bases.push_back(nlohmann::json::parse(score.str()));
+    }
+
+    size_t invalidCount = 0;
+    for (size_t x = 0; x < bases.size(); x++) {
+        ASSERT_TRUE(isValid(generatedValidator, bases[x])) << "base document " << x;
+        Mutator mutator(x + 1);
+        for (size_t iteration = 0; iteration < 250; iteration++) {
+            auto document = bases[x];
+            for (size_t mutation = 0; mutation <= iteration % 3; mutation++) {
+                mutator.mutate(document);
+            }
+            const bool valid = isValid(generatedValidator, document);
+            ASSERT_EQ(valid, isValid(genericValidator, document)) << document.dump();
+            if (generatedValidator.canStream()) {
+                ASSERT_EQ(valid, bool(generatedValidator.validateText(document.dump()))) << document.dump();
+            }
+            invalidCount += !valid;
+        }
+    }
+    EXPECT_GT(invalidCount, bases.size() * 100) << "most mutations should break the schema";
+}
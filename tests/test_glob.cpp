@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <filesystem>
+
+#include "gtest/gtest.h"
+#include "mnxvalidate.h"
+#include "globpattern.h"
+#include "test_utils.h"
+
+using namespace mnxvalidate;
+
+static bool matches(const std::string& pattern, const std::string& path, bool anyDepth = false)
+{
+    return GlobPattern(std::filesystem::path(pattern).native(), anyDepth).matches(std::filesystem::path(path).native());
+}
+
+static bool mayMatchBelow(const std::string& pattern, const std::string& directory)
+{
+    return GlobPattern(std::filesystem::path(pattern).native()).mayMatchBelow(std::filesystem::path(directory).native());
+}
+
+TEST(Glob, Wildcards)
+{
+    EXPECT_TRUE(matches("*.mnx", "score.mnx"));
+    EXPECT_TRUE(matches("*.mnx", ".mnx"));
+    EXPECT_FALSE(matches("*.mnx", "score.json"));
+    EXPECT_FALSE(matches("*.mnx", "scoremnx")) << "a dot is literal, unlike the old regex conversion";
+    EXPECT_TRUE(matches("s?ore*.*", "score1.mnx"));
+    EXPECT_FALSE(matches("s?ore", "sore"));
+    EXPECT_TRUE(matches("*a*b*c", "xxaxxbxxbxxc"));
+    EXPECT_FALSE(matches("*a*b*c", "xxaxxbxxbxxcx"));
+    EXPECT_TRUE(matches("a+(b).mnx", "a+(b).mnx")) << "regex metacharacters are literal";
+    EXPECT_FALSE(matches("*.mnx", "dir/score.mnx")) << "* does not cross directories";
+}
+
+TEST(Glob, CharacterClasses)
+{
+    EXPECT_TRUE(matches("score[0-9].mnx", "score7.mnx"));
+    EXPECT_FALSE(matches("score[0-9].mnx", "scorex.mnx"));
+    EXPECT_TRUE(matches("score[!0-9].mnx", "scorex.mnx"));
+    EXPECT_TRUE(matches("score[^0-9].mnx", "scorex.mnx"));
+    EXPECT_TRUE(matches("[]a]", "]"));
+    EXPECT_TRUE(matches("[a-]", "-"));
+    EXPECT_TRUE(matches("score[.mnx", "score[.mnx")) << "an unclosed [ is literal";
+}
+
+TEST(Glob, Braces)
+{
+    EXPECT_TRUE(matches("score.{mnx,json}", "score.json"));
+    EXPECT_FALSE(matches("score.{mnx,json}", "score.txt"));
+    EXPECT_TRUE(matches("{a,b{1,2}}.mnx", "b2.mnx"));
+    EXPECT_TRUE(matches("{a/b,c}/*.mnx", "a/b/x.mnx"));
+    EXPECT_TRUE(matches("{a/b,c}/*.mnx", "c/x.mnx"));
+    EXPECT_TRUE(matches("x{,1}.mnx", "x.mnx"));
+    EXPECT_TRUE(matches("{a}.mnx", "{a}.mnx")) << "braces without a comma are literal";
+    EXPECT_TRUE(matches("[{]a,b}", "{a,b}")) << "a brace in a set is not a group";
+    EXPECT_THROW(GlobPattern(std::filesystem::path("{a,b}{a,b}{a,b}{a,b}{a,b}{a,b}{a,b}{a,b}{a,b}{a,b}{a,b}").native()), std::invalid_argument);
+}
+
+TEST(Glob, Globstar)
+{
+    EXPECT_TRUE(matches("**/*.mnx", "score.mnx"));
+    EXPECT_TRUE(matches("**/*.mnx", "a/b/c/score.mnx"));
+    EXPECT_TRUE(matches("a/**/c/*.mnx", "a/c/score.mnx"));
+    EXPECT_TRUE(matches("a/**/c/*.mnx", "a/x/y/c/score.mnx"));
+    EXPECT_FALSE(matches("a/**/c/*.mnx", "b/c/score.mnx"));
+    EXPECT_TRUE(matches("a/**", "a/b/score.mnx"));
+    EXPECT_TRUE(matches("*.mnx", "a/b/score.mnx", true)) << "anyDepth behaves like a leading **/";
+    EXPECT_TRUE(matches("a/*.mnx", "a/b/score.mnx", true));
+    EXPECT_FALSE(matches("a/*.mnx", "b/score.mnx", true));
+    EXPECT_FALSE(GlobPattern(std::filesystem::path("*.mnx").native()).spansDirectories());
+    EXPECT_TRUE(GlobPattern(std::filesystem::path("*/*.mnx").native()).spansDirectories());
+}
+
+TEST(Glob, Pruning)
+{
+    EXPECT_TRUE(mayMatchBelow("a/*/c/*.mnx", "a"));
+    EXPECT_TRUE(mayMatchBelow("a/*/c/*.mnx", "a/b"));
+    EXPECT_TRUE(mayMatchBelow("a/*/c/*.mnx", "a/b/c"));
+    EXPECT_FALSE(mayMatchBelow("a/*/c/*.mnx", "a/b/d"));
+    EXPECT_FALSE(mayMatchBelow("a/*/c/*.mnx", "a/b/c/d"));
+    EXPECT_FALSE(mayMatchBelow("a/*/c/*.mnx", "b"));
+    EXPECT_TRUE(mayMatchBelow("a/**/*.mnx", "a/x/y/z"));
+    EXPECT_FALSE(mayMatchBelow("*.mnx", "a"));
+}
+
+TEST(Glob, SplitBase)
+{
+    const auto [base, pattern] = GlobPattern::splitBase(std::filesystem::path("scores") / "v{1,2}" / "*.mnx");
+    EXPECT_EQ(base, std::filesystem::path("scores"));
+    EXPECT_EQ(std::filesystem::path(pattern), std::filesystem::path("v{1,2}") / "*.mnx");
+    EXPECT_TRUE(GlobPattern::splitBase(std::filesystem::path("scores") / "a.mnx").second.empty());
+}
+
+// Builds outputs/globtree with two mnx files in each of a, a/b, a/b/c, d and d/e
+static std::filesystem::path makeTree()
+{
+    setupTestDataPaths();
+    const auto root = getOutputPath() / "globtree";
+    for (const char* dir : { "a", "a/b", "a/b/c", "d", "d/e" }) {
+        std::filesystem::create_directories(root / dir);
+        for (const char* name : { "score1.mnx", "score2.mnx" }) {
+            std::filesystem::copy_file(getInputPath() / "valid.mnx", root / dir / name);
+        }
+    }
+    return root;
+}
+
+TEST(Glob, DirectoryPatterns)
+{
+    const auto root = makeTree();
+    ArgList globstarArgs = { MNXVALIDATE_NAME, utils::pathToString(root / "a" / "**" / "score1.mnx"), "--verbose" };
+    checkStderr({ "Searched 3 directories",
+        utils::pathToString(root / "a" / "score1.mnx"),
+        utils::pathToString(root / "a" / "b" / "c" / "score1.mnx") }, [&]() {
+        EXPECT_EQ(mnxValidateTestMain(globstarArgs.argc(), globstarArgs.argv()), 0);
+    });
+    ArgList braceArgs = { MNXVALIDATE_NAME, utils::pathToString(root / "{a,d}" / "score[2-9].mnx"), "--verbose" };
+    checkStderr({ "Searched 3 directories", // a/b and d/e cannot match, so they are not read
+        utils::pathToString(root / "a" / "score2.mnx"),
+        utils::pathToString(root / "d" / "score2.mnx") }, [&]() {
+        EXPECT_EQ(mnxValidateTestMain(braceArgs.argc(), braceArgs.argv()), 0);
+    });
+}
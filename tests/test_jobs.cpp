@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <filesystem>
+#include <iterator>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "mnxvalidate.h"
+#include "test_utils.h"
+
+using namespace mnxvalidate;
+
+TEST(Jobs, OutputMatchesSerialOrder)
+{
+    setupTestDataPaths();
+    std::filesystem::path validPath;
+    copyInputToOutput("valid.mnx", validPath);
+    std::filesystem::path invalidPath;
+    copyInputToOutput("generic_nonascii_其れ.json", invalidPath);
+    for (int x = 0; x < 8; x++) {
+        std::filesystem::copy(validPath, getOutputPath() / ("valid" + std::to_string(x) + ".mnx"));
+        std::filesystem::copy(invalidPath, getOutputPath() / ("invalid" + std::to_string(x) + ".json"));
+    }
+    ArgList serialArgs = { MNXVALIDATE_NAME, utils::pathToString(getOutputPath()), "--jobs", "1" };
+    int serialResult = 0;
+    const std::string serialOutput = captureStderr(serialArgs, serialResult);
+    ArgList parallelArgs = { MNXVALIDATE_NAME, utils::pathToString(getOutputPath()), "--jobs", "4" };
+    int parallelResult = 0;
+    const std::string parallelOutput = captureStderr(parallelArgs, parallelResult);
+
+    EXPECT_NE(serialResult, 0);
+    EXPECT_EQ(parallelResult, serialResult);
+    EXPECT_NE(serialOutput.find("Schema validation failed"), std::string::npos);
+    EXPECT_EQ(parallelOutput, serialOutput) << "parallel output should be identical to serial output";
+}
+
+TEST(Jobs, InvalidJobCount)
+{
+    setupTestDataPaths();
+    std::filesystem::path inputPath = getInputPath() / "valid.mnx";
+    for (const char* value : { "0", "two", "3x" }) {
+        ArgList args = { MNXVALIDATE_NAME, utils::pathToString(inputPath), "--jobs", value };
+        checkStderr(std::string("Invalid value for --jobs: ") + value, [&]() {
+            EXPECT_NE(mnxValidateTestMain(args.argc(), args.argv()), 0) << "invalid job count should fail";
+        });
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <vector>
+#include <atomic>
+#include <filesystem>
+
+#include "gtest/gtest.h"
+#include "validator.h"
+#include "test_utils.h"
+
+using namespace mnxvalidate;
+
+TEST(Library, ValidatesEmbeddedSchemaAndSemantics)
+{
+    setupTestDataPaths();
+    const Validator validator;
+    const auto result = validator.validateFile(getInputPath() / "valid.mnx");
+    EXPECT_TRUE(result.valid());
+    EXPECT_EQ(result.phase, ValidationPhase::Semantic);
+    ASSERT_TRUE(result.stats.has_value());
+    EXPECT_GT(result.stats->measures, 0u);
+    EXPECT_GT(result.stats->parts, 0u);
+    EXPECT_TRUE(result.timings.phases[static_cast<size_t>(ValidationPhase::Read)].has_value());
+}
+
+TEST(Library, ReportsEachPhase)
+{
+    setupTestDataPaths();
+    ValidatorOptions options;
+    options.schemaOnly = true;
+    const Validator validator(utils::fileToString(getInputPath() / "generic_schema.json"), options);
+
+    const auto valid = validator.validate(R"({"name": "a", "email": "a@b.c"})");
+    EXPECT_TRUE(valid.valid());
+    EXPECT_EQ(valid.phase, ValidationPhase::Schema);
+    EXPECT_FALSE(valid.stats.has_value()) << "schema-only validation has no document to count";
+
+    const auto invalid = validator.validate(R"({"name": "a", "email": 3})");
+    EXPECT_FALSE(invalid.valid());
+    EXPECT_EQ(invalid.phase, ValidationPhase::Schema);
+    ASSERT_EQ(invalid.diagnostics.size(), 1u);
+    EXPECT_EQ(invalid.diagnostics[0].pointer, "/email");
+
+    const auto unparsable = validator.validate(R"({"name": )");
+    EXPECT_EQ(unparsable.phase, ValidationPhase::Parse);
+    EXPECT_EQ(unparsable.diagnostics.size(), 1u);
+
+    const auto missing = validator.validateFile(getInputPath() / "does_not_exist.mnx");
+    EXPECT_EQ(missing.phase, ValidationPhase::Read);
+    EXPECT_EQ(missing.diagnostics.size(), 1u);
+}
+
+TEST(Library, BatchKeepsInputOrder)
+{
+    setupTestDataPaths();
+    ValidatorOptions options;
+    options.jobs = 4;
+    const Validator validator(std::nullopt, options);
+    std::vector<ValidationInput> inputs;
+    for (int x = 0; x < 12; x++) {
+        if (x % 3 == 0) {
+            inputs.push_back({ "broken-" + std::to_string(x), std::string("{") });
+        } else {
+            inputs.push_back({ getInputPath() / "valid.mnx", std::nullopt });
+        }
+    }
+    const auto results = validator.validateBatch(inputs);
+    ASSERT_EQ(results.size(), inputs.size());
+    for (size_t x = 0; x < results.size(); x++) {
+        EXPECT_EQ(results[x].name, utils::pathToString(inputs[x].path));
+        EXPECT_EQ(results[x].valid(), x % 3 != 0) << results[x].name;
+    }
+    EXPECT_TRUE(validator.validateBatch({}).empty());
+}
+
+TEST(Library, Cancel)
+{
+    setupTestDataPaths();
+    const Validator validator;
+    const std::atomic<bool> cancel{ true };
+    const auto result = validator.validate(utils::fileToString(getInputPath() / "valid.mnx"), &cancel);
+    EXPECT_TRUE(result.cancelled);
+    EXPECT_FALSE(result.valid());
+}
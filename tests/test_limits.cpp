@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <iostream>
+#include <string>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "mnxvalidate.h"
+#include "corpusgenerator.h"
+#include "test_utils.h"
+
+using namespace mnxvalidate;
+
+static std::vector<json> readReport(const std::filesystem::path& reportPath)
+{
+    std::ifstream report(reportPath);
+    std::vector<json> records;
+    for (std::string line; std::getline(report, line);) {
+        records.push_back(json::parse(line));
+    }
+    return records;
+}
+
+TEST(Limits, MaxErrorsStopsSchemaValidation)
+{
+    setupTestDataPaths();
+    std::filesystem::path invalidPath;
+    copyInputToOutput("generic_nonascii_其れ.json", invalidPath);
+    const auto reportPath = getOutputPath() / "max_errors.jsonl";
+    ArgList args = { MNXVALIDATE_NAME, utils::pathToString(invalidPath), "--max-errors", "1", "--report", utils::pathToString(reportPath) };
+    checkStderr({ "Validation errors", "Stopped at the --max-errors limit of 1.", "cut short at the --max-errors limit of 1 in 1 file(s)" }, [&]() {
+        EXPECT_EQ(mnxValidateTestMain(args.argc(), args.argv()), EXIT_CODE_TRUNCATED);
+    });
+    const auto records = readReport(reportPath);
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_EQ(records[0]["errors"].size(), 1u);
+}
+
+TEST(Limits, MaxErrorsLimitsSemanticErrors)
+{
+    setupTestDataPaths();
+    CorpusOptions options;
+    options.errors = { { InjectedError::MissingTieTarget, 1.0 } };
+    const auto path = getOutputPath() / "many_semantic_errors.mnx";
+    {
+        std::ofstream file(path, std::ios::binary);
+        CorpusGenerator(options, 7).writeScore(file, 0);
+    }
+    const auto reportPath = getOutputPath() / "max_semantic_errors.jsonl";
+    ArgList args = { MNXVALIDATE_NAME, utils::pathToString(path), "--max-errors", "3", "--report", utils::pathToString(reportPath) };
+    checkStderr({ "Semantic validation errors", "Stopped at the --max-errors limit of 3.", "more were not shown" }, [&]() {
+        EXPECT_EQ(mnxValidateTestMain(args.argc(), args.argv()), EXIT_CODE_TRUNCATED);
+    });
+    const auto records = readReport(reportPath);
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_EQ(records[0]["errors"].size(), 3u);
+}
+
+TEST(Limits, FailFastStopsAtFirstFailure)
+{
+    setupTestDataPaths();
+    std::filesystem::path validPath;
+    copyInputToOutput("valid.mnx", validPath);
+    std::filesystem::path invalidPath;
+    copyInputToOutput("generic_nonascii_其れ.json", invalidPath);
+    std::vector<std::filesystem::path> laterPaths;
+    for (int x = 0; x < 8; x++) {
+        laterPaths.push_back(getOutputPath() / ("later" + std::to_string(x) + ".mnx"));
+        std::filesystem::copy(validPath, laterPaths.back());
+    }
+    for (const char* jobs : { "1", "4" }) {
+        ArgList args = { MNXVALIDATE_NAME, utils::pathToString(validPath), utils::pathToString(invalidPath) };
+        for (const auto& path : laterPaths) {
+            args.add(utils::pathToString(path));
+        }
+        args.add(std::vector<arg_string>{ "--fail-fast", "--jobs", jobs });
+        int result = 0;
+        const std::string output = captureStderr(args, result);
+        EXPECT_EQ(result, EXIT_CODE_TRUNCATED) << "--jobs " << jobs;
+        EXPECT_NE(output.find("Schema validation failed"), std::string::npos);
+        EXPECT_NE(output.find("Validation stopped at the first failing file (--fail-fast)"), std::string::npos);
+        EXPECT_EQ(output.find("later"), std::string::npos) << "files after the failure should not be logged with --jobs " << jobs;
+    }
+}
+
+TEST(Limits, ExitCodeWithoutLimits)
+{
+    setupTestDataPaths();
+    ArgList args = { MNXVALIDATE_NAME, utils::pathToString(getInputPath() / utils::utf8ToPath("generic_nonascii_其れ.json")) };
+    checkStderr("Schema validation failed", [&]() {
+        EXPECT_EQ(mnxValidateTestMain(args.argc(), args.argv()), EXIT_CODE_ERRORS);
+    });
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <cstdint>
+#include <filesystem>
+
+#include "gtest/gtest.h"
+#include "mnxvalidate.h"
+#include "memorybudget.h"
+#include "test_utils.h"
+
+using namespace mnxvalidate;
+
+TEST(Memory, BudgetAdmitsWhileEstimatesFit)
+{
+    MemoryBudget budget(100);
+    ASSERT_TRUE(budget.admits(60));
+    budget.acquire(60);
+    EXPECT_TRUE(budget.admits(40));
+    EXPECT_FALSE(budget.admits(41));
+    EXPECT_FALSE(budget.admits(500)) << "a file over the budget waits until nothing else is running";
+    budget.release(60);
+    ASSERT_TRUE(budget.admits(500));
+    budget.acquire(500);
+    EXPECT_FALSE(budget.admits(1)) << "a file over the budget runs alone";
+    budget.release(500);
+    EXPECT_EQ(budget.inUse(), 0u);
+
+    MemoryBudget unlimited(0);
+    unlimited.acquire(1000);
+    EXPECT_TRUE(unlimited.admits(1000));
+    EXPECT_GT(MemoryBudget::estimateFor(1000), 1000u);
+    EXPECT_GT(MemoryBudget::estimateFor(UINTMAX_MAX / 2), UINTMAX_MAX / 2) << "the estimate saturates rather than wrapping";
+}
+
+TEST(Memory, MaxMemoryValidatesEveryFile)
+{
+    setupTestDataPaths();
+    const auto root = getOutputPath() / "memory";
+    std::filesystem::create_directories(root);
+    for (int x = 0; x < 8; x++) {
+        std::filesystem::copy_file(getInputPath() / "valid.mnx", root / ("score" + std::to_string(x) + ".mnx"));
+    }
+    // each file's estimate is about a tenth of the budget
+    ArgList args = { MNXVALIDATE_NAME, utils::pathToString(root), "--jobs", "4", "--max-memory", "1" };
+    checkStderr({ utils::pathToString(root / "score0.mnx"), utils::pathToString(root / "score7.mnx"),
+        "Peak memory use:", "(--max-memory 1 MB)" }, [&]() {
+        EXPECT_EQ(mnxValidateTestMain(args.argc(), args.argv()), 0);
+    });
+    ArgList zeroArgs = { MNXVALIDATE_NAME, utils::pathToString(root), "--max-memory", "0" };
+    checkStderr("Invalid value for --max-memory: 0", [&]() {
+        EXPECT_NE(mnxValidateTestMain(zeroArgs.argc(), zeroArgs.argv()), 0);
+    });
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "mnxvalidate.h"
+#include "test_utils.h"
+
+using namespace mnxvalidate;
+
+static std::filesystem::path runWithReport(const std::string& format, const std::string& extension)
+{
+    setupTestDataPaths();
+    std::filesystem::path validPath;
+    copyInputToOutput("valid.mnx", validPath);
+    std::filesystem::path invalidPath;
+    copyInputToOutput("generic_nonascii_其れ.json", invalidPath);
+    const auto reportPath = getOutputPath() / ("report." + extension);
+    ArgList args = { MNXVALIDATE_NAME, utils::pathToString(validPath), utils::pathToString(invalidPath),
+                     "--report", utils::pathToString(reportPath), "--report-format", format };
+    checkStderr({ "Schema validation succeeded", "Schema validation failed", "Validation errors" }, [&]() {
+        EXPECT_NE(mnxValidateTestMain(args.argc(), args.argv()), 0) << "invalid file should fail";
+    });
+    return reportPath;
+}
+
+TEST(Report, JsonLines)
+{
+    const auto reportPath = runWithReport("jsonl", "jsonl");
+    std::ifstream report(reportPath);
+    std::vector<json> records;
+    for (std::string line; std::getline(report, line);) {
+        records.push_back(json::parse(line));
+    }
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[0]["status"], "passed");
+    EXPECT_EQ(records[0]["errors"].size(), 0u);
+    EXPECT_TRUE(records[0]["durationMs"].is_number());
+    EXPECT_EQ(records[1]["status"], "failed");
+    EXPECT_EQ(records[1]["phase"], "schema");
+    ASSERT_FALSE(records[1]["errors"].empty());
+    EXPECT_EQ(records[1]["errors"][0]["phase"], "schema");
+    EXPECT_NE(records[1]["file"].get<std::string>().find("generic_nonascii_其れ.json"), std::string::npos);
+}
+
+TEST(Report, Sarif)
+{
+    const auto reportPath = runWithReport("sarif", "sarif");
+    std::ifstream report(reportPath);
+    const json sarif = json::parse(report);
+    EXPECT_EQ(sarif["version"], "2.1.0");
+    const auto& results = sarif["runs"][0]["results"];
+    ASSERT_GE(results.size(), 2u);
+    EXPECT_EQ(results[0]["kind"], "pass");
+    EXPECT_EQ(results[1]["kind"], "fail");
+    EXPECT_EQ(results[1]["ruleId"], "schema");
+    EXPECT_TRUE(results[1]["properties"]["durationMs"].is_number());
+}
+
+TEST(Report, Junit)
+{
+    const auto reportPath = runWithReport("junit", "xml");
+    std::ifstream report(reportPath);
+    std::stringstream contents;
+    contents << report.rdbuf();
+    const std::string xml = contents.str();
+    EXPECT_EQ(xml.rfind("<?xml", 0), 0u);
+    EXPECT_NE(xml.find(std::string("<testcase classname=\"") + MNXVALIDATE_NAME + ".semantic\""), std::string::npos);
+    EXPECT_NE(xml.find("<failure type=\"schema\""), std::string::npos);
+    EXPECT_NE(xml.find("</testsuites>"), std::string::npos);
+}
+
+TEST(Report, InvalidFormat)
+{
+    setupTestDataPaths();
+    ArgList args = { MNXVALIDATE_NAME, utils::pathToString(getInputPath() / "valid.mnx"), "--report-format", "csv" };
+    checkStderr("Invalid value for --report-format: csv", [&]() {
+        EXPECT_NE(mnxValidateTestMain(args.argc(), args.argv()), 0) << "invalid report format should fail";
+    });
+}
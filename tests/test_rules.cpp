@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "mnxvalidate.h"
+#include "corpusgenerator.h"
+#include "test_utils.h"
+
+using namespace mnxvalidate;
+
+static std::string generateWithError(InjectedError error)
+{
+    CorpusOptions options;
+    options.parts = 3;
+    options.measures = 16;
+    options.tieRate = 0.5;
+    options.slurRate = 0.5;
+    options.errors = { { error, 1.0 } };
+    std::ostringstream output;
+    CorpusGenerator(options, 9).writeScore(output, 0);
+    return output.str();
+}
+
+static SemanticRuleSet only(SemanticRule rule)
+{
+    return SemanticRuleSet{}.set(static_cast<size_t>(rule));
+}
+
+TEST(Rules, Names)
+{
+    for (const auto rule : kSemanticRules) {
+        EXPECT_EQ(semanticRuleFromName(semanticRuleName(rule)), rule);
+        EXPECT_FALSE(semanticRuleDescription(rule).empty());
+    }
+    EXPECT_FALSE(semanticRuleFromName("durations").has_value());
+}
+
+TEST(Rules, RemovesOnlySkippedContent)
+{
+    const mnx::json original = mnx::json::parse(R"({
+        "global": { "measures": [{}], "lyrics": { "lineOrder": ["1"] } },
+        "parts": [{ "measures": [{
+            "beams": [{ "events": ["e1", "e2"] }],
+            "sequences": [{ "content": [
+                { "type": "event", "id": "e1", "slurs": [{ "target": "e2" }], "lyrics": { "lines": { "1": { "text": "la" } } },
+                  "notes": [{ "id": "n1", "ties": [{ "target": "n2" }] }] },
+                { "type": "tuplet", "content": [{ "type": "event", "id": "e2", "notes": [{ "id": "n2" }] }] }
+            ] }]
+        }] }],
+        "layouts": [{ "id": "l1", "content": [] }],
+        "scores": [{ "name": "Score", "layout": "l1" }]
+    })");
+
+    mnx::json root = original;
+    removeSkippedRuleContent(root, {});
+    EXPECT_EQ(root, original);
+
+    removeSkippedRuleContent(root, only(SemanticRule::Beams) | only(SemanticRule::Layouts));
+    const auto& measure = root["parts"][0]["measures"][0];
+    EXPECT_FALSE(measure.contains("beams"));
+    EXPECT_FALSE(root.contains("layouts"));
+    EXPECT_FALSE(root.contains("scores"));
+    EXPECT_TRUE(measure["sequences"][0]["content"][0].contains("slurs"));
+    EXPECT_TRUE(root["global"].contains("lyrics"));
+
+    removeSkippedRuleContent(root, only(SemanticRule::Ties) | only(SemanticRule::Slurs) | only(SemanticRule::Lyrics));
+    const auto& event = measure["sequences"][0]["content"][0];
+    EXPECT_FALSE(event.contains("slurs"));
+    EXPECT_FALSE(event.contains("lyrics"));
+    EXPECT_FALSE(event["notes"][0].contains("ties"));
+    EXPECT_EQ(event["notes"][0]["id"], "n1");
+    EXPECT_EQ(measure["sequences"][0]["content"][1]["content"][0]["id"], "e2") << "nested content is kept";
+    EXPECT_FALSE(root["global"].contains("lyrics"));
+}
+
+TEST(Rules, KeepsSameNamedMembersElsewhere)
+{
+    const mnx::json original = mnx::json::parse(R"({
+        "global": { "measures": [{}] },
+        "parts": [{
+            "_x": { "beams": 1, "ottavas": 2 },
+            "measures": [{
+                "beams": [{ "events": ["e1"] }],
+                "_x": { "slurs": 3, "lyrics": 4, "ties": 5 },
+                "sequences": [{ "content": [
+                    { "type": "event", "id": "e1", "slurs": [{ "target": "e1" }],
+                      "_x": { "slurs": 6, "lyrics": 7 },
+                      "notes": [{ "id": "n1", "ties": [{ "target": "n1" }], "_x": { "ties": 8 } }] }
+                ] }]
+            }]
+        }]
+    })");
+    mnx::json root = original;
+    SemanticRuleSet skipped;
+    skipped.set();
+    removeSkippedRuleContent(root, skipped);
+    const auto& part = root["parts"][0];
+    const auto& measure = part["measures"][0];
+    const auto& event = measure["sequences"][0]["content"][0];
+    EXPECT_FALSE(measure.contains("beams"));
+    EXPECT_FALSE(event.contains("slurs"));
+    EXPECT_FALSE(event["notes"][0].contains("ties"));
+    EXPECT_EQ(part["_x"], original["parts"][0]["_x"]);
+    EXPECT_EQ(measure["_x"], original["parts"][0]["measures"][0]["_x"]);
+    EXPECT_EQ(event["_x"], original["parts"][0]["measures"][0]["sequences"][0]["content"][0]["_x"]);
+    EXPECT_EQ(event["notes"][0]["_x"]["ties"], 8);
+}
+
+TEST(Rules, SkippedGroupsDoNotReport)
+{
+    const std::pair<InjectedError, SemanticRule> cases[] = {
+        { InjectedError::MissingTieTarget, SemanticRule::Ties },
+        { InjectedError::TiePitchMismatch, SemanticRule::Ties },
+        { InjectedError::MissingSlurTarget, SemanticRule::Slurs },
+        { InjectedError::EmptyBeam, SemanticRule::Beams },
+        { InjectedError::DuplicateBeamEvent, SemanticRule::Beams },
+        { InjectedError::LayoutPartRef, SemanticRule::Layouts },
+    };
+    const Validator everything;
+    for (const auto& [error, rule] : cases) {
+        const std::string score = generateWithError(error);
+        const std::string name(CorpusGenerator::errorName(error));
+        EXPECT_FALSE(everything.validate(score).valid()) << name;
+
+        ValidatorOptions options;
+        options.skippedRules = only(rule);
+        const auto skipped = Validator(std::nullopt, options).validate(score);
+        EXPECT_TRUE(skipped.valid()) << name << " should not be reported without " << semanticRuleName(rule);
+        ASSERT_TRUE(skipped.stats.has_value());
+        EXPECT_EQ(skipped.stats->layouts, 1u) << "stats describe the whole document";
+
+        options.skippedRules = ~only(rule);
+        EXPECT_FALSE(Validator(std::nullopt, options).validate(score).valid()) << name << " should be reported by " << semanticRuleName(rule);
+    }
+
+    ValidatorOptions options;
+    options.skippedRules = ~SemanticRuleSet{};
+    EXPECT_FALSE(Validator(std::nullopt, options).validate(generateWithError(InjectedError::DuplicateId)).valid())
+        << "checks outside the groups are always made";
+}
+
+TEST(Rules, CommandLine)
+{
+    setupTestDataPaths();
+    const auto path = getOutputPath() / "slur_errors.mnx";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << generateWithError(InjectedError::MissingSlurTarget);
+    }
+    {
+        ArgList args = { MNXVALIDATE_NAME, utils::pathToString(path), "--skip-rules", "slurs" };
+        checkStderr("Semantic validation complete", [&]() {
+            EXPECT_EQ(mnxValidateTestMain(args.argc(), args.argv()), 0);
+        });
+    }
+    {
+        ArgList args = { MNXVALIDATE_NAME, utils::pathToString(path), "--rules", "ties,beams" };
+        checkStderr("Semantic validation complete", [&]() {
+            EXPECT_EQ(mnxValidateTestMain(args.argc(), args.argv()), 0);
+        });
+    }
+    const auto rulesPath = getOutputPath() / "rules.txt";
+    {
+        std::ofstream file(rulesPath, std::ios::binary);
+        file << "# ingest gate\nties layouts\n-slurs\n";
+    }
+    {
+        ArgList args = { MNXVALIDATE_NAME, utils::pathToString(path), "--rules-file", utils::pathToString(rulesPath) };
+        checkStderr("Semantic validation complete", [&]() {
+            EXPECT_EQ(mnxValidateTestMain(args.argc(), args.argv()), 0);
+        });
+    }
+    {
+        ArgList args = { MNXVALIDATE_NAME, utils::pathToString(path), "--rules", "slurs" };
+        checkStderr("Semantic validation errors", [&]() {
+            EXPECT_NE(mnxValidateTestMain(args.argc(), args.argv()), 0);
+        });
+    }
+    {
+        ArgList args = { MNXVALIDATE_NAME, utils::pathToString(path), "--skip-rules", "durations" };
+        checkStderr("Unknown rule group for --skip-rules: durations", [&]() {
+            EXPECT_NE(mnxValidateTestMain(args.argc(), args.argv()), 0);
+        });
+    }
+    {
+        ArgList args = { MNXVALIDATE_NAME, "--list-rules" };
+        checkStdout({ "ties", "slurs", "beams", "ottavas", "lyrics", "layouts" }, [&]() {
+            EXPECT_EQ(mnxValidateTestMain(args.argc(), args.argv()), 0);
+        });
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <sstream>
+#include <vector>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "validator.h"
+#include "semanticshards.h"
+#include "corpusgenerator.h"
+
+using namespace mnxvalidate;
+
+static std::string generate(const CorpusOptions& options, std::uint64_t seed)
+{
+    std::ostringstream output;
+    CorpusGenerator(options, seed).writeScore(output, 0);
+    return output.str();
+}
+
+static CorpusOptions shardedScoreOptions()
+{
+    CorpusOptions options;
+    options.parts = 7;
+    options.measures = 32;
+    options.voices = 2;
+    options.layouts = 2;
+    options.tieRate = 0.5;
+    options.slurRate = 0.5;
+    return options;
+}
+
+TEST(SemanticShards, ValidDocumentAndPartsRestored)
+{
+    mnx::json root = mnx::json::parse(generate(shardedScoreOptions(), 3));
+    const mnx::json original = root;
+    EXPECT_EQ(semanticWorkload(root), 7u * 32u);
+    EXPECT_TRUE(semanticShardsValid(root, 3));
+    EXPECT_EQ(root, original) << "the parts should be moved back in their original order";
+    EXPECT_FALSE(semanticShardsValid(root, 1)) << "one thread leaves the check to the serial validator";
+
+    CorpusOptions onePart = shardedScoreOptions();
+    onePart.parts = 1;
+    mnx::json single = mnx::json::parse(generate(onePart, 3));
+    EXPECT_FALSE(semanticShardsValid(single, 4)) << "a document with one part cannot be split";
+}
+
+TEST(SemanticShards, DuplicateIdAcrossParts)
+{
+    mnx::json root = mnx::json::parse(generate(shardedScoreOptions(), 5));
+    auto& parts = root["parts"];
+    parts[6]["measures"][0]["sequences"][0]["content"][0]["id"] = parts[0]["measures"][0]["sequences"][0]["content"][0]["id"];
+    const mnx::json original = root;
+    EXPECT_FALSE(semanticShardsValid(root, 7)) << "each part is valid alone, but the ids collide";
+    EXPECT_EQ(root, original);
+}
+
+TEST(SemanticShards, SameResultsAsSerial)
+{
+    ValidatorOptions serialOptions;
+    ValidatorOptions splitOptions;
+    splitOptions.semanticJobs = 4;
+    splitOptions.semanticSplitThreshold = 1;
+    const Validator serial(std::nullopt, serialOptions);
+    const Validator split(std::nullopt, splitOptions);
+
+    std::vector<std::pair<std::string, std::string>> scores{ { "valid", generate(shardedScoreOptions(), 11) } };
+    for (const auto error : CorpusGenerator::allErrors()) {
+        CorpusOptions options = shardedScoreOptions();
+        options.errors = { { error, 0.05 } };
+        scores.emplace_back(std::string(CorpusGenerator::errorName(error)), generate(options, 11));
+    }
+    for (const auto& [name, score] : scores) {
+        const auto expected = serial.validate(score);
+        const auto actual = split.validate(score);
+        EXPECT_EQ(actual.valid(), expected.valid()) << name;
+        EXPECT_EQ(actual.phase, expected.phase) << name;
+        EXPECT_EQ(actual.timings.discardedSplit.has_value(), !expected.valid()) << name << ": only invalid files are checked twice";
+        EXPECT_FALSE(expected.timings.discardedSplit.has_value()) << name;
+        ASSERT_EQ(actual.diagnostics.size(), expected.diagnostics.size()) << name;
+        for (size_t x = 0; x < expected.diagnostics.size(); x++) {
+            EXPECT_EQ(actual.diagnostics[x].message, expected.diagnostics[x].message) << name;
+        }
+        ASSERT_EQ(actual.stats.has_value(), expected.stats.has_value()) << name;
+        if (expected.stats) {
+            EXPECT_EQ(actual.stats->parts, expected.stats->parts) << name;
+        }
+    }
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <filesystem>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "mnxvalidate.h"
+#include "test_utils.h"
+
+#ifndef _WIN32
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace mnxvalidate;
+
+static int connectTo(const std::filesystem::path& socketPath)
+{
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, utils::pathToString(socketPath).c_str(), sizeof(address.sun_path) - 1);
+    if (fd >= 0 && ::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// writes one frame of the protocol described in src/server.cpp
+static void sendFrame(int fd, char type, const std::string& payload)
+{
+    const auto size = static_cast<std::uint32_t>(payload.size() + 1);
+    std::string frame{ char(size >> 24), char(size >> 16), char(size >> 8), char(size), type };
+    frame += payload;
+    ASSERT_EQ(::write(fd, frame.data(), frame.size()), static_cast<ssize_t>(frame.size()));
+}
+
+// returns the server's output frames up to its exit frame, or everything received if the connection closes first
+static std::string readResponse(int fd)
+{
+    std::string received;
+    char buffer[4096];
+    for (ssize_t count; (count = ::read(fd, buffer, sizeof(buffer))) > 0;) {
+        received.append(buffer, static_cast<size_t>(count));
+        size_t pos = 0;
+        while (received.size() - pos >= 5) {
+            const std::uint32_t size = (std::uint32_t(static_cast<unsigned char>(received[pos])) << 24)
+                | (std::uint32_t(static_cast<unsigned char>(received[pos + 1])) << 16)
+                | (std::uint32_t(static_cast<unsigned char>(received[pos + 2])) << 8) | static_cast<unsigned char>(received[pos + 3]);
+            if (received.size() - pos < 4 + size) {
+                break;
+            }
+            if (received[pos + 4] == 'X') {
+                return received;
+            }
+            pos += 4 + size;
+        }
+    }
+    return received;
+}
+
+TEST(Server, ClientValidatesThroughServer)
+{
+    setupTestDataPaths();
+    std::filesystem::path validPath;
+    copyInputToOutput("valid.mnx", validPath);
+    std::filesystem::path invalidPath;
+    copyInputToOutput("generic_nonascii_其れ.json", invalidPath);
+    // socket paths are limited to around 100 bytes, so avoid the (possibly deep) test data directory
+    const auto socketPath = std::filesystem::temp_directory_path() / ("mnxvalidate-test-" + std::to_string(::getpid()) + ".sock");
+
+    ArgList serverArgs = { MNXVALIDATE_NAME, "--serve", utils::pathToString(socketPath) };
+    int serverResult = -1;
+    std::thread server([&]() {
+        serverResult = mnxValidateTestMain(serverArgs.argc(), serverArgs.argv());
+    });
+    for (int x = 0; x < 500 && !std::filesystem::exists(socketPath); x++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_TRUE(std::filesystem::exists(socketPath)) << "server did not start";
+
+    ArgList validArgs = { MNXVALIDATE_NAME, "--client", utils::pathToString(socketPath), utils::pathToString(validPath) };
+    checkStderr({ "Processing", utils::pathToString(validPath.filename()), "Schema validation succeeded" }, [&]() {
+        EXPECT_EQ(mnxValidateTestMain(validArgs.argc(), validArgs.argv()), 0) << "validate " << utils::pathToString(validPath);
+    });
+    ArgList invalidArgs = { MNXVALIDATE_NAME, utils::pathToString(invalidPath), "--client", utils::pathToString(socketPath), "--schema-only" };
+    checkStderr({ "Processing", utils::pathToString(invalidPath.filename()), "Schema validation failed" }, [&]() {
+        EXPECT_NE(mnxValidateTestMain(invalidArgs.argc(), invalidArgs.argv()), 0) << "validate " << utils::pathToString(invalidPath);
+    });
+    ArgList badOptionArgs = { MNXVALIDATE_NAME, utils::pathToString(validPath), "--client", utils::pathToString(socketPath), "--bogus" };
+    checkStderr("Unknown option: --bogus", [&]() {
+        EXPECT_NE(mnxValidateTestMain(badOptionArgs.argc(), badOptionArgs.argv()), 0) << "unknown option should fail on the server";
+    });
+
+    const std::string validLine = json::parse(utils::fileToString(validPath)).dump();
+    std::istringstream stdinInput(validLine + "\n" + validLine + "\n");
+    std::streambuf* originalCin = std::cin.rdbuf(stdinInput.rdbuf());
+    ArgList stdinArgs = { MNXVALIDATE_NAME, "--client", utils::pathToString(socketPath), "--stdin-format", "ndjson", "-" };
+    checkStderr({ "Processing File: stdin#1", "stdin#1 Schema validation succeeded", "stdin#2 Schema validation succeeded" }, [&]() {
+        EXPECT_EQ(mnxValidateTestMain(stdinArgs.argc(), stdinArgs.argv()), 0) << "stdin sent to the server";
+    });
+    std::cin.rdbuf(originalCin);
+    // the command line handles --list-rules itself, so only a client speaking the protocol can send it
+    const int rulesClient = connectTo(socketPath);
+    ASSERT_GE(rulesClient, 0);
+    sendFrame(rulesClient, 'A', "--list-rules");
+    sendFrame(rulesClient, 'E', "");
+    const std::string response = readResponse(rulesClient);
+    ::close(rulesClient);
+    EXPECT_NE(response.find("--list-rules cannot be sent to a server"), std::string::npos) << response;
+
+    // a client that connects and never sends a request must not keep the server from stopping
+    const int idleClient = connectTo(socketPath);
+    ASSERT_GE(idleClient, 0);
+
+    ArgList stopArgs = { MNXVALIDATE_NAME, "--client", utils::pathToString(socketPath), "--stop" };
+    EXPECT_EQ(mnxValidateTestMain(stopArgs.argc(), stopArgs.argv()), 0);
+    server.join();
+    ::close(idleClient);
+    EXPECT_EQ(serverResult, 0);
+    EXPECT_FALSE(std::filesystem::exists(socketPath)) << "server should remove its socket";
+}
+
+TEST(Server, NoServer)
+{
+    setupTestDataPaths();
+    const auto socketPath = std::filesystem::temp_directory_path() / ("mnxvalidate-test-none-" + std::to_string(::getpid()) + ".sock");
+    ArgList args = { MNXVALIDATE_NAME, "--client", utils::pathToString(socketPath), utils::pathToString(getInputPath() / "valid.mnx") };
+    checkStderr("Unable to connect to server", [&]() {
+        EXPECT_NE(mnxValidateTestMain(args.argc(), args.argv()), 0) << "client without a server should fail";
+    });
+}
+
+#endif
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "mnxvalidate.h"
+#include "test_utils.h"
+
+using namespace mnxvalidate;
+
+static void checkStdinStream(const std::string& stdinContents, const std::vector<std::string>& expectedMessages, ArgList& args, bool expectSuccess)
+{
+    std::istringstream input(stdinContents);
+    std::streambuf* originalCin = std::cin.rdbuf(input.rdbuf());
+    checkStderr(expectedMessages, [&]() {
+        if (expectSuccess) {
+            EXPECT_EQ(mnxValidateTestMain(args.argc(), args.argv()), 0) << "validate stdin";
+        } else {
+            EXPECT_NE(mnxValidateTestMain(args.argc(), args.argv()), 0) << "validate stdin";
+        }
+    });
+    std::cin.rdbuf(originalCin);
+}
+
+static std::string readInput(const std::string& fileName)
+{
+    return utils::fileToString(getInputPath() / utils::utf8ToPath(fileName));
+}
+
+TEST(Stdin, Ndjson)
+{
+    setupTestDataPaths();
+    const std::string valid = json::parse(readInput("valid.mnx")).dump();
+    const std::string invalid = json::parse(readInput("generic_nonascii_其れ.json")).dump();
+    ArgList args = { MNXVALIDATE_NAME, "-" };
+    checkStdinStream(valid + "\n\n" + invalid + "\n" + valid, {
+        "Processing File: stdin#1", "Processing File: stdin#2", "Processing File: stdin#3", "!stdin#4",
+        "stdin#1 Schema validation succeeded", "stdin#2 [***ERROR***] Schema validation failed", "stdin#3 Schema validation succeeded"
+    }, args, false);
+}
+
+TEST(Stdin, FramedWithIds)
+{
+    setupTestDataPaths();
+    const std::string valid = readInput("valid.mnx");
+    const std::string invalid = readInput("generic_nonascii_其れ.json");
+    ArgList args = { MNXVALIDATE_NAME, "--stdin-stream", "--stdin-format", "framed", "--jobs", "2" };
+    checkStdinStream(std::to_string(valid.size()) + " score-a\n" + valid + "\n" + std::to_string(valid.size()) + "\n" + valid, {
+        "Processing File: score-a", "Processing File: stdin#2", "score-a Schema validation succeeded", "stdin#2 Schema validation succeeded"
+    }, args, true);
+    checkStdinStream(std::to_string(invalid.size()) + " generic\n" + invalid + "999 truncated\n{}", {
+        "generic [***ERROR***] Schema validation failed", "Document truncated is truncated"
+    }, args, false);
+}
+
+TEST(Stdin, FramedHeaderLimits)
+{
+    setupTestDataPaths();
+    const std::string valid = readInput("valid.mnx");
+    ArgList args = { MNXVALIDATE_NAME, "--stdin-stream", "--stdin-format", "framed" };
+    checkStdinStream("18446744073709551615\n{}", {
+        "Invalid header for document stdin#1", "more than the limit"
+    }, args, false);
+    checkStdinStream(std::to_string(valid.size()) + " scores.zip!/a.mnx\n" + valid, {
+        "Invalid id for document stdin#1", "!Processing File"
+    }, args, false);
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <filesystem>
+
+#include "gtest/gtest.h"
+#include "mnxvalidate.h"
+#include "streamingschema.h"
+#include "test_utils.h"
+
+using namespace mnxvalidate;
+
+static nlohmann::json loadGenericSchema()
+{
+    setupTestDataPaths();
+    return nlohmann::json::parse(utils::fileToString(getInputPath() / "generic_schema.json"));
+}
+
+TEST(Streaming, GenericSchema)
+{
+    const StreamingSchema schema(loadGenericSchema());
+    EXPECT_TRUE(schema.validate(utils::fileToString(getInputPath() / utils::utf8ToPath("generic_nonascii_其れ.json"))));
+
+    const auto result = schema.validate(R"({"name": "a", "email": 3, "age": -1, "tags": ["x", 2], "extra": true})");
+    ASSERT_EQ(result.errors.size(), 4u);
+    EXPECT_EQ(result.errors[0].pointer, "/email");
+    EXPECT_EQ(result.errors[1].pointer, "/age");
+    EXPECT_EQ(result.errors[2].pointer, "/tags/1");
+    EXPECT_EQ(result.errors[3].pointer, "/extra");
+    EXPECT_FALSE(result.truncated);
+
+    const auto missing = schema.validate(R"({"name": "a"})");
+    ASSERT_EQ(missing.errors.size(), 1u);
+    EXPECT_EQ(missing.errors[0].pointer, "");
+    EXPECT_NE(missing.errors[0].message.find("email"), std::string::npos);
+}
+
+TEST(Streaming, Combinators)
+{
+    const StreamingSchema schema(nlohmann::json::parse(R"({
+        "$defs": { "node": { "type": "object", "properties": { "kids": { "type": "array", "items": { "$ref": "#/$defs/node" } } } } },
+        "type": "object",
+        "properties": {
+            "any": { "anyOf": [ { "type": "string" }, { "type": "object", "required": ["a"] } ] },
+            "one": { "oneOf": [ { "type": "integer" }, { "minimum": 2 } ] },
+            "not": { "not": { "const": "bad" } },
+            "tree": { "$ref": "#/$defs/node" }
+        }
+    })"));
+    EXPECT_TRUE(schema.validate(R"({"any": "x", "one": 1, "not": "good", "tree": {"kids": [{"kids": []}]}})"));
+    EXPECT_TRUE(schema.validate(R"({"any": {"a": 1}, "one": 2.5})"));
+
+    const auto result = schema.validate(R"({"any": {"b": {"a": 1}}, "one": 3, "not": "bad", "tree": {"kids": [{"kids": [1]}]}})");
+    ASSERT_EQ(result.errors.size(), 4u) << "failed branches of a combinator report only the combinator";
+    EXPECT_EQ(result.errors[0].pointer, "/any");
+    EXPECT_EQ(result.errors[1].pointer, "/one");
+    EXPECT_EQ(result.errors[2].pointer, "/not");
+    EXPECT_EQ(result.errors[3].pointer, "/tree/kids/0/kids/0");
+}
+
+TEST(Streaming, MaxErrors)
+{
+    const StreamingSchema schema(nlohmann::json::parse(R"({"type": "array", "items": {"type": "string"}})"));
+    const auto result = schema.validate("[1, 2, 3, 4]", 2);
+    EXPECT_EQ(result.errors.size(), 2u);
+    EXPECT_TRUE(result.truncated);
+}
+
+TEST(Streaming, ParseError)
+{
+    const StreamingSchema schema(loadGenericSchema());
+    EXPECT_THROW(schema.validate(R"({"name": "a",)"), nlohmann::json::parse_error);
+    EXPECT_THROW(schema.validate(R"({"name": "a"} {})"), nlohmann::json::parse_error);
+}
+
+TEST(Streaming, UnsupportedSchema)
+{
+    EXPECT_THROW(StreamingSchema(nlohmann::json::parse(R"({"uniqueItems": true})")), std::invalid_argument);
+    EXPECT_THROW(StreamingSchema(nlohmann::json::parse(R"({"$ref": "other.json#/x"})")), std::invalid_argument);
+    EXPECT_NO_THROW(StreamingSchema(nlohmann::json::parse(R"({"uniqueItems": false, "title": "ignored"})")));
+
+    SchemaValidator validator(R"({"type": "array", "uniqueItems": true})");
+    EXPECT_FALSE(validator.canStream());
+    EXPECT_NE(validator.streamingUnavailableReason().find("uniqueItems"), std::string::npos);
+}
+
+TEST(Streaming, SchemaOnlyStreams)
+{
+    setupTestDataPaths();
+    std::filesystem::path inputPath = getInputPath() / "valid.mnx";
+    ArgList args = { MNXVALIDATE_NAME, utils::pathToString(inputPath), "--schema", utils::pathToString(getInputPath() / "generic_schema.json"), "--schema-only" };
+    checkStderr({ "Processing", "Validation errors:", "required property 'name'", "Schema validation failed" }, [&]() {
+        EXPECT_NE(mnxValidateTestMain(args.argc(), args.argv()), 0) << "validate " << utils::pathToString(inputPath);
+    });
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "mnxvalidate.h"
+#include "timingstats.h"
+#include "test_utils.h"
+
+using namespace mnxvalidate;
+
+TEST(Timings, Summary)
+{
+    setupTestDataPaths();
+    std::filesystem::path validPath;
+    copyInputToOutput("valid.mnx", validPath);
+    std::filesystem::path invalidPath;
+    copyInputToOutput("generic_nonascii_其れ.json", invalidPath);
+    const auto reportPath = getOutputPath() / "timings.jsonl";
+    ArgList args = { MNXVALIDATE_NAME, utils::pathToString(validPath), utils::pathToString(invalidPath),
+                     "--timings", "--timings-slowest", "1", "--report", utils::pathToString(reportPath) };
+    checkStderr({ "Timings: 2 files", "files/s", "MB/s", "p50 ms", "parse ", "semantic ", "Slowest files:" }, [&]() {
+        EXPECT_NE(mnxValidateTestMain(args.argc(), args.argv()), 0) << "invalid file should fail";
+    });
+
+    std::ifstream report(reportPath);
+    std::vector<json> records;
+    for (std::string line; std::getline(report, line);) {
+        records.push_back(json::parse(line));
+    }
+    ASSERT_EQ(records.size(), 3u);
+    EXPECT_GT(records[0]["bytes"].get<size_t>(), 0u);
+    EXPECT_TRUE(records[0]["phaseMs"]["semantic"].is_number());
+    EXPECT_TRUE(records[1]["phaseMs"]["schema"].is_number());
+    EXPECT_FALSE(records[1]["phaseMs"].contains("semantic")) << "phases after a failure did not run";
+    const auto& timings = records[2]["timings"];
+    EXPECT_EQ(timings["files"], 2);
+    EXPECT_EQ(timings["phases"]["total"]["count"], 2);
+    EXPECT_EQ(timings["phases"]["semantic"]["count"], 1);
+    EXPECT_EQ(timings["slowest"].size(), 1u);
+}
+
+TEST(Timings, NotInReportByDefault)
+{
+    setupTestDataPaths();
+    const auto reportPath = getOutputPath() / "no_timings.jsonl";
+    ArgList args = { MNXVALIDATE_NAME, utils::pathToString(getInputPath() / "valid.mnx"), "--report", utils::pathToString(reportPath) };
+    checkStderr("Semantic validation complete", [&]() {
+        EXPECT_EQ(mnxValidateTestMain(args.argc(), args.argv()), 0);
+    });
+    std::ifstream report(reportPath);
+    std::string line;
+    ASSERT_TRUE(std::getline(report, line));
+    EXPECT_FALSE(json::parse(line).contains("phaseMs"));
+    EXPECT_FALSE(std::getline(report, line)) << "no summary record without --timings";
+}
+
+TEST(Timings, Percentiles)
+{
+    DurationHistogram histogram;
+    for (int x = 1; x <= 100; x++) {
+        histogram.add(std::chrono::milliseconds(x));
+    }
+    EXPECT_EQ(histogram.count(), 100u);
+    EXPECT_EQ(histogram.max(), std::chrono::milliseconds(100));
+    EXPECT_EQ(histogram.total(), std::chrono::milliseconds(5050));
+    for (auto [fraction, expected] : { std::pair{ 0.50, 50.0 }, std::pair{ 0.95, 95.0 }, std::pair{ 0.99, 99.0 } }) {
+        const double actual = std::chrono::duration<double, std::milli>(histogram.percentile(fraction)).count();
+        EXPECT_GE(actual, expected);
+        EXPECT_LE(actual, expected * 1.04) << "buckets are about 3% wide";
+    }
+    EXPECT_EQ(histogram.percentile(1.0), histogram.max());
+}
@@ -75,6 +75,9 @@ void checkStderr(const std::vector<std::string>& expectedMessages, std::function
 inline void checkStderr(const std::string& expectedMessage, std::function<void()> callback)
 { checkStderr(std::vector<std::string>({ expectedMessage }), callback); }
 
+// runs the program and returns everything it wrote to stderr, for tests that compare whole outputs
+std::string captureStderr(ArgList& args, int& result);
+
 void checkStdout(const std::vector<std::string>& expectedMessages, std::function<void()> callback);
 inline void checkStdout(const std::string& expectedMessage, std::function<void()> callback)
 { checkStdout(std::vector<std::string>({ expectedMessage }), callback); }
@@ -89,6 +92,7 @@ inline std::filesystem::path getOutputPath()
 
 void setupTestDataPaths();
 void copyInputToOutput(const std::string& fileName, std::filesystem::path& outputPath);
+void writeFile(const std::filesystem::path& path, const std::string& contents); // throws if the file cannot be written
 void compareFiles(const std::filesystem::path& path1, const std::filesystem::path& path2);
 
 void assertStringsInFile(const std::vector<std::string>& targets, const std::filesystem::path& filePath, const std::filesystem::path& extension = {});
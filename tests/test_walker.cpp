@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <filesystem>
+#include <set>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "gtest/gtest.h"
+#include "mnxvalidate.h"
+#include "directorywalker.h"
+#include "test_utils.h"
+
+using namespace mnxvalidate;
+
+// Builds outputs/tree with mnx files at several depths and returns them
+static std::set<std::filesystem::path> makeTree()
+{
+    setupTestDataPaths();
+    const auto root = getOutputPath() / "tree";
+    std::set<std::filesystem::path> mnxFiles;
+    for (const char* dir : { "", "a", "a/b", "a/b/c", "d", "d/e" }) {
+        const auto dirPath = root / dir;
+        std::filesystem::create_directories(dirPath);
+        for (int x = 0; x < 3; x++) {
+            const auto filePath = dirPath / ("score" + std::to_string(x) + ".mnx");
+            std::filesystem::copy_file(getInputPath() / "valid.mnx", filePath);
+            mnxFiles.insert(filePath);
+        }
+        std::filesystem::copy_file(getInputPath() / "valid.mnx", dirPath / "notes.txt");
+    }
+    return mnxFiles;
+}
+
+static std::set<std::filesystem::path> walk(const std::filesystem::path& root, bool recursive, unsigned threads,
+    size_t expectedDirectories, size_t expectedErrors = 0)
+{
+    std::set<std::filesystem::path> found;
+    DirectoryWalker walker(root, recursive, [](const std::filesystem::path& path) {
+        return utils::hasExtension(path, MNX_EXTENSION);
+    }, threads);
+    while (auto path = walker.next()) {
+        EXPECT_TRUE(found.insert(path.value()).second) << "found twice: " << utils::pathToString(path.value());
+    }
+    EXPECT_EQ(walker.errors().size(), expectedErrors);
+    EXPECT_EQ(walker.directoryCount(), expectedDirectories);
+    return found;
+}
+
+TEST(Walker, FindsEveryFileOnce)
+{
+    const auto expected = makeTree();
+    const auto root = getOutputPath() / "tree";
+    for (unsigned threads : { 1u, 4u }) {
+        EXPECT_EQ(walk(root, true, threads, 6), expected) << threads << " threads";
+    }
+    const auto topLevel = walk(root, false, 4, 1);
+    EXPECT_EQ(topLevel.size(), 3u);
+}
+
+#ifndef _WIN32 // creating symbolic links on Windows requires extra privileges
+
+TEST(Walker, SymlinkLoop)
+{
+    const auto expected = makeTree();
+    const auto root = getOutputPath() / "tree";
+    std::filesystem::create_directory_symlink(root, root / "a" / "b" / "loop");
+    std::filesystem::create_directory_symlink(root / "d", root / "a" / "d-link");
+    EXPECT_EQ(walk(root, true, 4, 6), expected) << "each directory should be searched once";
+}
+
+TEST(Walker, UnreadableDirectory)
+{
+    if (::geteuid() == 0) {
+        GTEST_SKIP() << "permissions do not apply to root";
+    }
+    auto expected = makeTree();
+    const auto root = getOutputPath() / "tree";
+    const auto locked = root / "a" / "b";
+    std::filesystem::permissions(locked, std::filesystem::perms::none);
+    std::erase_if(expected, [&](const std::filesystem::path& path) {
+        return utils::pathToString(path).starts_with(utils::pathToString(locked));
+    });
+    const auto found = walk(root, true, 4, 4, 1); // a/b cannot be read, so a/b/c is never found
+    std::filesystem::permissions(locked, std::filesystem::perms::owner_all);
+    EXPECT_EQ(found, expected) << "the rest of the tree should still be searched";
+}
+
+#endif
+
+TEST(Walker, RecursiveValidation)
+{
+    const auto expected = makeTree();
+    ArgList args = { MNXVALIDATE_NAME, utils::pathToString(getOutputPath() / "tree"), "--recursive", "--verbose", "--jobs", "4" };
+    std::vector<std::string> messages = { "Searched 6 directories and 29 entries" };
+    for (const auto& path : expected) {
+        messages.push_back(utils::pathToString(path));
+    }
+    checkStderr(messages, [&]() {
+        EXPECT_EQ(mnxValidateTestMain(args.argc(), args.argv()), 0);
+    });
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <string>
+#include <fstream>
+#include <iterator>
+#include <filesystem>
+#include <thread>
+#include <chrono>
+#include <csignal>
+
+#include "gtest/gtest.h"
+#include "mnxvalidate.h"
+#include "test_utils.h"
+
+#ifdef __linux__
+
+using namespace mnxvalidate;
+
+// Waits up to five seconds for @p text to appear @p count times in the log and returns how many times it appeared
+static size_t waitForLog(const std::filesystem::path& logPath, const std::string& text, size_t count)
+{
+    size_t found = 0;
+    for (int x = 0; x < 500 && found < count; x++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::ifstream log(logPath);
+        const std::string contents((std::istreambuf_iterator<char>(log)), std::istreambuf_iterator<char>());
+        found = 0;
+        for (size_t pos = contents.find(text); pos != std::string::npos; pos = contents.find(text, pos + 1)) {
+            found++;
+        }
+    }
+    return found;
+}
+
+TEST(Watch, RevalidatesChangedFiles)
+{
+    setupTestDataPaths();
+    const auto root = getOutputPath() / "watch";
+    std::filesystem::create_directories(root);
+    for (const char* name : { "score.mnx", "other.mnx" }) {
+        std::filesystem::copy_file(getInputPath() / "valid.mnx", root / name);
+    }
+    const auto logPath = getOutputPath() / "watch.log";
+    ArgList args = { MNXVALIDATE_NAME, utils::pathToString(root), "--recursive", "--watch", "--watch-debounce", "50",
+        "--schema-only", "--log", utils::pathToString(logPath) };
+    int result = -1;
+    std::thread watcher([&]() {
+        result = mnxValidateTestMain(args.argc(), args.argv());
+    });
+    EXPECT_EQ(waitForLog(logPath, "Watching for changes", 1), 1u) << "the first pass did not finish";
+
+    // save the way editors do: write a temporary file, then rename it over the original
+    std::filesystem::copy_file(getInputPath() / "generic_nonascii_其れ.json", root / "score.mnx.tmp");
+    std::filesystem::rename(root / "score.mnx.tmp", root / "score.mnx");
+    std::filesystem::create_directories(root / "new");
+    std::filesystem::copy_file(getInputPath() / "valid.mnx", root / "new" / "added.mnx");
+
+    const auto scorePath = utils::pathToString(root / "score.mnx");
+    EXPECT_EQ(waitForLog(logPath, "Processing File: " + scorePath, 2), 2u) << "the changed file was not revalidated";
+    EXPECT_EQ(waitForLog(logPath, "Processing File: " + utils::pathToString(root / "new" / "added.mnx"), 1), 1u)
+        << "the file in the new directory was not validated";
+    EXPECT_EQ(waitForLog(logPath, "Processing File: " + utils::pathToString(root / "other.mnx"), 1), 1u)
+        << "an unchanged file should not be revalidated";
+
+    std::raise(SIGINT);
+    watcher.join();
+    EXPECT_EQ(result, EXIT_CODE_ERRORS) << "the changed file is invalid";
+    assertStringInFile("Schema validation failed", logPath);
+}
+
+TEST(Watch, RejectsStdin)
+{
+    setupTestDataPaths();
+    ArgList args = { MNXVALIDATE_NAME, "-", "--watch" };
+    checkStderr("stdin streams cannot be watched", [&]() {
+        EXPECT_NE(mnxValidateTestMain(args.argc(), args.argv()), 0);
+    });
+}
+
+#endif
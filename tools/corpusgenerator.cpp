@@ -0,0 +1,438 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <array>
+#include <algorithm>
+
+#include "corpusgenerator.h"
+
+namespace mnxvalidate {
+
+namespace {
+
+struct ErrorInfo
+{
+    InjectedError error;
+    std::string_view name;
+};
+
+constexpr std::array<ErrorInfo, 12> kErrorInfo = { {
+    { InjectedError::MeasureOverflow, "measure-overflow" },
+    { InjectedError::EmptyBeam, "empty-beam" },
+    { InjectedError::DuplicateBeamEvent, "duplicate-beam-event" },
+    { InjectedError::MissingTieTarget, "missing-tie-target" },
+    { InjectedError::TiePitchMismatch, "tie-pitch-mismatch" },
+    { InjectedError::DuplicateId, "duplicate-id" },
+    { InjectedError::MissingSlurTarget, "missing-slur-target" },
+    { InjectedError::TupletDuration, "tuplet-duration" },
+    { InjectedError::AlterRange, "alter-range" },
+    { InjectedError::MissingClef, "missing-clef" },
+    { InjectedError::DuplicateVoice, "duplicate-voice" },
+    { InjectedError::LayoutPartRef, "layout-part-ref" },
+} };
+
+// splitmix64. The standard distributions are allowed to differ between library implementations,
+// so the generator does its own arithmetic to produce the same scores everywhere.
+class Random
+{
+public:
+    explicit Random(std::uint64_t seed) : m_state(seed) {}
+
+    std::uint64_t next()
+    {
+        std::uint64_t z = (m_state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    bool chance(double probability) { return static_cast<double>(next() >> 11) * 0x1.0p-53 < probability; }
+    size_t below(size_t limit) { return static_cast<size_t>(next() % limit); }
+
+private:
+    std::uint64_t m_state;
+};
+
+struct Event
+{
+    std::string id{};
+    std::string base{};         ///< the duration's base note value
+    bool rest{};
+    std::string noteId{};
+    char step{ 'C' };
+    int octave{ 4 };
+    int alter{};
+    std::string tieTarget{};    ///< the note this event's note is tied to, if any
+    std::string slurTarget{};   ///< the event this event's slur ends on, if any
+};
+
+// A beat is one quarter, two eighths, or an eighth-note triplet
+struct Beat
+{
+    std::vector<Event> events{};
+    bool tuplet{};
+};
+
+struct Sequence
+{
+    std::string voice;
+    std::vector<Beat> beats;
+};
+
+// Decides once per opportunity whether to inject each requested error, in a fixed order,
+// so that the decisions for one error do not depend on which others were requested.
+class ErrorPlan
+{
+public:
+    ErrorPlan(const std::vector<std::pair<InjectedError, double>>& rates, Random& random)
+    {
+        for (const auto& [error, rate] : rates) {
+            if (random.chance(rate)) {
+                m_planned.push_back(error);
+            }
+        }
+    }
+
+    bool has(InjectedError error) const { return std::find(m_planned.begin(), m_planned.end(), error) != m_planned.end(); }
+
+private:
+    std::vector<InjectedError> m_planned;
+};
+
+void writeEvent(std::ostream& output, const Event& event)
+{
+    output << "{\"type\":\"event\",\"id\":\"" << event.id << "\",\"duration\":{\"base\":\"" << event.base << "\"}";
+    if (event.rest) {
+        output << ",\"rest\":{}";
+    } else {
+        output << ",\"notes\":[{\"id\":\"" << event.noteId << "\",\"pitch\":{\"step\":\"" << event.step << "\",\"octave\":" << event.octave;
+        if (event.alter) {
+            output << ",\"alter\":" << event.alter;
+        }
+        output << '}';
+        if (!event.tieTarget.empty()) {
+            output << ",\"ties\":[{\"target\":\"" << event.tieTarget << "\"}]";
+        }
+        output << "}]";
+    }
+    if (!event.slurTarget.empty()) {
+        output << ",\"slurs\":[{\"target\":\"" << event.slurTarget << "\"}]";
+    }
+    output << '}';
+}
+
+void writeBeat(std::ostream& output, const Beat& beat)
+{
+    if (beat.tuplet) {
+        output << "{\"type\":\"tuplet\",\"inner\":{\"multiple\":3,\"duration\":{\"base\":\"eighth\"}},"
+               << "\"outer\":{\"multiple\":1,\"duration\":{\"base\":\"quarter\"}},\"content\":[";
+    }
+    for (size_t x = 0; x < beat.events.size(); x++) {
+        output << (x ? "," : "");
+        writeEvent(output, beat.events[x]);
+    }
+    if (beat.tuplet) {
+        output << "]}";
+    }
+}
+
+class ScoreWriter
+{
+public:
+    ScoreWriter(const CorpusOptions& options, std::ostream& output, std::uint64_t seed)
+        : m_options(options), m_output(output), m_random(seed), m_errorRandom(~seed) {}
+
+    std::map<InjectedError, size_t> write()
+    {
+        m_output << "{\"mnx\":{\"version\":1},\"global\":{\"measures\":[";
+        for (size_t m = 0; m < m_options.measures; m++) {
+            m_output << (m ? ",{}" : "{\"key\":{\"fifths\":0},\"time\":{\"count\":4,\"unit\":4}}");
+        }
+        m_output << "]},\"parts\":[";
+        for (size_t p = 0; p < m_options.parts; p++) {
+            m_output << (p ? "," : "") << "{\"id\":\"" << partId(p) << "\",\"name\":\"Part " << p + 1 << "\",\"measures\":[";
+            const ErrorPlan partErrors(m_options.errors, m_errorRandom);
+            for (size_t m = 0; m < m_options.measures; m++) {
+                m_output << (m ? "," : "");
+                writePartMeasure(p, m, partErrors);
+            }
+            m_output << "]}";
+        }
+        m_output << ']';
+        if (m_options.layouts) {
+            writeLayouts();
+        }
+        m_output << "}\n";
+        return m_injected;
+    }
+
+private:
+    static std::string partId(size_t p) { return "P" + std::to_string(p + 1); }
+
+    bool inject(const ErrorPlan& plan, InjectedError error)
+    {
+        if (plan.has(error)) {
+            m_injected[error]++;
+            return true;
+        }
+        return false;
+    }
+
+    Event makeNote(const std::string& id, const char* base, size_t voice)
+    {
+        constexpr char kSteps[] = "CDEFGAB";
+        Event event{ id, base };
+        event.noteId = id + "n";
+        event.step = kSteps[m_random.below(7)];
+        event.octave = voice ? 3 : 4;
+        if (m_random.chance(0.1)) {
+            event.alter = m_random.chance(0.5) ? 1 : -1;
+        }
+        return event;
+    }
+
+    Sequence makeSequence(const std::string& prefix, size_t voice)
+    {
+        Sequence sequence{ "v" + std::to_string(voice + 1), {} };
+        for (size_t b = 0; b < 4; b++) {
+            const std::string beatPrefix = prefix + "b" + std::to_string(b + 1);
+            Beat beat;
+            if (m_random.chance(m_options.tupletRate)) {
+                beat.tuplet = true;
+                for (size_t e = 0; e < 3; e++) {
+                    beat.events.push_back(makeNote(beatPrefix + "e" + std::to_string(e + 1), "eighth", voice));
+                }
+            } else if (m_random.chance(0.5)) {
+                for (size_t e = 0; e < 2; e++) {
+                    beat.events.push_back(makeNote(beatPrefix + "e" + std::to_string(e + 1), "eighth", voice));
+                }
+            } else if (m_random.chance(0.1)) {
+                beat.events.push_back(Event{ beatPrefix + "e1", "quarter", true });
+            } else {
+                beat.events.push_back(makeNote(beatPrefix + "e1", "quarter", voice));
+            }
+            sequence.beats.push_back(std::move(beat));
+        }
+        return sequence;
+    }
+
+    void writePartMeasure(size_t p, size_t m, const ErrorPlan& partErrors)
+    {
+        const ErrorPlan errors(m_options.errors, m_errorRandom);
+        const std::string prefix = partId(p) + "m" + std::to_string(m + 1);
+        std::vector<Sequence> sequences;
+        for (size_t v = 0; v < std::max<size_t>(m_options.voices, 1); v++) {
+            sequences.push_back(makeSequence(prefix + "v" + std::to_string(v + 1), v));
+        }
+        auto& first = sequences.front();
+
+        // errors that change the structure are applied before beams and ties refer to it
+        if (inject(errors, InjectedError::TupletDuration)) {
+            for (auto& beat : first.beats) {
+                if (beat.tuplet) {
+                    beat.events.pop_back();
+                    break;
+                }
+            }
+        }
+        if (inject(errors, InjectedError::MeasureOverflow)) {
+            first.beats.push_back({ { makeNote(prefix + "extra", "quarter", 0) }, false });
+        }
+
+        std::vector<std::vector<std::string>> beams;
+        for (auto& sequence : sequences) {
+            for (size_t b = 0; b < sequence.beats.size(); b++) {
+                auto& beat = sequence.beats[b];
+                if (beat.events.size() > 1 && m_random.chance(m_options.beamRate)) {
+                    std::vector<std::string> beam;
+                    for (const auto& event : beat.events) {
+                        beam.push_back(event.id);
+                    }
+                    beams.push_back(std::move(beam));
+                }
+                if (b + 1 < sequence.beats.size()) {
+                    auto& next = sequence.beats[b + 1];
+                    if (beat.events.size() == 1 && next.events.size() == 1 && !beat.tuplet && !next.tuplet
+                        && !beat.events[0].rest && !next.events[0].rest && m_random.chance(m_options.tieRate)) {
+                        auto& from = beat.events[0];
+                        auto& to = next.events[0];
+                        to.step = from.step;
+                        to.octave = from.octave;
+                        to.alter = from.alter;
+                        from.tieTarget = to.noteId;
+                    }
+                }
+            }
+            std::vector<Event*> notes;
+            for (auto& beat : sequence.beats) {
+                for (auto& event : beat.events) {
+                    if (!event.rest) {
+                        notes.push_back(&event);
+                    }
+                }
+            }
+            if (notes.size() > 1 && m_random.chance(m_options.slurRate)) {
+                notes.front()->slurTarget = notes.back()->id;
+            }
+        }
+
+        std::vector<Event*> firstNotes;
+        for (auto& beat : first.beats) {
+            for (auto& event : beat.events) {
+                if (!event.rest) {
+                    firstNotes.push_back(&event);
+                }
+            }
+        }
+        if (!beams.empty() && inject(errors, InjectedError::DuplicateBeamEvent)) {
+            beams.push_back(beams.front());
+        }
+        if (inject(errors, InjectedError::EmptyBeam)) {
+            beams.push_back({});
+        }
+        if (!firstNotes.empty()) {
+            if (inject(errors, InjectedError::MissingTieTarget)) {
+                firstNotes.back()->tieTarget = prefix + "missing-note";
+            }
+            if (inject(errors, InjectedError::MissingSlurTarget)) {
+                firstNotes.front()->slurTarget = prefix + "missing-event";
+            }
+            if (inject(errors, InjectedError::AlterRange)) {
+                firstNotes.front()->alter = 4;
+            }
+        }
+        if (errors.has(InjectedError::TiePitchMismatch)) {
+            for (size_t x = 0; x + 1 < firstNotes.size(); x++) {
+                if (!firstNotes[x]->tieTarget.empty() && firstNotes[x]->tieTarget == firstNotes[x + 1]->noteId) {
+                    auto& target = *firstNotes[x + 1];
+                    target.step = target.step == 'B' ? 'A' : static_cast<char>(target.step + 1);
+                    m_injected[InjectedError::TiePitchMismatch]++;
+                    break;
+                }
+            }
+        }
+        // only notes that nothing refers to are given a duplicate id, so that no other error results
+        if (firstNotes.size() > 1 && firstNotes[0]->tieTarget != firstNotes[1]->noteId && inject(errors, InjectedError::DuplicateId)) {
+            firstNotes[1]->noteId = firstNotes[0]->noteId;
+        }
+
+        m_output << '{';
+        if (m == 0 && !inject(partErrors, InjectedError::MissingClef)) {
+            m_output << "\"clefs\":[{\"clef\":{\"sign\":\"G\",\"staffPosition\":-2}}],";
+        }
+        if (!beams.empty()) {
+            m_output << "\"beams\":[";
+            for (size_t x = 0; x < beams.size(); x++) {
+                m_output << (x ? "," : "") << "{\"events\":[";
+                for (size_t e = 0; e < beams[x].size(); e++) {
+                    m_output << (e ? "," : "") << '"' << beams[x][e] << '"';
+                }
+                m_output << "]}";
+            }
+            m_output << "],";
+        }
+        m_output << "\"sequences\":[";
+        for (size_t s = 0; s < sequences.size(); s++) {
+            m_output << (s ? "," : "") << "{\"voice\":\"" << sequences[s].voice << "\",\"content\":[";
+            for (size_t b = 0; b < sequences[s].beats.size(); b++) {
+                m_output << (b ? "," : "");
+                writeBeat(m_output, sequences[s].beats[b]);
+            }
+            m_output << "]}";
+        }
+        if (inject(errors, InjectedError::DuplicateVoice)) {
+            m_output << ",{\"voice\":\"" << first.voice << "\",\"content\":[";
+            writeEvent(m_output, Event{ prefix + "duplicate", "whole", true });
+            m_output << "]}";
+        }
+        m_output << "]}";
+    }
+
+    void writeLayouts()
+    {
+        m_output << ",\"layouts\":[";
+        for (size_t l = 0; l < m_options.layouts; l++) {
+            const ErrorPlan errors(m_options.errors, m_errorRandom);
+            m_output << (l ? "," : "") << "{\"id\":\"layout" << l + 1 << "\",\"content\":[";
+            for (size_t p = 0; p < m_options.parts; p++) {
+                m_output << (p ? "," : "") << "{\"type\":\"staff\",\"sources\":[{\"part\":\"" << partId(p) << "\"}]}";
+            }
+            if (inject(errors, InjectedError::LayoutPartRef)) {
+                m_output << (m_options.parts ? "," : "") << "{\"type\":\"staff\",\"sources\":[{\"part\":\"missing-part\"}]}";
+            }
+            m_output << "]}";
+        }
+        m_output << "],\"scores\":[";
+        for (size_t l = 0; l < m_options.layouts; l++) {
+            m_output << (l ? "," : "") << "{\"name\":\"Score " << l + 1 << "\",\"layout\":\"layout" << l + 1 << "\"}";
+        }
+        m_output << ']';
+    }
+
+    const CorpusOptions& m_options;
+    std::ostream& m_output;
+    Random m_random;            ///< decides the music
+    Random m_errorRandom;       ///< decides which errors are injected
+    std::map<InjectedError, size_t> m_injected;
+};
+
+} // namespace
+
+std::map<InjectedError, size_t> CorpusGenerator::writeScore(std::ostream& output, std::uint64_t index) const
+{
+    // every score gets its own seed, so any one of them can be regenerated without the others
+    Random seeds(m_seed ^ (index * 0xd1b54a32d192ed03ull));
+    return ScoreWriter(m_options, output, seeds.next()).write();
+}
+
+std::string_view CorpusGenerator::errorName(InjectedError error)
+{
+    for (const auto& info : kErrorInfo) {
+        if (info.error == error) {
+            return info.name;
+        }
+    }
+    return "unknown";
+}
+
+std::optional<InjectedError> CorpusGenerator::errorFromName(std::string_view name)
+{
+    for (const auto& info : kErrorInfo) {
+        if (info.name == name) {
+            return info.error;
+        }
+    }
+    return std::nullopt;
+}
+
+const std::vector<InjectedError>& CorpusGenerator::allErrors()
+{
+    static const std::vector<InjectedError> errors = []() {
+        std::vector<InjectedError> result;
+        for (const auto& info : kErrorInfo) {
+            result.push_back(info.error);
+        }
+        return result;
+    }();
+    return errors;
+}
+
+} // namespace mnxvalidate
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <cstdint>
+
+namespace mnxvalidate {
+
+/// @brief The categories of error that #CorpusGenerator can inject. Each one is a check listed in notes/validation_ideas.md.
+enum class InjectedError
+{
+    MeasureOverflow,        ///< a sequence contains more musical time than the time signature specifies
+    EmptyBeam,              ///< a beam contains no events
+    DuplicateBeamEvent,     ///< two beams in the same measure contain the same events
+    MissingTieTarget,       ///< a tie targets a note id that does not exist
+    TiePitchMismatch,       ///< a tie connects notes with different pitches
+    DuplicateId,            ///< two notes have the same id
+    MissingSlurTarget,      ///< a slur targets an event id that does not exist
+    TupletDuration,         ///< a tuplet's contents do not add up to its inner duration
+    AlterRange,             ///< a note's alteration is outside +/-3
+    MissingClef,            ///< a part has no beginning clef in the first measure
+    DuplicateVoice,         ///< two sequences in a part-measure have the same voice
+    LayoutPartRef           ///< a layout staff source refers to a part that does not exist
+};
+
+/// @brief What a generated score contains. Rates are probabilities between 0 and 1.
+struct CorpusOptions
+{
+    size_t parts{ 2 };
+    size_t measures{ 16 };
+    size_t voices{ 1 };         ///< sequences per part-measure
+    size_t layouts{ 1 };
+    double beamRate{ 0.5 };     ///< chance that a pair of eighth notes is beamed
+    double tupletRate{ 0.1 };   ///< chance that a beat is an eighth-note triplet
+    double tieRate{ 0.2 };      ///< chance that two adjacent quarter notes are tied
+    double slurRate{ 0.2 };     ///< chance that a sequence is slurred from its first note to its last
+    std::vector<std::pair<InjectedError, double>> errors; ///< each error and the chance of injecting it at each opportunity
+};
+
+/**
+ * @brief Writes synthetic MNX documents that are reproducible from a seed.
+ *
+ * Every score is in 4/4 and is written directly as text, so memory use does not depend on its size. Without
+ * injected errors the scores are schema-valid and semantically valid. Injected errors are decided by a separate
+ * random sequence, so turning them on or off does not change the rest of the score.
+ */
+class CorpusGenerator
+{
+public:
+    CorpusGenerator(const CorpusOptions& options, std::uint64_t seed)
+        : m_options(options), m_seed(seed) {}
+
+    /// @brief Writes the score with the given index. Returns the number of errors of each kind that were injected.
+    std::map<InjectedError, size_t> writeScore(std::ostream& output, std::uint64_t index) const;
+
+    static std::string_view errorName(InjectedError error);                 ///< the command-line name of an error
+    static std::optional<InjectedError> errorFromName(std::string_view name);
+    static const std::vector<InjectedError>& allErrors();
+
+private:
+    CorpusOptions m_options;
+    std::uint64_t m_seed{};
+};
+
+} // namespace mnxvalidate
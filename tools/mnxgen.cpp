@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <optional>
+#include <algorithm>
+
+#include "corpusgenerator.h"
+#include "compression.h"
+
+using namespace mnxvalidate;
+
+static int showUsage(const std::string& programName)
+{
+    std::cerr << "Usage: " << programName << " <output-dir|-> [--options]" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Writes synthetic MNX scores that are identical for the same seed and options." << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "  --count <n>                     Number of scores to write (default: 1)" << std::endl;
+    std::cerr << "  --seed <n>                      Random seed (default: 1)" << std::endl;
+    std::cerr << "  --parts <n>                     Parts per score (default: 2)" << std::endl;
+    std::cerr << "  --measures <n>                  Measures per score (default: 16)" << std::endl;
+    std::cerr << "  --voices <n>                    Voices per part (default: 1)" << std::endl;
+    std::cerr << "  --layouts <n>                   Layouts per score (default: 1)" << std::endl;
+    std::cerr << "  --beams <rate>                  Chance that a group of eighths is beamed (default: 0.5)" << std::endl;
+    std::cerr << "  --tuplets <rate>                Chance that a beat is a triplet (default: 0.1)" << std::endl;
+    std::cerr << "  --ties <rate>                   Chance that adjacent quarter notes are tied (default: 0.2)" << std::endl;
+    std::cerr << "  --slurs <rate>                  Chance that a sequence is slurred (default: 0.2)" << std::endl;
+    std::cerr << "  --inject <error>[:<rate>]       Inject an error at this rate per opportunity (default: 0.01). May be repeated." << std::endl;
+    std::cerr << "  --list-errors                   List the errors that can be injected" << std::endl;
+    std::cerr << "  --compress <gz|zst>             Write each score compressed, as .mnx.gz or .mnx.zst" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "An output of - writes a single uncompressed score to stdout." << std::endl;
+    return 1;
+}
+
+template <typename T>
+static T parseNumber(std::string_view option, std::string_view value)
+{
+    std::istringstream stream{ std::string(value) };
+    T result{};
+    if (!(stream >> result) || !stream.eof() || result < T(0)) {
+        throw std::invalid_argument("Invalid value for " + std::string(option) + ": " + std::string(value));
+    }
+    return result;
+}
+
+static double parseRate(std::string_view option, std::string_view value)
+{
+    const double rate = parseNumber<double>(option, value);
+    if (rate > 1.0) {
+        throw std::invalid_argument("Invalid value for " + std::string(option) + ": " + std::string(value) + " (rates are between 0 and 1)");
+    }
+    return rate;
+}
+
+int main(int argc, char* argv[])
+{
+    const std::string programName = argc > 0 ? std::filesystem::path(argv[0]).stem().string() : "mnxgen";
+    try {
+        std::optional<std::filesystem::path> outputDir;
+        bool toStdout = false;
+        size_t count = 1;
+        std::uint64_t seed = 1;
+        Compression compression = Compression::None;
+        CorpusOptions options;
+        for (int x = 1; x < argc; x++) {
+            const std::string_view arg = argv[x];
+            auto nextArg = [&]() -> std::string_view {
+                if (x + 1 >= argc) {
+                    throw std::invalid_argument(std::string(arg) + " requires a value");
+                }
+                return argv[++x];
+            };
+            if (arg == "--count") {
+                count = parseNumber<size_t>(arg, nextArg());
+            } else if (arg == "--seed") {
+                seed = parseNumber<std::uint64_t>(arg, nextArg());
+            } else if (arg == "--parts") {
+                options.parts = parseNumber<size_t>(arg, nextArg());
+            } else if (arg == "--measures") {
+                options.measures = parseNumber<size_t>(arg, nextArg());
+            } else if (arg == "--voices") {
+                options.voices = parseNumber<size_t>(arg, nextArg());
+            } else if (arg == "--layouts") {
+                options.layouts = parseNumber<size_t>(arg, nextArg());
+            } else if (arg == "--beams") {
+                options.beamRate = parseRate(arg, nextArg());
+            } else if (arg == "--tuplets") {
+                options.tupletRate = parseRate(arg, nextArg());
+            } else if (arg == "--ties") {
+                options.tieRate = parseRate(arg, nextArg());
+            } else if (arg == "--slurs") {
+                options.slurRate = parseRate(arg, nextArg());
+            } else if (arg == "--inject") {
+                const std::string_view spec = nextArg();
+                const size_t colon = spec.find(':');
+                const auto error = CorpusGenerator::errorFromName(spec.substr(0, colon));
+                if (!error) {
+                    throw std::invalid_argument("Unknown error for --inject: " + std::string(spec.substr(0, colon)) + " (see --list-errors)");
+                }
+                options.errors.emplace_back(error.value(), colon == std::string_view::npos ? 0.01 : parseRate(arg, spec.substr(colon + 1)));
+            } else if (arg == "--compress") {
+                const std::string_view format = nextArg();
+                if (format == "gz") {
+                    compression = Compression::Gzip;
+                } else if (format == "zst") {
+                    compression = Compression::Zstd;
+                } else {
+                    throw std::invalid_argument("Invalid value for --compress: " + std::string(format));
+                }
+            } else if (arg == "--list-errors") {
+                for (auto error : CorpusGenerator::allErrors()) {
+                    std::cout << CorpusGenerator::errorName(error) << std::endl;
+                }
+                return 0;
+            } else if (arg == "--help") {
+                showUsage(programName);
+                return 0;
+            } else if (arg == "-") {
+                toStdout = true;
+            } else if (arg.rfind("--", 0) == 0 || outputDir) {
+                throw std::invalid_argument("Unexpected argument: " + std::string(arg));
+            } else {
+                outputDir = std::filesystem::path(arg);
+            }
+        }
+        if (options.parts == 0 || options.measures == 0) {
+            throw std::invalid_argument("--parts and --measures must be at least 1");
+        }
+        if (toStdout == outputDir.has_value() || (toStdout && (count != 1 || compression != Compression::None))) {
+            return showUsage(programName);
+        }
+
+        const CorpusGenerator generator(options, seed);
+        if (toStdout) {
+            generator.writeScore(std::cout, 0);
+            return 0;
+        }
+        std::filesystem::create_directories(outputDir.value());
+        const size_t digits = std::max<size_t>(std::to_string(count).size(), 4);
+        for (size_t index = 0; index < count; index++) {
+            std::ostringstream fileName;
+            fileName << "score-" << std::setw(int(digits)) << std::setfill('0') << index + 1 << ".mnx" << compressionExtension(compression);
+            const auto path = outputDir.value() / fileName.str();
+            std::ofstream file;
+            file.exceptions(std::ios::failbit | std::ios::badbit);
+            file.open(path, std::ios::binary | std::ios::trunc);
+            std::map<InjectedError, size_t> injected;
+            if (compression == Compression::None) {
+                injected = generator.writeScore(file, index);
+            } else {
+                // compressed scores are generated in memory first
+                std::ostringstream score;
+                injected = generator.writeScore(score, index);
+                file << compress(score.view(), compression);
+            }
+            // one line per file, listing what was injected, so a run can be checked against its input
+            std::cout << fileName.str();
+            for (const auto& [error, errorCount] : injected) {
+                std::cout << ' ' << CorpusGenerator::errorName(error) << '=' << errorCount;
+            }
+            std::cout << '\n';
+        }
+    } catch (const std::exception& e) {
+        std::cerr << programName << ": " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,803 @@
+/*
+ * Copyright (C) 2025, Robert Patterson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+// Generates C++ that validates documents against the embedded MNX schema (see src/generatedschema.h).
+// The build runs it once the schema has been embedded. It is built for the host, like xxd.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <optional>
+#include <stdexcept>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+
+#include "nlohmann/json.hpp"
+#include "utils/schemautils.h"
+
+namespace {
+
+#include "mnx_schema.xxd"
+
+using json = nlohmann::json;
+
+using namespace utils;
+
+/// A C++ string literal. Octal escapes are used because, unlike hex escapes, they cannot run into the next character.
+std::string literal(std::string_view text)
+{
+    std::string result = "\"";
+    for (const char c : text) {
+        const auto byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            result += '\\';
+            result += c;
+        } else if (byte < 0x20 || byte >= 0x7f || c == '?') { // '?' so that no trigraph can form
+            result += '\\';
+            result += static_cast<char>('0' + (byte >> 6));
+            result += static_cast<char>('0' + ((byte >> 3) & 7));
+            result += static_cast<char>('0' + (byte & 7));
+        } else {
+            result += c;
+        }
+    }
+    return result + "\"";
+}
+
+/// A C++ double literal that reads back as the same value
+std::string literal(double value)
+{
+    char buffer[64];
+    const auto end = std::to_chars(std::begin(buffer), std::end(buffer), value).ptr;
+    std::string result(buffer, end);
+    if (result.find_first_of(".e") == std::string::npos) {
+        result += ".0";
+    }
+    return result;
+}
+
+/// One subschema, with its subschemas as indices into the compiled nodes
+struct Node
+{
+    std::string pointer;
+    std::optional<size_t> ref;                      ///< the node is only a `$ref` to this node
+    bool alwaysFalse{};                             ///< the `false` schema
+    std::uint8_t types{ TypeAny };
+    std::optional<json> enumValues;
+    std::optional<json> constValue;
+
+    std::optional<double> minimum, maximum, exclusiveMinimum, exclusiveMaximum, multipleOf;
+    std::optional<size_t> minLength, maxLength;
+    std::optional<std::string> pattern;
+
+    std::map<std::string, size_t> properties;       ///< sorted, as the generated table must be
+    std::vector<std::pair<std::string, size_t>> patternProperties;
+    std::optional<size_t> additionalProperties, propertyNames;
+    std::optional<size_t> minProperties, maxProperties;
+    std::vector<std::string> required;
+    std::vector<std::pair<std::string, std::vector<std::string>>> dependentRequired;
+    std::vector<std::pair<std::string, size_t>> dependentSchemas;
+
+    std::vector<size_t> tupleItems;                 ///< `items` as an array
+    std::optional<size_t> items;                    ///< `items` as a schema, or `additionalItems` after #tupleItems
+    std::optional<size_t> contains;
+    std::optional<size_t> minItems, maxItems;
+    bool uniqueItems{};
+
+    std::vector<size_t> allOf, anyOf, oneOf;
+    std::optional<size_t> notNode, ifNode, thenNode, elseNode;
+
+    bool hasNumberKeywords() const { return minimum || maximum || exclusiveMinimum || exclusiveMaximum || multipleOf; }
+    bool hasStringKeywords() const { return minLength || maxLength || pattern; }
+    bool hasArrayKeywords() const { return !tupleItems.empty() || items || contains || minItems || maxItems || uniqueItems; }
+    bool hasObjectKeywords() const
+    {
+        return !properties.empty() || !patternProperties.empty() || additionalProperties || propertyNames || minProperties || maxProperties
+            || !required.empty() || !dependentRequired.empty() || !dependentSchemas.empty();
+    }
+};
+
+// Compiles every subschema reachable from the root once, keyed by its json pointer so that `$ref`s share nodes.
+// It accepts the keywords the generic validator checks, and throws std::invalid_argument for what it cannot generate.
+class Compiler
+{
+public:
+    explicit Compiler(const json& root) : m_root(root) {}
+
+    std::deque<Node> nodes; // a deque, so that compiling children leaves references to their parents intact
+
+    size_t compile(const json& schema, const std::string& pointer)
+    {
+        if (const auto it = m_byPointer.find(pointer); it != m_byPointer.end()) {
+            return it->second;
+        }
+        const size_t index = nodes.size();
+        Node& node = nodes.emplace_back();
+        node.pointer = pointer;
+        m_byPointer.emplace(pointer, index); // before the children, so that cycles end here
+        if (schema.is_boolean()) {
+            node.alwaysFalse = !schema.get<bool>();
+            return index;
+        }
+        if (!schema.is_object()) {
+            throw std::invalid_argument("the subschema at " + pointer + " is not an object");
+        }
+        // Draft 7 ignores everything beside a `$ref`, and so does the generic validator
+        if (const auto ref = schema.find("$ref"); ref != schema.end()) {
+            node.ref = resolve(ref->get<std::string>());
+            return index;
+        }
+        for (const auto& [keyword, value] : schema.items()) {
+            compileKeyword(node, keyword, value, pointer);
+        }
+        if (const auto additionalItems = schema.find("additionalItems"); additionalItems != schema.end() && !node.tupleItems.empty()) {
+            node.items = compile(*additionalItems, pointer + "/additionalItems");
+        }
+        return index;
+    }
+
+    /// The node that does the checking for @p index, past any chain of `$ref`s
+    size_t target(size_t index) const
+    {
+        for (size_t hops = 0; nodes[index].ref; hops++) {
+            if (hops > nodes.size()) {
+                throw std::invalid_argument("the $ref at " + nodes[index].pointer + " never reaches a schema");
+            }
+            index = *nodes[index].ref;
+        }
+        return index;
+    }
+
+private:
+    size_t resolve(const std::string& ref)
+    {
+        if (ref.empty() || ref[0] != '#') {
+            throw std::invalid_argument("the schema refers to " + ref + ", outside the schema");
+        }
+        const json::json_pointer target(ref.substr(1));
+        if (!m_root.contains(target)) {
+            throw std::invalid_argument("the schema refers to " + ref + ", which does not exist");
+        }
+        return compile(m_root.at(target), target.to_string());
+    }
+
+    size_t child(const json& value, const std::string& pointer, const std::string& token)
+    {
+        return compile(value, pointer + "/" + escapePointerToken(token));
+    }
+
+    std::vector<size_t> children(const json& values, const std::string& pointer)
+    {
+        std::vector<size_t> result;
+        for (size_t x = 0; x < values.size(); x++) {
+            result.push_back(compile(values[x], pointer + "/" + std::to_string(x)));
+        }
+        return result;
+    }
+
+    void compileKeyword(Node& node, const std::string& keyword, const json& value, const std::string& pointer)
+    {
+        const std::string keywordPointer = pointer + "/" + escapePointerToken(keyword);
+        if (keyword == "type") {
+            node.types = 0;
+            if (value.is_array()) {
+                for (const auto& type : value) {
+                    node.types |= typeBitsFor(type.get<std::string>());
+                }
+            } else {
+                node.types = typeBitsFor(value.get<std::string>());
+            }
+        } else if (keyword == "enum") {
+            node.enumValues = value;
+        } else if (keyword == "const") {
+            node.constValue = value;
+        } else if (keyword == "minimum") {
+            node.minimum = value.get<double>();
+        } else if (keyword == "maximum") {
+            node.maximum = value.get<double>();
+        } else if (keyword == "exclusiveMinimum") {
+            node.exclusiveMinimum = value.get<double>();
+        } else if (keyword == "exclusiveMaximum") {
+            node.exclusiveMaximum = value.get<double>();
+        } else if (keyword == "multipleOf") {
+            node.multipleOf = value.get<double>();
+        } else if (keyword == "minLength") {
+            node.minLength = value.get<size_t>();
+        } else if (keyword == "maxLength") {
+            node.maxLength = value.get<size_t>();
+        } else if (keyword == "pattern") {
+            node.pattern = value.get<std::string>();
+        } else if (keyword == "properties") {
+            for (const auto& [name, subschema] : value.items()) {
+                node.properties.emplace(name, child(subschema, keywordPointer, name));
+            }
+        } else if (keyword == "patternProperties") {
+            for (const auto& [regex, subschema] : value.items()) {
+                node.patternProperties.emplace_back(regex, child(subschema, keywordPointer, regex));
+            }
+        } else if (keyword == "additionalProperties") {
+            node.additionalProperties = compile(value, keywordPointer);
+        } else if (keyword == "propertyNames") {
+            node.propertyNames = compile(value, keywordPointer);
+        } else if (keyword == "minProperties") {
+            node.minProperties = value.get<size_t>();
+        } else if (keyword == "maxProperties") {
+            node.maxProperties = value.get<size_t>();
+        } else if (keyword == "required") {
+            node.required = value.get<std::vector<std::string>>();
+        } else if (keyword == "dependencies") {
+            for (const auto& [name, dependency] : value.items()) {
+                if (dependency.is_array()) {
+                    node.dependentRequired.emplace_back(name, dependency.get<std::vector<std::string>>());
+                } else {
+                    node.dependentSchemas.emplace_back(name, child(dependency, keywordPointer, name));
+                }
+            }
+        } else if (keyword == "items") {
+            if (value.is_array()) {
+                node.tupleItems = children(value, keywordPointer);
+            } else {
+                node.items = compile(value, keywordPointer);
+            }
+        } else if (keyword == "contains") {
+            node.contains = compile(value, keywordPointer);
+        } else if (keyword == "minItems") {
+            node.minItems = value.get<size_t>();
+        } else if (keyword == "maxItems") {
+            node.maxItems = value.get<size_t>();
+        } else if (keyword == "uniqueItems") {
+            node.uniqueItems = value.get<bool>();
+        } else if (keyword == "allOf") {
+            node.allOf = children(value, keywordPointer);
+        } else if (keyword == "anyOf") {
+            node.anyOf = children(value, keywordPointer);
+        } else if (keyword == "oneOf") {
+            node.oneOf = children(value, keywordPointer);
+        } else if (keyword == "not") {
+            node.notNode = compile(value, keywordPointer);
+        } else if (keyword == "if") {
+            node.ifNode = compile(value, keywordPointer);
+        } else if (keyword == "then") {
+            node.thenNode = compile(value, keywordPointer);
+        } else if (keyword == "else") {
+            node.elseNode = compile(value, keywordPointer);
+        } else if (keyword == "format" || keyword == "contentEncoding" || keyword == "contentMediaType") {
+            throw std::invalid_argument("the schema uses " + keyword + ", which is checked by callbacks the generator does not have");
+        } else if (keyword == "$id" && pointer != "") {
+            throw std::invalid_argument("the schema has a nested $id, so its $refs may not be local");
+        }
+        // Anything else is an annotation, a container of definitions, or a keyword draft 7 does not have,
+        // none of which the generic validator checks either. (`additionalItems` is compiled with its tuple.)
+    }
+
+    const json& m_root;
+    std::unordered_map<std::string, size_t> m_byPointer;
+};
+
+// Writes one function per node. Each function returns whether the instance is valid. When `reports` is false
+// (inside combinators) it returns at the first failure without recording anything.
+class Emitter
+{
+public:
+    Emitter(const Compiler& compiler, std::ostream& output) : m_compiler(compiler), m_nodes(compiler.nodes), m_output(output) {}
+
+    void emit()
+    {
+        for (size_t x = 0; x < m_nodes.size(); x++) {
+            if (!m_nodes[x].ref) {
+                // an `if` without `then` or `else`, for one, is compiled but never checked
+                m_output << "[[maybe_unused]] bool " << name(x) << "(const json& instance, Context& context, bool reports);\n";
+            }
+        }
+        for (size_t x = 0; x < m_nodes.size(); x++) {
+            if (!m_nodes[x].ref) {
+                m_output << '\n';
+                emitNode(x);
+            }
+        }
+    }
+
+    std::string name(size_t index) const { return "schema" + std::to_string(m_compiler.target(index)); }
+
+private:
+    // The body of each function keeps `valid` up to date. These fail it, returning at once when nothing is reported.
+    void fail(const std::string& indent, const std::string& message)
+    {
+        m_out << indent << "if (!reports) return false;\n";
+        m_out << indent << "valid = context.error(" << literal(message) << ");\n";
+    }
+
+    void check(const std::string& indent, const std::string& call)
+    {
+        m_out << indent << "if (!" << call << ") {\n";
+        m_out << indent << "    if (!reports) return false;\n";
+        m_out << indent << "    valid = false;\n";
+        m_out << indent << "}\n";
+    }
+
+    // Checks a member at the pointer of its key or index, reporting its own errors
+    void checkMember(const std::string& indent, const std::string& token, size_t index, const std::string& value)
+    {
+        m_out << indent << "context.push(" << token << ");\n";
+        if (m_nodes[m_compiler.target(index)].alwaysFalse) {
+            fail(indent, "instance invalid as per false-schema"); // the common `additionalProperties: false`
+        } else {
+            check(indent, name(index) + "(" + value + ", context, reports)");
+        }
+        m_out << indent << "context.pop();\n";
+    }
+
+    std::string matches(size_t index, const std::string& value = "instance")
+    {
+        return "context.matches(" + name(index) + ", " + value + ")";
+    }
+
+    void emitNode(size_t index)
+    {
+        const Node& node = m_nodes[index];
+        m_output << "// #" << node.pointer << '\n';
+        m_out.str({});
+        emitBody(node);
+        const std::string body = m_out.str();
+        if (body.empty()) {
+            m_output << "bool " << name(index) << "(const json&, Context&, bool)\n{\n    return true;\n}\n";
+            return;
+        }
+        m_output << "bool " << name(index) << "(const json&" << (node.alwaysFalse ? "" : " instance") << ", Context& context, bool reports)\n{\n";
+        m_output << "    bool valid = true;\n" << body << "    return valid;\n}\n";
+    }
+
+    void emitBody(const Node& node)
+    {
+        if (node.alwaysFalse) {
+            fail("    ", "instance invalid as per false-schema");
+            return;
+        }
+        emitTypeSwitch(node);
+        emitValues(node);
+        for (const size_t sub : node.allOf) {
+            check("    ", name(sub) + "(instance, context, reports)");
+        }
+        if (!node.anyOf.empty()) {
+            m_out << "    if (!(";
+            for (size_t x = 0; x < node.anyOf.size(); x++) {
+                m_out << (x ? "\n          || " : "") << matches(node.anyOf[x]);
+            }
+            m_out << ")) {\n";
+            fail("        ", "no subschema has succeeded, but one of them is required to validate");
+            m_out << "    }\n";
+        }
+        if (!node.oneOf.empty()) {
+            m_out << "    {\n";
+            m_out << "        int matchCount = 0;\n";
+            for (const size_t sub : node.oneOf) {
+                m_out << "        if (matchCount < 2 && " << matches(sub) << ") matchCount++;\n";
+            }
+            m_out << "        if (matchCount == 0) {\n";
+            fail("            ", "no subschema has succeeded, but one of them is required to validate");
+            m_out << "        } else if (matchCount > 1) {\n";
+            fail("            ", "more than one subschema has succeeded, but exactly one of them is required to validate");
+            m_out << "        }\n";
+            m_out << "    }\n";
+        }
+        if (node.notNode) {
+            m_out << "    if (" << matches(*node.notNode) << ") {\n";
+            fail("        ", "the subschema has succeeded, but it is required to not validate");
+            m_out << "    }\n";
+        }
+        if (node.ifNode && (node.thenNode || node.elseNode)) {
+            m_out << "    if (" << matches(*node.ifNode) << ") {\n";
+            if (node.thenNode) {
+                check("        ", name(*node.thenNode) + "(instance, context, reports)");
+            }
+            m_out << "    }";
+            if (node.elseNode) {
+                m_out << " else {\n";
+                check("        ", name(*node.elseNode) + "(instance, context, reports)");
+                m_out << "    }";
+            }
+            m_out << '\n';
+        }
+    }
+
+    void emitTypeSwitch(const Node& node)
+    {
+        const bool allowsNumbers = node.types & TypeInteger;
+        const bool allowsFloats = node.types & TypeNumber;
+        const bool numbers = allowsNumbers && node.hasNumberKeywords();
+        const bool strings = (node.types & TypeString) && node.hasStringKeywords();
+        const bool arrays = (node.types & TypeArray) && node.hasArrayKeywords();
+        const bool objects = (node.types & TypeObject) && node.hasObjectKeywords();
+        if (node.types == TypeAny && !numbers && !strings && !arrays && !objects) {
+            return;
+        }
+        m_out << "    switch (instance.type()) {\n";
+        if (node.types & TypeNull) {
+            m_out << "    case json::value_t::null:\n        break;\n";
+        }
+        if (node.types & TypeBoolean) {
+            m_out << "    case json::value_t::boolean:\n        break;\n";
+        }
+        if (allowsNumbers) {
+            m_out << "    case json::value_t::number_float:\n";
+            if (!allowsFloats) {
+                m_out << "        if (!isIntegral(instance)) {\n";
+                fail("            ", "unexpected instance type");
+                m_out << "            break;\n";
+                m_out << "        }\n";
+            }
+            m_out << "        [[fallthrough]];\n";
+            m_out << "    case json::value_t::number_integer:\n";
+            m_out << "    case json::value_t::number_unsigned:\n";
+            if (numbers) {
+                m_out << "    {\n";
+                emitNumberKeywords(node);
+                m_out << "        break;\n    }\n";
+            } else {
+                m_out << "        break;\n";
+            }
+        }
+        if (node.types & TypeString) {
+            m_out << "    case json::value_t::string:\n";
+            if (strings) {
+                m_out << "    {\n";
+                emitStringKeywords(node);
+                m_out << "        break;\n    }\n";
+            } else {
+                m_out << "        break;\n";
+            }
+        }
+        if (node.types & TypeArray) {
+            m_out << "    case json::value_t::array:\n";
+            if (arrays) {
+                m_out << "    {\n";
+                emitArrayKeywords(node);
+                m_out << "        break;\n    }\n";
+            } else {
+                m_out << "        break;\n";
+            }
+        }
+        if (node.types & TypeObject) {
+            m_out << "    case json::value_t::object:\n";
+            if (objects) {
+                m_out << "    {\n";
+                emitObjectKeywords(node);
+                m_out << "        break;\n    }\n";
+            } else {
+                m_out << "        break;\n";
+            }
+        }
+        m_out << "    default:\n";
+        if (node.types != TypeAny) {
+            fail("        ", "unexpected instance type");
+        }
+        m_out << "        break;\n";
+        m_out << "    }\n";
+    }
+
+    void emitNumberKeywords(const Node& node)
+    {
+        m_out << "        const double number = instance.get<double>();\n";
+        auto bound = [&](const std::optional<double>& limit, const char* comparison, const std::string& message) {
+            if (limit) {
+                m_out << "        if (number " << comparison << ' ' << literal(*limit) << ") {\n";
+                fail("            ", message + formatNumber(*limit));
+                m_out << "        }\n";
+            }
+        };
+        bound(node.minimum, "<", "instance is below minimum of ");
+        bound(node.exclusiveMinimum, "<=", "instance is below or equals minimum of ");
+        bound(node.maximum, ">", "instance exceeds maximum of ");
+        bound(node.exclusiveMaximum, ">=", "instance exceeds or equals maximum of ");
+        if (node.multipleOf) {
+            m_out << "        if (!isMultipleOf(number, " << literal(*node.multipleOf) << ")) {\n";
+            fail("            ", "instance is not a multiple of " + formatNumber(*node.multipleOf));
+            m_out << "        }\n";
+        }
+    }
+
+    void emitStringKeywords(const Node& node)
+    {
+        m_out << "        const std::string& text = instance.get_ref<const std::string&>();\n";
+        if (node.minLength || node.maxLength) {
+            m_out << "        const size_t length = utf8Length(text);\n";
+            if (node.minLength) {
+                m_out << "        if (length < " << *node.minLength << ") {\n";
+                fail("            ", "instance is too short as per minLength:" + std::to_string(*node.minLength));
+                m_out << "        }\n";
+            }
+            if (node.maxLength) {
+                m_out << "        if (length > " << *node.maxLength << ") {\n";
+                fail("            ", "instance is too long as per maxLength: " + std::to_string(*node.maxLength));
+                m_out << "        }\n";
+            }
+        }
+        if (node.pattern) {
+            m_out << "        static const std::regex pattern(" << literal(*node.pattern) << ", std::regex::ECMAScript | std::regex::optimize);\n";
+            m_out << "        if (!std::regex_search(text, pattern)) {\n";
+            fail("            ", "instance does not match regex pattern: " + *node.pattern);
+            m_out << "        }\n";
+        }
+    }
+
+    void emitArrayKeywords(const Node& node)
+    {
+        if (node.minItems) {
+            m_out << "        if (instance.size() < " << *node.minItems << ") {\n";
+            fail("            ", "array has too few items");
+            m_out << "        }\n";
+        }
+        if (node.maxItems) {
+            m_out << "        if (instance.size() > " << *node.maxItems << ") {\n";
+            fail("            ", "array has too many items");
+            m_out << "        }\n";
+        }
+        if (node.uniqueItems) {
+            m_out << "        for (auto it = instance.begin(); it != instance.end(); ++it) {\n";
+            m_out << "            if (std::find(std::next(it), instance.end(), *it) != instance.end()) {\n";
+            fail("                ", "items have to be unique for this array");
+            m_out << "                break;\n";
+            m_out << "            }\n";
+            m_out << "        }\n";
+        }
+        if (!node.tupleItems.empty()) {
+            m_out << "        static constexpr std::array<SchemaFunction, " << node.tupleItems.size() << "> tuple = {\n";
+            for (const size_t item : node.tupleItems) {
+                m_out << "            " << name(item) << ",\n";
+            }
+            m_out << "        };\n";
+        }
+        if (!node.tupleItems.empty() || node.items) {
+            m_out << "        for (size_t x = 0; x < instance.size(); x++) {\n";
+            if (!node.tupleItems.empty()) {
+                m_out << "            if (x < tuple.size()) {\n";
+                m_out << "                context.push(x);\n";
+                check("                ", "tuple[x](instance[x], context, reports)");
+                m_out << "                context.pop();\n";
+                m_out << "                continue;\n";
+                m_out << "            }\n";
+            }
+            if (node.items) {
+                checkMember("            ", "x", *node.items, "instance[x]");
+            } else {
+                m_out << "            break;\n";
+            }
+            m_out << "        }\n";
+        }
+        if (node.contains) {
+            m_out << "        if (std::none_of(instance.begin(), instance.end(), [&](const json& item) { return "
+                  << matches(*node.contains, "item") << "; })) {\n";
+            fail("            ", "array does not contain required element as per 'contains'");
+            m_out << "        }\n";
+        }
+    }
+
+    void emitObjectKeywords(const Node& node)
+    {
+        if (node.minProperties) {
+            m_out << "        if (instance.size() < " << *node.minProperties << ") {\n";
+            fail("            ", "too few properties");
+            m_out << "        }\n";
+        }
+        if (node.maxProperties) {
+            m_out << "        if (instance.size() > " << *node.maxProperties << ") {\n";
+            fail("            ", "too many properties");
+            m_out << "        }\n";
+        }
+        for (const auto& name : node.required) {
+            m_out << "        if (!instance.contains(" << literal(name) << ")) {\n";
+            fail("            ", "required property '" + name + "' not found in object");
+            m_out << "        }\n";
+        }
+        for (const auto& [name, requiredNames] : node.dependentRequired) {
+            m_out << "        if (instance.contains(" << literal(name) << ")) {\n";
+            for (const auto& requiredName : requiredNames) {
+                m_out << "            if (!instance.contains(" << literal(requiredName) << ")) {\n";
+                fail("                ", "required property '" + requiredName + "' not found in object as a dependency of '" + name + "'");
+                m_out << "            }\n";
+            }
+            m_out << "        }\n";
+        }
+        for (const auto& [name, sub] : node.dependentSchemas) {
+            m_out << "        if (instance.contains(" << literal(name) << ")) {\n";
+            m_out << "            context.push(" << literal(name) << ");\n";
+            check("            ", this->name(sub) + "(instance, context, reports)");
+            m_out << "            context.pop();\n";
+            m_out << "        }\n";
+        }
+        if (node.properties.empty() && node.patternProperties.empty() && !node.additionalProperties && !node.propertyNames) {
+            return;
+        }
+        if (!node.properties.empty()) {
+            m_out << "        static constexpr std::array<Property, " << node.properties.size() << "> properties = {{\n";
+            for (const auto& [name, sub] : node.properties) {
+                m_out << "            { " << literal(name) << ", " << this->name(sub) << " },\n";
+            }
+            m_out << "        }};\n";
+        }
+        for (size_t x = 0; x < node.patternProperties.size(); x++) {
+            m_out << "        static const std::regex pattern" << x << '(' << literal(node.patternProperties[x].first)
+                  << ", std::regex::ECMAScript | std::regex::optimize);\n";
+        }
+        m_out << "        for (const auto& [key, value] : instance.items()) {\n";
+        if (node.propertyNames) {
+            check("            ", name(*node.propertyNames) + "(json(key), context, reports)");
+        }
+        const bool tracksMatches = node.additionalProperties.has_value();
+        if (tracksMatches) {
+            m_out << "            bool matched = false;\n";
+        }
+        if (!node.properties.empty()) {
+            m_out << "            if (const SchemaFunction property = findProperty(properties, key)) {\n";
+            m_out << "                context.push(key);\n";
+            check("                ", "property(value, context, reports)");
+            m_out << "                context.pop();\n";
+            if (tracksMatches) {
+                m_out << "                matched = true;\n";
+            }
+            m_out << "            }\n";
+        }
+        for (size_t x = 0; x < node.patternProperties.size(); x++) {
+            m_out << "            if (std::regex_search(key, pattern" << x << ")) {\n";
+            checkMember("                ", "key", node.patternProperties[x].second, "value");
+            if (tracksMatches) {
+                m_out << "                matched = true;\n";
+            }
+            m_out << "            }\n";
+        }
+        if (node.additionalProperties) {
+            m_out << "            if (!matched) {\n";
+            checkMember("                ", "key", *node.additionalProperties, "value");
+            m_out << "            }\n";
+        }
+        m_out << "        }\n";
+    }
+
+    // enum and const are compared with json equality, as the generic validator does. Strings, the usual case,
+    // are found in a sorted table instead.
+    void emitValues(const Node& node)
+    {
+        if (node.enumValues) {
+            const json& values = *node.enumValues;
+            const bool allStrings = values.is_array() && !values.empty()
+                && std::all_of(values.begin(), values.end(), [](const json& value) { return value.is_string(); });
+            if (allStrings) {
+                auto names = values.get<std::vector<std::string>>();
+                std::sort(names.begin(), names.end());
+                m_out << "    static constexpr std::array<std::string_view, " << names.size() << "> enumValues = {\n";
+                for (const auto& value : names) {
+                    m_out << "        " << literal(value) << ",\n";
+                }
+                m_out << "    };\n";
+                m_out << "    if (!instance.is_string() || !containsString(enumValues, instance.get_ref<const std::string&>())) {\n";
+            } else {
+                m_out << "    static const json enumValues = json::parse(" << literal(values.dump()) << ");\n";
+                m_out << "    if (std::find(enumValues.begin(), enumValues.end(), instance) == enumValues.end()) {\n";
+            }
+            fail("        ", "instance not found in required enum");
+            m_out << "    }\n";
+        }
+        if (node.constValue) {
+            if (node.constValue->is_string()) {
+                m_out << "    if (!instance.is_string() || instance.get_ref<const std::string&>() != " << literal(node.constValue->get<std::string>()) << ") {\n";
+            } else {
+                m_out << "    static const json constValue = json::parse(" << literal(node.constValue->dump()) << ");\n";
+                m_out << "    if (instance != constValue) {\n";
+            }
+            fail("        ", "instance not const");
+            m_out << "    }\n";
+        }
+    }
+
+    const Compiler& m_compiler;
+    const std::deque<Node>& m_nodes;
+    std::ostream& m_output;
+    std::ostringstream m_out;   ///< the body of the function being written
+};
+
+constexpr char kPrologue[] = R"(#include <string>
+#include <string_view>
+#include <array>
+#include <algorithm>
+#include <regex>
+#include <stdexcept>
+
+#include "generatedschema.h"
+
+namespace mnxvalidate::generated {
+
+using json = nlohmann::json;
+)";
+
+std::string generate(const std::string& schemaText, const std::string& source)
+{
+    std::ostringstream output;
+    output << "// Generated by mnxschemagen from " << source << ". Do not edit.\n\n" << kPrologue;
+    try {
+        const json schema = json::parse(schemaText);
+        Compiler compiler(schema);
+        const size_t root = compiler.compile(schema, "");
+        std::ostringstream functions;
+        Emitter emitter(compiler, functions);
+        emitter.emit();
+        output << "\nnamespace {\n\n" << functions.str() << "\n} // namespace\n\n";
+        output << "bool isAvailable() { return true; }\n\n";
+        output << "std::string_view unavailableReason() { return {}; }\n\n";
+        output << "bool validateDocument(const json& document, Context& context)\n{\n";
+        output << "    return " << emitter.name(root) << "(document, context, true);\n}\n";
+    } catch (const std::exception& e) {
+        // The generic validator still checks the schema, so one the generator cannot handle only costs speed.
+        std::cout << "mnxschemagen: not generating a validator, because " << e.what() << std::endl;
+        output << "\nbool isAvailable() { return false; }\n\n";
+        output << "std::string_view unavailableReason() { return " << literal(e.what()) << "; }\n\n";
+        output << "bool validateDocument(const json&, Context&)\n{\n";
+        output << "    throw std::logic_error(\"No validator was generated for the embedded schema.\");\n}\n";
+    }
+    output << "\n} // namespace mnxvalidate::generated\n";
+    return output.str();
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: " << argv[0] << " <output-file> [schema-file]" << std::endl;
+        std::cerr << "Without a schema file, the MNX schema embedded in the build is used." << std::endl;
+        return 1;
+    }
+    try {
+        std::string schemaText(reinterpret_cast<const char*>(mnx_schema_json), mnx_schema_json_len);
+        std::string source = "the embedded MNX schema";
+        if (argc == 3) {
+            std::ifstream schemaFile(argv[2], std::ios::binary);
+            if (!schemaFile) {
+                throw std::runtime_error(std::string("unable to read ") + argv[2]);
+            }
+            schemaText.assign(std::istreambuf_iterator<char>(schemaFile), std::istreambuf_iterator<char>());
+            source = argv[2];
+        }
+        const std::string generated = generate(schemaText, source);
+        // leave an unchanged file alone, so that it is not compiled again
+        std::ifstream existing(argv[1], std::ios::binary);
+        if (existing && std::string(std::istreambuf_iterator<char>(existing), std::istreambuf_iterator<char>()) == generated) {
+            return 0;
+        }
+        existing.close();
+        std::ofstream output(argv[1], std::ios::binary | std::ios::trunc);
+        output << generated;
+        if (!output) {
+            throw std::runtime_error(std::string("unable to write ") + argv[1]);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << argv[0] << ": " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}